@@ -0,0 +1,439 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Recorded in the JSON output so that results can be compared across releases.
+#ifndef BENCHMARK_VERSION
+#define BENCHMARK_VERSION "unknown"
+#endif
+#ifdef __VERSION__
+#define BENCHMARK_COMPILER __VERSION__
+#else
+#define BENCHMARK_COMPILER "unknown"
+#endif
+
+namespace Benchmark {
+
+	template<class T>
+	inline void DoNotOptimize(const T& value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	inline void ClobberMemory() {
+		asm volatile("" : : : "memory");
+	}
+
+	class State{
+	public:
+		State(std::size_t iterations, std::size_t threads):iterations(iterations), remaining(iterations), threads(threads) {}
+
+		// while(state.KeepRunning()) { ... } times the body for the requested iterations.
+		bool KeepRunning() {
+			if(!this->started){
+				this->started = true;
+				this->start = Clock::now();
+			}
+			if(this->remaining > 0){
+				--this->remaining;
+				return true;
+			}
+			this->PauseTiming();
+			return false;
+		}
+
+		void PauseTiming() {
+			this->elapsed += std::chrono::duration<double, std::nano>(Clock::now() - this->start).count();
+		}
+
+		void ResumeTiming() {
+			this->start = Clock::now();
+		}
+
+		void SetItemsProcessed(double itemsPerIteration) { this->itemsPerIteration = itemsPerIteration; }
+		void SetBytesProcessed(double bytesPerIteration) { this->bytesPerIteration = bytesPerIteration; }
+		void Counter(const std::string& name, double value) { this->counters[name] = value; }
+
+		std::size_t Iterations() const { return this->iterations; }
+		std::size_t Threads() const { return this->threads; }
+		double ElapsedNanoseconds() const { return this->elapsed; }
+		double ItemsPerIteration() const { return this->itemsPerIteration; }
+		double BytesPerIteration() const { return this->bytesPerIteration; }
+		const std::map<std::string, double>& Counters() const { return this->counters; }
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		std::size_t iterations;
+		std::size_t remaining;
+		std::size_t threads;
+		bool started{false};
+		Clock::time_point start;
+		double elapsed{0};
+		double itemsPerIteration{0};
+		double bytesPerIteration{0};
+		std::map<std::string, double> counters;
+	};
+
+	struct Result{
+		std::string name;
+		std::size_t iterations;
+		std::vector<double> samples;
+		double median;
+		double medianAbsoluteDeviation;
+		double itemsPerSecond;
+		double bytesPerSecond;
+		std::map<std::string, double> counters;
+	};
+
+	inline double Median(std::vector<double> values) {
+		if(values.empty())
+			return 0;
+		std::sort(values.begin(), values.end());
+		std::size_t middle = values.size()/2;
+		return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle])/2;
+	}
+
+	inline double MedianAbsoluteDeviation(const std::vector<double>& values, double median) {
+		std::vector<double> deviations;
+		for(auto value : values)
+			deviations.push_back(std::fabs(value - median));
+		return Median(deviations);
+	}
+
+	// Provisional baselines were not measured on the machine that compares against them:
+	// they are reported but never count as regressions.
+	struct Baseline{
+		double median;
+		double medianAbsoluteDeviation;
+		bool provisional;
+	};
+
+	// Reads the medians and MADs of a file written by --json. "provisional": true in the
+	// context applies to every benchmark, in a benchmark to that one only. Throws
+	// std::runtime_error on input that is not such a file.
+	inline std::map<std::string, Baseline> ReadBaselines(std::istream& in) {
+		std::stringstream buffer;
+		buffer << in.rdbuf();
+		std::string text = buffer.str();
+		auto flag = [&text](const std::string& key, std::size_t from, std::size_t to){
+			std::size_t at = text.find("\"" + key + "\": true", from);
+			return at < to;
+		};
+		auto number = [&text](const std::string& key, std::size_t from, std::size_t to, const std::string& name){
+			std::size_t at = text.find("\"" + key + "\": ", from);
+			if(at >= to)
+				throw(std::runtime_error("Benchmark: no " + key + " for " + name));
+			const char* begin = text.c_str() + at + key.size() + 4;
+			char* end;
+			double value = std::strtod(begin, &end);
+			if(end == begin)
+				throw(std::runtime_error("Benchmark: invalid " + key + " for " + name));
+			return value;
+		};
+		std::size_t list = text.find("\"benchmarks\": [");
+		if(list == std::string::npos)
+			throw(std::runtime_error("Benchmark: no benchmarks in baseline"));
+		bool provisional = flag("provisional", 0, list);
+		std::map<std::string, Baseline> baselines;
+		const std::string name = "{\"name\": \"";
+		for(std::size_t at = text.find(name, list) ; at != std::string::npos ; ){
+			std::size_t begin = at + name.size();
+			std::size_t next = text.find(name, begin);
+			std::size_t end = std::min(next, text.size());
+			std::size_t close = text.find('"', begin);
+			if(close >= end)
+				throw(std::runtime_error("Benchmark: unterminated benchmark name"));
+			std::string key = text.substr(begin, close - begin);
+			Baseline& baseline = baselines[key];
+			baseline.median = number("median_ns", begin, end, key);
+			baseline.medianAbsoluteDeviation = number("mad_ns", begin, end, key);
+			baseline.provisional = provisional || flag("provisional", begin, end);
+			at = next;
+		}
+		return baselines;
+	}
+
+	// Measurement settings, from the context of a file written by --json.
+	struct Settings{
+		std::size_t repetitions;
+		double minTime;
+		std::size_t threads;
+	};
+
+	inline Settings ReadSettings(std::istream& in) {
+		std::stringstream buffer;
+		buffer << in.rdbuf();
+		std::string text = buffer.str();
+		std::size_t context = text.find("\"context\": {");
+		if(context == std::string::npos)
+			throw(std::runtime_error("Benchmark: no context in baseline"));
+		std::size_t end = text.find('}', context);
+		auto number = [&text, context, end](const std::string& key){
+			std::size_t at = text.find("\"" + key + "\": ", context);
+			if(at >= end)
+				throw(std::runtime_error("Benchmark: no " + key + " in baseline context"));
+			const char* begin = text.c_str() + at + key.size() + 4;
+			char* last;
+			double value = std::strtod(begin, &last);
+			if(last == begin)
+				throw(std::runtime_error("Benchmark: invalid " + key + " in baseline context"));
+			return value;
+		};
+		Settings settings;
+		settings.repetitions = static_cast<std::size_t>(number("repetitions"));
+		settings.minTime = number("min_time");
+		settings.threads = static_cast<std::size_t>(number("threads"));
+		return settings;
+	}
+
+	// A benchmark regresses when its median grows by more than the relative tolerance and
+	// more than three standard deviations of the difference, estimated from both MADs.
+	// Prints one row per benchmark and returns the number of regressions.
+	inline std::size_t Compare(std::ostream& out, const std::vector<Result>& results, const std::map<std::string, Baseline>& baselines, double tolerance) {
+		std::size_t regressions = 0;
+		out << "\n" << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16) << "Baseline (ns)" << std::setw(16) << "Median (ns)"
+		<< std::setw(10) << "Change %" << std::setw(12) << "Allowed %" << "  Status" << std::endl;
+		for(const auto& result : results){
+			out << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(1);
+			auto found = baselines.find(result.name);
+			if(found == baselines.end()){
+				out << std::setw(16) << "-" << std::setw(16) << result.median << std::setw(10) << "-" << std::setw(12) << "-" << "  new" << std::endl;
+				continue;
+			}
+			const Baseline& baseline = found->second;
+			double sigma = 1.4826*std::sqrt(baseline.medianAbsoluteDeviation*baseline.medianAbsoluteDeviation
+											+ result.medianAbsoluteDeviation*result.medianAbsoluteDeviation);
+			double allowed = std::max(tolerance*baseline.median, 3*sigma);
+			double change = result.median - baseline.median;
+			const char* status = "ok";
+			if(change > allowed){
+				status = baseline.provisional ? "slower (provisional)" : "SLOWER";
+				regressions += baseline.provisional ? 0 : 1;
+			}
+			else if(-change > allowed)
+				status = "faster";
+			out << std::setw(16) << baseline.median << std::setw(16) << result.median
+			<< std::setw(10) << std::setprecision(2) << (baseline.median > 0 ? 100*change/baseline.median : 0)
+			<< std::setw(12) << (baseline.median > 0 ? 100*allowed/baseline.median : 0) << "  " << status << std::endl;
+		}
+		out << regressions << " regression" << (regressions == 1 ? "" : "s") << " against the baseline" << std::endl;
+		return regressions;
+	}
+
+	class Registry{
+	public:
+		typedef std::function<void(State&)> Function;
+
+		static Registry& Instance() {
+			static Registry registry;
+			return registry;
+		}
+
+		void Register(const std::string& name, const Function& function) {
+			this->benchmarks.push_back(std::make_pair(name, function));
+		}
+
+		int Run(int argc, char* argv[]) {
+			std::string filter, json, baseline;
+			// Unset until given, or taken from the baseline, or defaulted.
+			std::size_t repetitions = 0;
+			double tolerance = 0.05;
+			double minTime = -1;
+			std::size_t threads = 0;
+			bool list = false;
+			for(int i = 1 ; i < argc ; ++i){
+				std::string argument(argv[i]);
+				if(Option(argument, "--filter=", filter) || Option(argument, "--json=", json) || Option(argument, "--baseline=", baseline))
+					continue;
+				std::string value;
+				if(Option(argument, "--repetitions=", value))
+					repetitions = std::max(std::strtoul(value.c_str(), nullptr, 10), 1ul);
+				else if(Option(argument, "--min-time=", value))
+					minTime = std::max(std::strtod(value.c_str(), nullptr), 0.);
+				else if(Option(argument, "--threads=", value))
+					threads = std::max(std::strtoul(value.c_str(), nullptr, 10), 1ul);
+				else if(Option(argument, "--tolerance=", value))
+					tolerance = std::strtod(value.c_str(), nullptr);
+				else if(argument == "--list")
+					list = true;
+				else{
+					std::cerr << "Unknown option " << argument << "\n"
+					<< "Options: --filter=<text> --repetitions=<n> --min-time=<seconds> --threads=<n> --json=<file> --list"
+					<< " --baseline=<json file> --tolerance=<fraction>" << std::endl;
+					return 1;
+				}
+			}
+
+			// A baseline only compares with runs measured the same way: its settings become
+			// the defaults and different explicit ones are refused.
+			std::map<std::string, Baseline> baselines;
+			if(!baseline.empty()){
+				std::ifstream in(baseline.c_str());
+				if(!in){
+					std::cerr << "Cannot read " << baseline << std::endl;
+					return 1;
+				}
+				std::stringstream text;
+				text << in.rdbuf();
+				Settings recorded;
+				try{
+					std::istringstream settings(text.str()), benchmarks(text.str());
+					recorded = ReadSettings(settings);
+					baselines = ReadBaselines(benchmarks);
+				}
+				catch(const std::runtime_error& error){
+					std::cerr << baseline << ": " << error.what() << std::endl;
+					return 1;
+				}
+				if((repetitions != 0 && repetitions != recorded.repetitions) || (minTime >= 0 && minTime != recorded.minTime)
+				   || (threads != 0 && threads != recorded.threads)){
+					std::cerr << baseline << " was recorded with --repetitions=" << recorded.repetitions << " --min-time=" << recorded.minTime
+					<< " --threads=" << recorded.threads << ", compare with the same settings" << std::endl;
+					return 1;
+				}
+				repetitions = recorded.repetitions;
+				minTime = recorded.minTime;
+				threads = recorded.threads;
+			}
+			if(repetitions == 0)
+				repetitions = 5;
+			if(minTime < 0)
+				minTime = 0.2;
+			if(threads == 0)
+				threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+			std::vector<Result> results;
+			std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(12) << "Iterations"
+			<< std::setw(16) << "Median (ns)" << std::setw(10) << "MAD %" << std::setw(16) << "Items/s" << std::setw(14) << "MB/s" << std::endl;
+			for(const auto& benchmark : this->benchmarks){
+				if(!filter.empty() && benchmark.first.find(filter) == std::string::npos)
+					continue;
+				if(list){
+					std::cout << benchmark.first << std::endl;
+					continue;
+				}
+				results.push_back(Measure(benchmark.first, benchmark.second, repetitions, minTime, threads));
+				Print(results.back());
+			}
+
+			if(!json.empty()){
+				std::ofstream out(json.c_str());
+				if(!out){
+					std::cerr << "Cannot write " << json << std::endl;
+					return 1;
+				}
+				WriteJson(out, results, repetitions, minTime, threads);
+			}
+			// Exits with 2 on regressions, so that scripts can tell them from usage errors.
+			if(!baseline.empty() && !list && Compare(std::cout, results, baselines, tolerance) > 0)
+				return 2;
+			return 0;
+		}
+
+	private:
+		static bool Option(const std::string& argument, const std::string& option, std::string& value) {
+			if(argument.compare(0, option.size(), option) != 0)
+				return false;
+			value = argument.substr(option.size());
+			return true;
+		}
+
+		static Result Measure(const std::string& name, const Function& function, std::size_t repetitions, double minTime, std::size_t threads) {
+			// Grow the iteration count until one run lasts at least minTime.
+			std::size_t iterations = 1;
+			while(true){
+				State state(iterations, threads);
+				function(state);
+				double elapsed = state.ElapsedNanoseconds();
+				if(elapsed >= minTime*1e9 || iterations >= 1000000000)
+					break;
+				double factor = elapsed > 0 ? 1.4*minTime*1e9/elapsed : 10;
+				iterations = static_cast<std::size_t>(iterations*std::min(std::max(factor, 2.), 10.));
+			}
+
+			Result result;
+			result.name = name;
+			result.iterations = iterations;
+			double itemsPerIteration = 0, bytesPerIteration = 0;
+			for(std::size_t repetition = 0 ; repetition < repetitions ; ++repetition){
+				State state(iterations, threads);
+				function(state);
+				result.samples.push_back(state.ElapsedNanoseconds()/iterations);
+				itemsPerIteration = state.ItemsPerIteration();
+				bytesPerIteration = state.BytesPerIteration();
+				result.counters = state.Counters();
+			}
+			result.median = Median(result.samples);
+			result.medianAbsoluteDeviation = MedianAbsoluteDeviation(result.samples, result.median);
+			result.itemsPerSecond = result.median > 0 ? itemsPerIteration*1e9/result.median : 0;
+			result.bytesPerSecond = result.median > 0 ? bytesPerIteration*1e9/result.median : 0;
+			return result;
+		}
+
+		static void Print(const Result& result) {
+			std::cout << std::left << std::setw(48) << result.name << std::right << std::setw(12) << result.iterations
+			<< std::setw(16) << std::fixed << std::setprecision(1) << result.median
+			<< std::setw(10) << std::setprecision(2) << (result.median > 0 ? 100*result.medianAbsoluteDeviation/result.median : 0)
+			<< std::setw(16) << std::scientific << std::setprecision(3) << result.itemsPerSecond
+			<< std::setw(14) << std::fixed << std::setprecision(1) << result.bytesPerSecond/1e6;
+			for(const auto& counter : result.counters)
+				std::cout << "  " << counter.first << "=" << counter.second;
+			std::cout << std::endl;
+		}
+
+		static void WriteJson(std::ostream& out, const std::vector<Result>& results, std::size_t repetitions, double minTime, std::size_t threads) {
+			char date[32];
+			std::time_t now = std::time(nullptr);
+			std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+			out << std::setprecision(17);
+			out << "{\n  \"context\": {\"date\": \"" << date << "\", \"version\": \"" << BENCHMARK_VERSION
+			<< "\", \"compiler\": \"" << BENCHMARK_COMPILER << "\", \"repetitions\": " << repetitions
+			<< ", \"min_time\": " << minTime << ", \"threads\": " << threads << "},\n  \"benchmarks\": [";
+			for(std::size_t i = 0 ; i < results.size() ; ++i){
+				const Result& result = results[i];
+				out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+				<< ", \"median_ns\": " << result.median << ", \"mad_ns\": " << result.medianAbsoluteDeviation
+				<< ", \"items_per_second\": " << result.itemsPerSecond << ", \"bytes_per_second\": " << result.bytesPerSecond
+				<< ", \"samples_ns\": [";
+				for(std::size_t s = 0 ; s < result.samples.size() ; ++s)
+					out << (s == 0 ? "" : ", ") << result.samples[s];
+				out << "], \"counters\": {";
+				bool first = true;
+				for(const auto& counter : result.counters){
+					out << (first ? "" : ", ") << "\"" << counter.first << "\": " << counter.second;
+					first = false;
+				}
+				out << "}}";
+			}
+			out << "\n  ]\n}\n";
+		}
+
+		std::vector<std::pair<std::string, Function>> benchmarks;
+	};
+
+	struct Registrar{
+		Registrar(const std::string& name, const Registry::Function& function) {
+			Registry::Instance().Register(name, function);
+		}
+	};
+
+}
+
+#define BENCHMARK(group, name) \
+	static void group##_##name##_Benchmark(Benchmark::State& state); \
+	static Benchmark::Registrar group##_##name##_Registrar(#group "." #name, group##_##name##_Benchmark); \
+	static void group##_##name##_Benchmark(Benchmark::State& state)
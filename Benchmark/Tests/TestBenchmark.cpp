@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <Benchmark.h>
+
+BENCHMARK(BenchmarkTest, Spin) {
+	std::size_t sum = 0;
+	while(state.KeepRunning())
+		Benchmark::DoNotOptimize(sum += state.Iterations());
+}
+
+class BenchmarkTest : public ::testing::Test {
+public:
+	std::string path;
+protected:
+	virtual void SetUp() {
+		path = "BenchmarkTest.json";
+	}
+	virtual void TearDown() {
+		std::remove(path.c_str());
+	}
+	
+	static Benchmark::Result Measured(const std::string& name, double median, double medianAbsoluteDeviation) {
+		Benchmark::Result result;
+		result.name = name;
+		result.iterations = 1;
+		result.median = median;
+		result.medianAbsoluteDeviation = medianAbsoluteDeviation;
+		result.itemsPerSecond = 0;
+		result.bytesPerSecond = 0;
+		return result;
+	}
+	
+	static std::string Entry(const std::string& name, double median, double medianAbsoluteDeviation, const std::string& extra = "") {
+		std::ostringstream entry;
+		entry << "{\"name\": \"" << name << "\", \"iterations\": 10, \"median_ns\": " << median << ", \"mad_ns\": " << medianAbsoluteDeviation
+		<< extra << ", \"samples_ns\": [], \"counters\": {}}";
+		return entry.str();
+	}
+	
+	static std::map<std::string, Benchmark::Baseline> Read(const std::string& context, const std::string& entries) {
+		std::istringstream in("{\n  \"context\": {" + context + "},\n  \"benchmarks\": [\n    " + entries + "\n  ]\n}\n");
+		return Benchmark::ReadBaselines(in);
+	}
+	
+	static bool Rejected(const std::string& text) {
+		try{
+			std::istringstream in(text);
+			Benchmark::ReadBaselines(in);
+		}
+		catch(const std::runtime_error&){
+			return true;
+		}
+		return false;
+	}
+	
+	// Runs BenchmarkTest.Spin against a baseline of the given entries, once and as short as possible
+	// unless the context says otherwise.
+	int Run(const std::string& entries, const std::string& context = "\"repetitions\": 1, \"min_time\": 0, \"threads\": 1",
+			const std::string& option = "--filter=BenchmarkTest.Spin") {
+		std::ofstream(path.c_str()) << "{\n  \"context\": {" << context << "},\n  \"benchmarks\": [" << entries << "]\n}\n";
+		std::string arguments[] = {"Bench", "--filter=BenchmarkTest.Spin", option, "--baseline=" + path};
+		char* argv[4];
+		for(int i = 0 ; i < 4 ; ++i)
+			argv[i] = &arguments[i][0];
+		return Benchmark::Registry::Instance().Run(4, argv);
+	}
+};
+
+TEST_F(BenchmarkTest,ReadBaselines) {
+	auto baselines = Read("\"threads\": 1", Entry("A.First", 100, 2) + ",\n    " + Entry("A.Second", 2.5e6, 1e3));
+	ASSERT_EQ(2u, baselines.size());
+	EXPECT_EQ(100, baselines["A.First"].median);
+	EXPECT_EQ(2, baselines["A.First"].medianAbsoluteDeviation);
+	EXPECT_EQ(2.5e6, baselines["A.Second"].median);
+	EXPECT_FALSE(baselines["A.Second"].provisional);
+}
+
+TEST_F(BenchmarkTest,Provisional) {
+	auto baselines = Read("\"provisional\": true", Entry("A.First", 100, 0));
+	EXPECT_TRUE(baselines["A.First"].provisional);
+	baselines = Read("\"threads\": 1", Entry("A.First", 100, 0) + ",\n    " + Entry("A.Second", 100, 0, ", \"provisional\": true"));
+	EXPECT_FALSE(baselines["A.First"].provisional);
+	EXPECT_TRUE(baselines["A.Second"].provisional);
+	
+	// Slower than a provisional baseline is reported, not counted.
+	std::ostringstream out;
+	EXPECT_EQ(0u, Benchmark::Compare(out, {Measured("A.Second", 200, 0)}, baselines, 0.05));
+	EXPECT_NE(std::string::npos, out.str().find("slower (provisional)"));
+}
+
+TEST_F(BenchmarkTest,WithinTolerance) {
+	auto baselines = Read("", Entry("A.First", 100, 0) + ",\n    " + Entry("A.Second", 100, 10));
+	std::ostringstream out;
+	// 4% is below the 5% tolerance, 20% is below three deviations of the MADs.
+	EXPECT_EQ(0u, Benchmark::Compare(out, {Measured("A.First", 104, 0), Measured("A.Second", 120, 10)}, baselines, 0.05));
+	EXPECT_NE(std::string::npos, out.str().find("0 regressions"));
+	EXPECT_EQ(std::string::npos, out.str().find("SLOWER"));
+}
+
+TEST_F(BenchmarkTest,Regression) {
+	auto baselines = Read("", Entry("A.First", 100, 0) + ",\n    " + Entry("A.Second", 100, 0));
+	std::ostringstream out;
+	EXPECT_EQ(1u, Benchmark::Compare(out, {Measured("A.First", 106, 0), Measured("A.Second", 50, 0)}, baselines, 0.05));
+	EXPECT_NE(std::string::npos, out.str().find("SLOWER"));
+	EXPECT_NE(std::string::npos, out.str().find("faster"));
+	
+	// A run slower than its baseline exits with 2, one within it with 0.
+	EXPECT_EQ(2, Run(Entry("BenchmarkTest.Spin", 1e-6, 0)));
+	EXPECT_EQ(0, Run(Entry("BenchmarkTest.Spin", 1e9, 0)));
+}
+
+TEST_F(BenchmarkTest,NewBenchmark) {
+	auto baselines = Read("", Entry("A.First", 100, 0));
+	std::ostringstream out;
+	EXPECT_EQ(0u, Benchmark::Compare(out, {Measured("A.Other", 1e9, 0)}, baselines, 0.05));
+	EXPECT_NE(std::string::npos, out.str().find("new"));
+	EXPECT_EQ(0, Run(""));
+}
+
+TEST_F(BenchmarkTest,Malformed) {
+	EXPECT_TRUE(Rejected(""));
+	EXPECT_TRUE(Rejected("not json at all"));
+	EXPECT_TRUE(Rejected("{\"benchmarks\": [{\"name\": \"A.First\", \"mad_ns\": 1}]}"));
+	EXPECT_TRUE(Rejected("{\"benchmarks\": [{\"name\": \"A.First\", \"median_ns\": fast, \"mad_ns\": 1}]}"));
+	EXPECT_TRUE(Rejected("{\"benchmarks\": [{\"name\": \"A.First"));
+	EXPECT_FALSE(Rejected("{\"benchmarks\": []}"));
+	EXPECT_EQ(1, Run("{\"name\": \"BenchmarkTest.Spin\"}"));
+	EXPECT_EQ(1, Run(Entry("BenchmarkTest.Spin", 1e9, 0), "\"repetitions\": 1, \"threads\": 1"));
+}
+
+TEST_F(BenchmarkTest,Settings) {
+	std::istringstream in("{\n  \"context\": {\"date\": \"2026-10-19T12:00:00\", \"repetitions\": 5, \"min_time\": 1, \"threads\": 1},\n  \"benchmarks\": []\n}\n");
+	Benchmark::Settings settings = Benchmark::ReadSettings(in);
+	EXPECT_EQ(5u, settings.repetitions);
+	EXPECT_EQ(1, settings.minTime);
+	EXPECT_EQ(1u, settings.threads);
+	
+	// The baseline settings are used by default, different ones are refused.
+	std::string entries = Entry("BenchmarkTest.Spin", 1e9, 0);
+	EXPECT_EQ(0, Run(entries, "\"repetitions\": 1, \"min_time\": 0, \"threads\": 1", "--threads=1"));
+	EXPECT_EQ(1, Run(entries, "\"repetitions\": 1, \"min_time\": 0, \"threads\": 1", "--threads=2"));
+	EXPECT_EQ(1, Run(entries, "\"repetitions\": 1, \"min_time\": 0, \"threads\": 1", "--min-time=0.2"));
+	EXPECT_EQ(1, Run(entries, "\"repetitions\": 3, \"min_time\": 0, \"threads\": 1", "--repetitions=1"));
+}
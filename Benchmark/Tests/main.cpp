@@ -0,0 +1,9 @@
+#include <gtest/gtest.h>
+
+using namespace std;
+
+int main(int argc, char *argv[]){
+	::testing::InitGoogleTest(&argc,argv);
+	return RUN_ALL_TESTS();
+	return 0;
+}
@@ -0,0 +1,224 @@
+#include <Benchmark.h>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <Solid.h>
+#include <Sphere.h>
+#include <VerletList.h>
+#include <ContactForceEngine.h>
+#include <ContactColoring.h>
+#include <ThreadPool.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+namespace {
+
+	const double radius = 0.01;
+	const double dt = 1e-6;
+
+	// Random spheres in a periodic box, about six contacts per sphere.
+	struct Packing{
+		std::vector<Solid> solids;
+		std::vector<ContactPair> pairs;
+		PeriodicBox<double> domain;
+
+		Packing(std::size_t count) {
+			double length = cbrt(count*4./3.*M_PI*8*radius*radius*radius/6.);
+			domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(length, length, length));
+			std::mt19937 generator(1);
+			std::uniform_real_distribution<double> position(0, length);
+			std::uniform_real_distribution<double> velocity(-0.1, 0.1);
+			for(std::size_t i = 0 ; i < count ; ++i){
+				std::unique_ptr<Shape> shape(new Sphere(radius, 2500));
+				solids.emplace_back(std::move(shape));
+				solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(position(generator), position(generator), position(generator)), Quaternion<double>()));
+				solids.back().Velocity(Vector<double>(velocity(generator), velocity(generator), velocity(generator)));
+			}
+			VerletList list(0);
+			list.Domain(domain);
+			list.Build(solids);
+			for(std::uint32_t i = 0 ; i < list.SolidCount() ; ++i)
+				for(const std::uint32_t* j = list.Begin(i) ; j != list.End(i) ; ++j)
+					pairs.push_back(ContactPair{i, *j});
+		}
+	};
+
+	Packing& SharedPacking() {
+		static Packing packing(50000);
+		return packing;
+	}
+
+	ThreadPool& SharedPool(std::size_t threads) {
+		static std::unique_ptr<ThreadPool> pool;
+		if(!pool || pool->Size() != threads)
+			pool.reset(new ThreadPool(threads));
+		return *pool;
+	}
+
+	std::unique_ptr<ContactForceEngine> MakeEngine(const Packing& packing) {
+		std::unique_ptr<ContactForceModel> model(new HertzMindlinModel(1e7, 0.3, 0.8, 0.5));
+		std::unique_ptr<ContactForceEngine> engine(new ContactForceEngine(std::move(model), packing.pairs.size()));
+		engine->Domain(packing.domain);
+		return engine;
+	}
+
+	void ResetForces(std::vector<Solid>& solids) {
+		for(auto& solid : solids)
+			solid.ResetForceAndMomemtum();
+	}
+
+	void AtomicAdd(std::atomic<double>& target, double value) {
+		double current = target.load(std::memory_order_relaxed);
+		while(!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed));
+	}
+
+	void Accumulate(double* target, const ContactForces& forces, int sign) {
+		target[0] += sign*forces.force.ComponantX();
+		target[1] += sign*forces.force.ComponantY();
+		target[2] += sign*forces.force.ComponantZ();
+	}
+
+	void Store(Solid& solid, const double* accumulated) {
+		solid.AddForce(Vector<double>(accumulated[0], accumulated[1], accumulated[2]));
+		solid.AddMomentum(Vector<double>(accumulated[3], accumulated[4], accumulated[5]));
+	}
+
+}
+
+BENCHMARK(ContactAccumulation, Sequential) {
+	Packing& packing = SharedPacking();
+	auto engine = MakeEngine(packing);
+	while(state.KeepRunning()){
+		ResetForces(packing.solids);
+		engine->Apply(packing.solids, packing.pairs, dt);
+	}
+	state.SetItemsProcessed(packing.pairs.size());
+	state.Counter("contacts", engine->ActiveContacts());
+}
+
+BENCHMARK(ContactAccumulation, Colored) {
+	Packing& packing = SharedPacking();
+	ThreadPool& pool = SharedPool(state.Threads());
+	auto engine = MakeEngine(packing);
+	ContactColoring coloring;
+	coloring.Color(packing.pairs, packing.solids.size());
+	while(state.KeepRunning()){
+		ResetForces(packing.solids);
+		engine->Apply(packing.solids, coloring, pool, dt);
+	}
+	state.SetItemsProcessed(packing.pairs.size());
+	state.Counter("colors", coloring.ColorCount());
+}
+
+BENCHMARK(ContactAccumulation, Atomics) {
+	Packing& packing = SharedPacking();
+	ThreadPool& pool = SharedPool(state.Threads());
+	auto engine = MakeEngine(packing);
+	std::size_t count = packing.solids.size();
+	std::unique_ptr<std::atomic<double>[]> accumulated(new std::atomic<double>[6*count]);
+	for(std::size_t k = 0 ; k < 6*count ; ++k)
+		accumulated[k].store(0);
+
+	while(state.KeepRunning()){
+		ResetForces(packing.solids);
+		engine->Prepare(packing.solids, packing.pairs);
+		pool.ParallelFor(packing.pairs.size(), [&](std::size_t begin, std::size_t end, std::size_t){
+			ContactForces forces;
+			for(std::size_t p = begin ; p < end ; ++p){
+				const ContactPair& pair = packing.pairs[p];
+				if(!engine->Evaluate(packing.solids[pair.first], packing.solids[pair.second], pair.first, pair.second, dt, forces))
+					continue;
+				std::atomic<double>* first = &accumulated[6*pair.first];
+				std::atomic<double>* second = &accumulated[6*pair.second];
+				AtomicAdd(first[0], forces.force.ComponantX());
+				AtomicAdd(first[1], forces.force.ComponantY());
+				AtomicAdd(first[2], forces.force.ComponantZ());
+				AtomicAdd(second[0], -forces.force.ComponantX());
+				AtomicAdd(second[1], -forces.force.ComponantY());
+				AtomicAdd(second[2], -forces.force.ComponantZ());
+				AtomicAdd(first[3], forces.firstMomentum.ComponantX());
+				AtomicAdd(first[4], forces.firstMomentum.ComponantY());
+				AtomicAdd(first[5], forces.firstMomentum.ComponantZ());
+				AtomicAdd(second[3], forces.secondMomentum.ComponantX());
+				AtomicAdd(second[4], forces.secondMomentum.ComponantY());
+				AtomicAdd(second[5], forces.secondMomentum.ComponantZ());
+			}
+		});
+		pool.ParallelFor(count, [&](std::size_t begin, std::size_t end, std::size_t){
+			double values[6];
+			for(std::size_t i = begin ; i < end ; ++i){
+				for(int k = 0 ; k < 6 ; ++k)
+					values[k] = accumulated[6*i + k].exchange(0, std::memory_order_relaxed);
+				Store(packing.solids[i], values);
+			}
+		});
+		engine->EndStep();
+	}
+	state.SetItemsProcessed(packing.pairs.size());
+}
+
+BENCHMARK(ContactAccumulation, PerThreadBuffers) {
+	Packing& packing = SharedPacking();
+	ThreadPool& pool = SharedPool(state.Threads());
+	auto engine = MakeEngine(packing);
+	std::size_t count = packing.solids.size();
+	std::vector<std::vector<double>> buffers(pool.Size(), std::vector<double>(6*count, 0));
+
+	while(state.KeepRunning()){
+		ResetForces(packing.solids);
+		engine->Prepare(packing.solids, packing.pairs);
+		pool.ParallelFor(packing.pairs.size(), [&](std::size_t begin, std::size_t end, std::size_t thread){
+			ContactForces forces;
+			double* buffer = buffers[thread].data();
+			for(std::size_t p = begin ; p < end ; ++p){
+				const ContactPair& pair = packing.pairs[p];
+				if(!engine->Evaluate(packing.solids[pair.first], packing.solids[pair.second], pair.first, pair.second, dt, forces))
+					continue;
+				Accumulate(&buffer[6*pair.first], forces, 1);
+				Accumulate(&buffer[6*pair.second], forces, -1);
+				buffer[6*pair.first + 3] += forces.firstMomentum.ComponantX();
+				buffer[6*pair.first + 4] += forces.firstMomentum.ComponantY();
+				buffer[6*pair.first + 5] += forces.firstMomentum.ComponantZ();
+				buffer[6*pair.second + 3] += forces.secondMomentum.ComponantX();
+				buffer[6*pair.second + 4] += forces.secondMomentum.ComponantY();
+				buffer[6*pair.second + 5] += forces.secondMomentum.ComponantZ();
+			}
+		});
+		pool.ParallelFor(count, [&](std::size_t begin, std::size_t end, std::size_t){
+			double values[6];
+			for(std::size_t i = begin ; i < end ; ++i){
+				for(int k = 0 ; k < 6 ; ++k){
+					values[k] = 0;
+					for(auto& buffer : buffers){
+						values[k] += buffer[6*i + k];
+						buffer[6*i + k] = 0;
+					}
+				}
+				Store(packing.solids[i], values);
+			}
+		});
+		engine->EndStep();
+	}
+	state.SetItemsProcessed(packing.pairs.size());
+}
+
+BENCHMARK(ContactColoring, Greedy) {
+	Packing& packing = SharedPacking();
+	ContactColoring coloring;
+	while(state.KeepRunning())
+		coloring.Color(packing.pairs, packing.solids.size());
+	state.SetItemsProcessed(packing.pairs.size());
+	state.Counter("colors", coloring.ColorCount());
+}
+
+BENCHMARK(ContactColoring, JonesPlassmann) {
+	Packing& packing = SharedPacking();
+	ThreadPool& pool = SharedPool(state.Threads());
+	ContactColoring coloring;
+	while(state.KeepRunning())
+		coloring.ColorParallel(packing.pairs, packing.solids.size(), pool);
+	state.SetItemsProcessed(packing.pairs.size());
+	state.Counter("colors", coloring.ColorCount());
+	state.Counter("rounds", coloring.Rounds());
+}
@@ -0,0 +1,53 @@
+#include <Benchmark.h>
+#include <memory>
+#include <random>
+#include <Simulation.h>
+#include <Profiler.h>
+#include <Sphere.h>
+#include "../Tests/AllocationTracker.h"
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+namespace {
+
+	// Spheres at a volume fraction of 0.3 in a periodic cube.
+	std::unique_ptr<Simulation> Spheres(std::size_t count) {
+		const double radius = 0.005;
+		double side = cbrt(count*4./3.*M_PI*radius*radius*radius/0.3);
+		SimulationOptions options;
+		options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(side, side, side));
+		std::mt19937 generator(1);
+		std::uniform_real_distribution<double> position(0, side);
+		std::uniform_real_distribution<double> velocity(-0.1, 0.1);
+		std::vector<Solid> solids;
+		for(std::size_t i = 0 ; i < count ; ++i){
+			solids.emplace_back(std::unique_ptr<Shape>(new Sphere(radius, 2500)));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(position(generator), position(generator), position(generator)), Quaternion<double>()));
+			solids.back().Velocity(Vector<double>(velocity(generator), velocity(generator), velocity(generator)));
+		}
+		return std::unique_ptr<Simulation>(new Simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options));
+	}
+
+}
+
+BENCHMARK(Simulation, Step) {
+	const std::size_t count = 10000;
+	std::unique_ptr<Simulation> simulation = Spheres(count);
+	simulation->Run(5);
+	AllocationCounts before = AllocationTracker::Counts();
+	while(state.KeepRunning())
+		simulation->Step();
+	state.SetItemsProcessed(count);
+	AllocationCounts allocated = AllocationTracker::Counts() - before;
+	state.Counter("allocations_per_step", double(allocated.Allocations())/state.Iterations());
+	state.Counter("allocated_bytes_per_step", double(allocated.Bytes())/state.Iterations());
+}
+
+// Cost of one timed phase, to be set against the steps above.
+BENCHMARK(Profiler, ScopedPhase) {
+	while(state.KeepRunning()){
+		ScopedPhase phase(Phase::Output);
+	}
+	state.SetItemsProcessed(1);
+}
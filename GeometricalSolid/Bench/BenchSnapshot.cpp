@@ -0,0 +1,156 @@
+#include <Benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <Solid.h>
+#include <Sphere.h>
+#include <SnapshotWriter.h>
+#include <SnapshotReader.h>
+#include <SceneLoader.h>
+#include <LuGaRecordStream.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+namespace {
+
+	const std::size_t solidCount = 100000;
+	const char* path = "BenchSnapshot.snap";
+
+	std::vector<Solid>& SharedSolids() {
+		static std::vector<Solid> solids;
+		if(solids.empty()){
+			std::mt19937 generator(2);
+			std::uniform_real_distribution<double> value(-1, 1);
+			for(std::size_t i = 0 ; i < solidCount ; ++i){
+				std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+				solids.emplace_back(std::move(shape));
+				Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+				q.Normalize();
+				solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(value(generator), value(generator), value(generator)), q));
+				solids.back().Velocity(Vector<double>(value(generator), value(generator), value(generator)));
+				solids.back().AngularVelocity(Vector<double>(value(generator), value(generator), value(generator)));
+			}
+		}
+		return solids;
+	}
+
+}
+
+BENCHMARK(Snapshot, TextWrite) {
+	std::vector<Solid>& solids = SharedSolids();
+	std::size_t bytes = 0;
+	while(state.KeepRunning()){
+		std::stringstream out;
+		out.precision(17);
+		for(const auto& solid : solids)
+			out << solid << "\n";
+		bytes = out.str().size();
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(Snapshot, TextRead) {
+	std::vector<Solid>& solids = SharedSolids();
+	std::stringstream text;
+	text.precision(17);
+	for(const auto& solid : solids)
+		text << solid << "\n";
+	std::string content = text.str();
+	std::vector<Solid> loaded;
+	while(state.KeepRunning()){
+		std::stringstream in(content);
+		loaded.clear();
+		for(std::size_t i = 0 ; i < solids.size() ; ++i){
+			loaded.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+			in >> loaded.back();
+		}
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(content.size());
+}
+
+BENCHMARK(Snapshot, TextLoadParallel) {
+	std::vector<Solid>& solids = SharedSolids();
+	const char* textPath = "BenchSnapshot.txt";
+	std::size_t bytes = 0;
+	{
+		std::ofstream out(textPath);
+		for(const auto& solid : solids)
+			out << solid << "\n";
+		bytes = out.tellp();
+	}
+	ThreadPool pool(state.Threads());
+	std::vector<Solid> loaded;
+	for(std::size_t i = 0 ; i < solids.size() ; ++i)
+		loaded.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+	while(state.KeepRunning()){
+		SceneLoader loader(textPath);
+		loader.Load(loaded, pool);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(bytes);
+	std::remove(textPath);
+}
+
+BENCHMARK(Snapshot, TextStream) {
+	std::vector<Solid>& solids = SharedSolids();
+	const char* textPath = "BenchSnapshot.txt";
+	std::size_t bytes = 0;
+	{
+		std::ofstream out(textPath);
+		for(const auto& solid : solids)
+			out << solid << "\n";
+		bytes = out.tellp();
+	}
+	double sum = 0;
+	while(state.KeepRunning())
+		for(auto& solid : LuGaSolidStream(textPath))
+			sum += solid.Velocity().ComponantX();
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(bytes);
+	std::remove(textPath);
+}
+
+BENCHMARK(Snapshot, BinaryWrite) {
+	std::vector<Solid>& solids = SharedSolids();
+	SnapshotWriter writer;
+	while(state.KeepRunning())
+		writer.Write(path, solids);
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(solids.size()*(4 + 1 + 19*8));
+	std::remove(path);
+}
+
+BENCHMARK(Snapshot, BinaryLoad) {
+	std::vector<Solid>& solids = SharedSolids();
+	SnapshotWriter().Write(path, solids);
+	std::vector<Solid> loaded;
+	while(state.KeepRunning()){
+		SnapshotReader reader(path);
+		reader.Load(loaded);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(solids.size()*(4 + 1 + 19*8));
+	std::remove(path);
+}
+
+BENCHMARK(Snapshot, BinaryMap) {
+	std::vector<Solid>& solids = SharedSolids();
+	SnapshotWriter().Write(path, solids);
+	while(state.KeepRunning()){
+		SnapshotReader reader(path);
+		double sum = 0;
+		const double* origins = reader.Origins();
+		for(std::size_t i = 0 ; i < 3*reader.SolidCount() ; ++i)
+			sum += origins[i];
+		Benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(solids.size());
+	std::remove(path);
+}
@@ -0,0 +1,204 @@
+#include <Benchmark.h>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <Solid.h>
+#include <Sphere.h>
+#include <SolidFormatter.h>
+#include <TrajectoryWriter.h>
+#include <CompressedFrameCodec.h>
+#include <TrajectoryStoreWriter.h>
+#include <TrajectoryStoreReader.h>
+#include <VtkWriter.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+namespace {
+
+	std::vector<Solid>& SharedSolids() {
+		static std::vector<Solid> solids;
+		if(solids.empty()){
+			for(std::size_t i = 0 ; i < 20000 ; ++i){
+				std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+				solids.emplace_back(std::move(shape));
+				solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(1e-3*i, 2e-3*i, -1e-3*i), Quaternion<double>()));
+				solids.back().Velocity(Vector<double>(0.5, 0, 0));
+			}
+		}
+		return solids;
+	}
+
+}
+
+// Time the stepping thread spends on one output frame.
+BENCHMARK(Trajectory, SynchronousFormatter) {
+	std::vector<Solid>& solids = SharedSolids();
+	LuGaSolidFormatter formatter;
+	std::ostringstream out;
+	while(state.KeepRunning()){
+		out.str("");
+		for(const auto& solid : solids)
+			out << formatter.Format(solid) << "\n";
+	}
+	state.SetItemsProcessed(solids.size());
+}
+
+// What the stepping thread pays with TrajectoryWriter, the rest runs in the background.
+BENCHMARK(Trajectory, FrameCapture) {
+	std::vector<Solid>& solids = SharedSolids();
+	TrajectoryFrame frame;
+	std::uint64_t step = 0;
+	while(state.KeepRunning())
+		frame.Capture(solids, step++, 0);
+	state.SetItemsProcessed(solids.size());
+}
+
+BENCHMARK(Trajectory, LuGaEncoder) {
+	std::vector<Solid>& solids = SharedSolids();
+	TrajectoryFrame frame;
+	frame.Capture(solids, 0, 0);
+	LuGaFrameEncoder encoder;
+	std::string bytes;
+	while(state.KeepRunning()){
+		bytes.clear();
+		encoder.Encode(frame, bytes);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(bytes.size());
+}
+
+BENCHMARK(Trajectory, CompressedEncoder) {
+	std::vector<Solid>& solids = SharedSolids();
+	CompressedFrameOptions options;
+	options.domain = PeriodicBox<double>(Point<double>(0, -40, -20), Point<double>(20, 0, 0));
+	options.velocityTolerance = 1e-6;
+	CompressedFrameEncoder encoder(options);
+	// Frames of solids drifting with random velocities.
+	std::mt19937 generator(4);
+	std::uniform_real_distribution<double> velocity(-1, 1);
+	std::vector<double> velocities(3*solids.size());
+	for(auto& v : velocities)
+		v = velocity(generator);
+	std::vector<TrajectoryFrame> frames(8);
+	for(std::size_t k = 0 ; k < frames.size() ; ++k){
+		frames[k].Capture(solids, k, 0);
+		for(std::size_t i = 0 ; i < velocities.size() ; ++i){
+			frames[k].origins[i] += 1e-4*k*velocities[i];
+			frames[k].velocities[i] = velocities[i];
+		}
+	}
+	std::string bytes;
+	std::size_t frame = 0;
+	while(state.KeepRunning()){
+		bytes.clear();
+		encoder.Encode(frames[frame++ % frames.size()], bytes);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(19*sizeof(double)*solids.size());
+	state.Counter("bytes_per_solid", double(bytes.size())/solids.size());
+}
+
+BENCHMARK(Trajectory, StoreAppend) {
+	std::vector<Solid>& solids = SharedSolids();
+	TrajectoryFrame frame;
+	frame.Capture(solids, 0, 0);
+	const char* path = "BenchTrajectory.traj";
+	{
+		TrajectoryStoreWriter writer(path, solids.size());
+		while(state.KeepRunning())
+			writer.Append(frame);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(solids.size()*19*sizeof(double));
+	std::remove(path);
+}
+
+// Time series of one solid over 256 frames, against reading the frames whole.
+BENCHMARK(Trajectory, StoreSeries) {
+	std::vector<Solid>& solids = SharedSolids();
+	const char* path = "BenchTrajectory.traj";
+	const std::size_t frameCount = 256;
+	{
+		TrajectoryStoreWriter writer(path, solids.size());
+		for(std::size_t f = 0 ; f < frameCount ; ++f)
+			writer.Append(solids, f, f);
+	}
+	TrajectoryStoreReader reader(path);
+	std::vector<double> series(3*frameCount);
+	std::size_t solid = 0;
+	while(state.KeepRunning()){
+		reader.Series(TrajectoryStore::Origin, solid, 0, frameCount, series.data());
+		solid = (solid + 7919) % solids.size();
+	}
+	Benchmark::DoNotOptimize(series.data());
+	state.SetItemsProcessed(frameCount);
+	std::remove(path);
+}
+
+BENCHMARK(Trajectory, StoreFrame) {
+	std::vector<Solid>& solids = SharedSolids();
+	const char* path = "BenchTrajectory.traj";
+	{
+		TrajectoryStoreWriter writer(path, solids.size());
+		for(std::size_t f = 0 ; f < 64 ; ++f)
+			writer.Append(solids, f, f);
+	}
+	TrajectoryStoreReader reader(path);
+	TrajectoryFrame frame;
+	std::size_t index = 0;
+	while(state.KeepRunning()){
+		reader.Read(index, frame);
+		index = (index + 13) % reader.FrameCount();
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(solids.size()*19*sizeof(double));
+	std::remove(path);
+}
+
+// Against the LuGa text above, which the Python converter reads back to write VTK.
+BENCHMARK(Trajectory, VtkXml) {
+	std::vector<Solid>& solids = SharedSolids();
+	VtkWriter writer;
+	std::ostringstream out;
+	while(state.KeepRunning()){
+		out.str("");
+		writer.Write(out, solids);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(out.str().size());
+}
+
+BENCHMARK(Trajectory, VtkLegacy) {
+	std::vector<Solid>& solids = SharedSolids();
+	VtkWriterOptions options;
+	options.format = VtkWriterOptions::Format::Legacy;
+	VtkWriter writer(options);
+	std::ostringstream out;
+	while(state.KeepRunning()){
+		out.str("");
+		writer.Write(out, solids);
+	}
+	state.SetItemsProcessed(solids.size());
+	state.SetBytesProcessed(out.str().size());
+}
+
+// Stepping thread cost of a frame with the files written on 2 threads.
+BENCHMARK(Trajectory, VtkSeries) {
+	std::vector<Solid>& solids = SharedSolids();
+	const std::string prefix = "BenchTrajectoryVtk";
+	std::uint64_t step = 0;
+	{
+		VtkSeriesWriter writer(prefix);
+		while(state.KeepRunning())
+			writer.Capture(solids, step++, 0);
+	}
+	state.SetItemsProcessed(solids.size());
+	char name[32];
+	for(std::uint64_t s = 0 ; s < step ; ++s){
+		std::snprintf(name, sizeof(name), "_%08llu.vtp", static_cast<unsigned long long>(s));
+		std::remove((prefix + name).c_str());
+	}
+	std::remove((prefix + ".pvd").c_str());
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "ContactForceEngine.h"
+#include "../Parallel/ThreadPool.h"
+
+namespace GeometricalSolid {
+	
+	// Partitions the contact pairs into batches in which no two pairs share a solid,
+	// so that the forces of a batch can be applied in parallel without atomics.
+	class ContactColoring{
+	public:
+		ContactColoring() {}
+		~ContactColoring() {}
+		
+		// Greedy: each pair takes the smallest color free on both of its solids.
+		void Color(const std::vector<ContactPair>& pairs, std::size_t solidCount);
+		void Color(const VerletList& neighbors);
+		
+		// Jones-Plassmann: pairs holding the highest priority among their uncolored
+		// neighbors are colored together, round after round.
+		void ColorParallel(const std::vector<ContactPair>& pairs, std::size_t solidCount, ThreadPool& pool);
+		
+		std::size_t ColorCount() const { return this->batchStart.empty() ? 0 : this->batchStart.size() - 1; }
+		std::size_t BatchBegin(std::size_t color) const { return this->batchStart[color]; }
+		std::size_t BatchEnd(std::size_t color) const { return this->batchStart[color + 1]; }
+		std::size_t Rounds() const { return this->rounds; }
+		std::size_t MemoryFootprint() const;
+		
+		// Pairs sorted by color.
+		const std::vector<ContactPair>& Pairs() const { return this->coloredPairs; }
+		
+	private:
+		void Sort(const std::vector<ContactPair>& pairs);
+		
+		std::vector<ContactPair> candidates;
+		std::vector<std::uint32_t> colors;
+		std::vector<std::uint64_t> usedColors;
+		std::vector<std::size_t> batchStart;
+		std::vector<ContactPair> coloredPairs;
+		
+		std::vector<std::uint32_t> solidStart;
+		std::vector<std::uint32_t> solidPairs;
+		std::vector<std::uint8_t> selected;
+		std::vector<std::uint32_t> pending;
+		std::size_t rounds{0};
+	};
+	
+}
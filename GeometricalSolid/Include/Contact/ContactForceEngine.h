@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../Parallel/ThreadPool.h"
+#include <Vector.h>
+
+#include "../Solid.h"
+#include "ContactForceModel.h"
+#include "ContactHistory.h"
+#include "../Neighbor/VerletList.h"
+
+namespace GeometricalSolid {
+	
+	struct ContactPair{
+		std::uint32_t first;
+		std::uint32_t second;
+	};
+	
+	struct ContactGeometry{
+		GeometricalSpaceObjects::Vector<double> normal;
+		double overlap;
+		double firstRadius;
+		double secondRadius;
+	};
+	
+	// Force is applied on the first solid, its opposite on the second one.
+	struct ContactForces{
+		GeometricalSpaceObjects::Vector<double> force;
+		GeometricalSpaceObjects::Vector<double> firstMomentum;
+		GeometricalSpaceObjects::Vector<double> secondMomentum;
+	};
+	
+	class ContactColoring;
+	
+	class ContactForceEngine{
+	public:
+		ContactForceEngine(std::unique_ptr<ContactForceModel> model, std::size_t expectedContacts = 1024);
+		~ContactForceEngine();
+		
+		// Applies the contact forces and momentums of the candidate pairs into the solids,
+		// then evicts the history of contacts that were not active during this step.
+		void Apply(std::vector<Solid>& solids, const std::vector<ContactPair>& pairs, double dt);
+		void Apply(std::vector<Solid>& solids, const VerletList& neighbors, double dt);
+		// Batches of a coloring share no solid and run one after the other on the pool.
+		void Apply(std::vector<Solid>& solids, const ContactColoring& coloring, ThreadPool& pool, double dt);
+		
+		// Inserts the history of the touching pairs, after which Evaluate may run concurrently
+		// on distinct pairs.
+		void Prepare(const std::vector<Solid>& solids, const std::vector<ContactPair>& pairs);
+		bool Evaluate(const Solid& first, const Solid& second, std::uint32_t firstIndex, std::uint32_t secondIndex, double dt, ContactForces& forces);
+		void EndStep() { this->history.EvictStale(this->step); }
+		
+		bool Touching(const Solid& first, const Solid& second, ContactGeometry& geometry) const;
+		void Compute(const Solid& first, const Solid& second, const ContactGeometry& geometry, ContactHistory::Entry& history, double dt, ContactForces& forces) const;
+		
+		// Contacts are sphere-sphere: other shapes collide through their bounding
+		// sphere, the same one the neighbor list is built from.
+		static double Radius(const Solid& solid);
+		
+		void Domain(const GeometricalSpaceObjects::PeriodicBox<double>& domain) { this->domain = domain; }
+		const GeometricalSpaceObjects::PeriodicBox<double>& Domain() const { return this->domain; }
+		
+		// History keys are built from these ids (index to id) instead of the solid indices,
+		// so that contacts survive a reorder of the solids.
+		void Ids(const std::vector<std::uint32_t>* ids) { this->ids = ids; }
+		
+		const ContactForceModel& Model() const { return *this->model; }
+		const ContactHistory& History() const { return this->history; }
+		ContactHistory& History() { return this->history; }
+		std::uint32_t Step() const { return this->step; }
+		std::size_t ActiveContacts() const { return this->history.Size(); }
+		
+	private:
+		std::uint64_t Key(std::uint32_t first, std::uint32_t second) const {
+			if(this->ids == nullptr)
+				return ContactHistory::Key(first, second);
+			return ContactHistory::Key((*this->ids)[first], (*this->ids)[second]);
+		}
+		
+		// Springs are stored as seen from the solid with the smaller id, so that the pair
+		// may come in either order, as it does after a reorder.
+		bool Reversed(std::uint32_t first, std::uint32_t second) const {
+			if(this->ids == nullptr)
+				return first > second;
+			return (*this->ids)[first] > (*this->ids)[second];
+		}
+		
+		static void Flip(ContactHistory::Entry& entry) {
+			for(int k = 0 ; k < 3 ; ++k)
+				entry.tangentialDisplacement[k] = -entry.tangentialDisplacement[k];
+		}
+		
+		void ComputeOriented(const Solid& first, const Solid& second, std::uint32_t firstIndex, std::uint32_t secondIndex, const ContactGeometry& geometry, ContactHistory::Entry& entry, double dt, ContactForces& forces) const {
+			bool reversed = this->Reversed(firstIndex, secondIndex);
+			if(reversed)
+				Flip(entry);
+			this->Compute(first, second, geometry, entry, dt, forces);
+			if(reversed)
+				Flip(entry);
+		}
+		
+		void ApplyPair(Solid& first, Solid& second, std::uint32_t firstIndex, std::uint32_t secondIndex, double dt) {
+			ContactGeometry geometry;
+			if(!this->Touching(first, second, geometry))
+				return;
+			bool inserted;
+			ContactHistory::Entry* entry = this->history.FindOrInsert(this->Key(firstIndex, secondIndex), this->step, inserted);
+			ContactForces forces;
+			this->ComputeOriented(first, second, firstIndex, secondIndex, geometry, *entry, dt, forces);
+			first.AddForce(forces.force);
+			second.AddForce(forces.force*(-1.));
+			first.AddMomentum(forces.firstMomentum);
+			second.AddMomentum(forces.secondMomentum);
+		}
+		
+		std::unique_ptr<ContactForceModel> model;
+		ContactHistory history;
+		GeometricalSpaceObjects::PeriodicBox<double> domain;
+		std::uint32_t step{0};
+		const std::vector<std::uint32_t>* ids{nullptr};
+	};
+	
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+
+namespace GeometricalSolid {
+	
+	struct ContactCoefficients{
+		double normalStiffness;
+		double normalDamping;
+		double tangentialStiffness;
+		double tangentialDamping;
+	};
+	
+	class ContactForceModel{
+	public:
+		ContactForceModel(const double restitution, const double friction):restitution(restitution), friction(friction) {
+			if(!(restitution >= 0 && restitution <= 1))
+				throw(std::runtime_error("ContactForceModel: restitution out of [0, 1]"));
+		}
+		virtual ~ContactForceModel() {}
+		
+		// Normal force magnitude is normalStiffness*overlap + normalDamping*approachVelocity.
+		virtual void Coefficients(const double overlap, const double effectiveRadius, const double effectiveMass, ContactCoefficients& coefficients) const = 0;
+		
+		double Restitution() const { return this->restitution; }
+		double Friction() const { return this->friction; }
+		
+	protected:
+		// Damping ratio giving the requested coefficient of restitution; a perfectly
+		// plastic contact is its limit, critical damping.
+		double DampingRatio() const {
+			if(this->restitution == 0)
+				return 1;
+			double logRestitution = log(this->restitution);
+			return -logRestitution/sqrt(logRestitution*logRestitution + M_PI*M_PI);
+		}
+		
+		double restitution;
+		double friction;
+	};
+	
+	class LinearSpringDashpotModel: public ContactForceModel{
+	public:
+		LinearSpringDashpotModel(const double normalStiffness, const double tangentialStiffness, const double restitution, const double friction):ContactForceModel(restitution, friction), normalStiffness(normalStiffness), tangentialStiffness(tangentialStiffness) {}
+		~LinearSpringDashpotModel() {}
+		
+		virtual void Coefficients(const double, const double, const double effectiveMass, ContactCoefficients& coefficients) const {
+			coefficients.normalStiffness = this->normalStiffness;
+			coefficients.normalDamping = 2*this->DampingRatio()*sqrt(effectiveMass*this->normalStiffness);
+			coefficients.tangentialStiffness = this->tangentialStiffness;
+			coefficients.tangentialDamping = 2*this->DampingRatio()*sqrt(effectiveMass*this->tangentialStiffness);
+		}
+		
+	private:
+		double normalStiffness;
+		double tangentialStiffness;
+	};
+	
+	class HertzMindlinModel: public ContactForceModel{
+	public:
+		HertzMindlinModel(const double youngModulus, const double poissonRatio, const double restitution, const double friction):ContactForceModel(restitution, friction), youngModulus(youngModulus), poissonRatio(poissonRatio) {
+			this->init();
+		}
+		~HertzMindlinModel() {}
+		
+		virtual void Coefficients(const double overlap, const double effectiveRadius, const double effectiveMass, ContactCoefficients& coefficients) const {
+			double contactRadius = sqrt(effectiveRadius*overlap);
+			double normalSpring = 2*this->effectiveYoungModulus*contactRadius;
+			double tangentialSpring = 8*this->effectiveShearModulus*contactRadius;
+			double damping = 2*sqrt(5./6.)*this->DampingRatio();
+			coefficients.normalStiffness = 2./3.*normalSpring;
+			coefficients.normalDamping = damping*sqrt(normalSpring*effectiveMass);
+			coefficients.tangentialStiffness = tangentialSpring;
+			coefficients.tangentialDamping = damping*sqrt(tangentialSpring*effectiveMass);
+		}
+		
+		double YoungModulus() const { return this->youngModulus; }
+		double PoissonRatio() const { return this->poissonRatio; }
+		
+	private:
+		void init() {
+			// Both solids share the same material.
+			this->effectiveYoungModulus = this->youngModulus/(2*(1 - this->poissonRatio*this->poissonRatio));
+			double shearModulus = this->youngModulus/(2*(1 + this->poissonRatio));
+			this->effectiveShearModulus = shearModulus/(2*(2 - this->poissonRatio));
+		}
+		
+		double youngModulus;
+		double poissonRatio;
+		double effectiveYoungModulus{0};
+		double effectiveShearModulus{0};
+	};
+	
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace GeometricalSolid {
+	
+	// Per-contact tangential spring history, stored in an open-addressing
+	// (linear probing) table keyed on the solid pair.
+	class ContactHistory{
+	public:
+		struct Entry{
+			std::uint64_t key;
+			std::uint32_t lastStep;
+			double tangentialDisplacement[3];
+		};
+		
+		ContactHistory(std::size_t expectedContacts = 1024);
+		~ContactHistory() {}
+		
+		static std::uint64_t Key(std::uint32_t first, std::uint32_t second) {
+			return first < second ? (static_cast<std::uint64_t>(first) << 32) | second : (static_cast<std::uint64_t>(second) << 32) | first;
+		}
+		
+		Entry* Find(std::uint64_t key);
+		Entry* FindOrInsert(std::uint64_t key, std::uint32_t step, bool& inserted);
+		bool Erase(std::uint64_t key);
+		
+		// Removes every entry not refreshed during the last maxAge steps.
+		std::size_t EvictStale(std::uint32_t step, std::uint32_t maxAge = 0);
+		
+		void Reserve(std::size_t contacts);
+		void Clear();
+		
+		std::size_t Size() const { return this->size; }
+		std::size_t Capacity() const { return this->entries.size(); }
+		std::size_t MemoryFootprint() const { return (this->entries.capacity() + this->spare.capacity())*sizeof(Entry); }
+		
+	private:
+		static const std::uint64_t emptyKey = 0;
+		static const std::uint64_t erasedKey = ~static_cast<std::uint64_t>(0);
+		
+		static std::size_t Hash(std::uint64_t key) {
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			key *= 0xc4ceb9fe1a85ec53ULL;
+			key ^= key >> 33;
+			return static_cast<std::size_t>(key);
+		}
+		
+		void Rehash(std::size_t capacity);
+		
+		std::vector<Entry> entries;
+		std::vector<Entry> spare;
+		std::size_t mask{0};
+		std::size_t size{0};
+		std::size_t erased{0};
+	};
+	
+}
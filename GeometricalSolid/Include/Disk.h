@@ -7,19 +7,23 @@ namespace GeometricalSolid{
 	
 	class Disk: public Shape{
 	public:
-		RetDiskangle(const double radius, const double thickness, const double density):radius(raidus), thickness(thickness), density(density) {
+		Disk(const double radius, const double thickness, const double density):radius(radius), thickness(thickness), density(density) {
 			this->init();
 		}
 		
+		~Disk() {}
+		
 		double Density() const { return this->density; }
 		double Volume() const { return this->volume; }
+		virtual std::size_t MemoryFootprint() const { return sizeof(Disk); }
 		double Radius() const { return this->radius; }
-		double Thickness const { return this-> thickness; }
+		double Thickness() const { return this->thickness; }
 		
 	private:
 		void init() {
 			this->nature = Shape::Nature::Container;
 			this->form = Shape::Form::Disk;
+			this->boundingRadius = sqrt(this->radius*this->radius + this->thickness*this->thickness/4);
 			this->volume = this->radius*this->radius*M_PI*this->thickness;
 			this->mass = this->volume*this->density;
 			this->inertia.Element(0, 0, this->mass*(this->radius*this->radius/4. + this->thickness*this->thickness/12.));
@@ -32,7 +36,6 @@ namespace GeometricalSolid{
 		double thickness{1};
 		double density{2500};
 		double volume{M_PI};
-		double mass{2500*M_PI};
 		GeometricalSpaceObjects::Matrix<double> inertia;
 	};
 }
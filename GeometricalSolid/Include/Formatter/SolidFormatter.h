@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <string>
+
 #include "Solid.h"
 #include <Formatter/BasisFormatter.h>
-#include <Formatter/VectorFormatter.H>
+#include <Formatter/VectorFormatter.h>
 
 using GeometricalSpaceObjects::LuGaBasisFormatter;
 using GeometricalSpaceObjects::LuGaVectorFormatter;
@@ -18,18 +21,37 @@ namespace GeometricalSolid {
 	
 	class LuGaSolidFormatter: public SolidFormatter{
 	public:
-		LuGaSolidFormatter(){}
+		LuGaSolidFormatter(int precision = 15):basisFormatter(precision), vectorFormatter(precision){}
 		~LuGaSolidFormatter(){}
 		
 		virtual std::string Format(const Solid& solid) {
-			std::stringstream sstr;
-			sstr.precision(15);
-			sstr << basisFormatter.Format(solid.Basis()) << "\n";
-			sstr << vectorFormatter.Format(solid.Force()) << "\n";
-			sstr << vectorFormatter.Format(solid.Momentum());
-			return sstr.str();
+			std::string text;
+			this->Format(solid, text);
+			return text;
+		}
+		
+		void Format(const Solid& solid, std::string& out) const {
+			this->basisFormatter.Format(solid.Basis(), out);
+			out += '\n';
+			this->vectorFormatter.Format(solid.Force(), out);
+			out += '\n';
+			this->vectorFormatter.Format(solid.Momentum(), out);
 		}
+		
+		// Appends every solid followed by a newline; out is reserved once, so reusing
+		// the same buffer from one output to the next does not allocate.
+		void FormatAll(const Solid* first, std::size_t count, std::string& out) const {
+			out.reserve(out.size() + count*this->EstimatedSize());
+			for(std::size_t i = 0 ; i < count ; ++i){
+				this->Format(first[i], out);
+				out += '\n';
+			}
+		}
+		
 	private:
+		// Thirteen numbers of at most 24 characters each, with their separators.
+		static std::size_t EstimatedSize() { return 13*25; }
+		
 		LuGaBasisFormatter<double> basisFormatter;
 		LuGaVectorFormatter<double> vectorFormatter;
 	};
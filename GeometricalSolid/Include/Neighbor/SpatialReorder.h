@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	// Sorts the solids along a Morton curve of their origin so that solids close in space
+	// are close in memory. Ids stay attached to the solids across reorders; indices into
+	// the solid array (neighbor lists, pairs) must be rebuilt after each reorder.
+	class SpatialReorder{
+	public:
+		SpatialReorder(std::size_t period);
+		~SpatialReorder() {}
+		
+		bool Update(std::vector<Solid>& solids, std::size_t step);
+		void Reorder(std::vector<Solid>& solids);
+		bool Due(std::size_t step) const { return this->period != 0 && step % this->period == 0; }
+		
+		static std::uint64_t MortonKey(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+		
+		std::size_t Period() const { return this->period; }
+		void Period(std::size_t period) { this->period = period; }
+		std::size_t Reorders() const { return this->reorders; }
+		std::size_t MemoryFootprint() const;
+		
+		const std::vector<std::uint32_t>& Ids() const { return this->ids; }
+		std::uint32_t IdOf(std::uint32_t index) const { return this->ids[index]; }
+		std::uint32_t IndexOf(std::uint32_t id) const { return this->indices[id]; }
+		// New index to index before the last reorder.
+		const std::vector<std::uint32_t>& Permutation() const { return this->permutation; }
+		
+	private:
+		void Track(std::size_t count);
+		
+		std::size_t period;
+		std::size_t reorders{0};
+		std::vector<std::uint32_t> ids;
+		std::vector<std::uint32_t> indices;
+		std::vector<std::uint32_t> permutation;
+		std::vector<std::uint32_t> reorderedIds;
+		std::vector<std::uint64_t> keys;
+		std::vector<bool> placed;
+	};
+	
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	struct VerletListStatistics{
+		std::size_t updates;
+		std::size_t builds;
+		double stepsPerBuild;
+		double maxDisplacement;
+	};
+	
+	// Half neighbor list (j > i) of the solids closer than the sum of their bounding
+	// radii plus the skin, stored in compressed sparse rows.
+	class VerletList{
+	public:
+		VerletList(double skin);
+		~VerletList() {}
+		
+		// Rebuilds the list when the skin could have been crossed since the last build.
+		bool Update(const std::vector<Solid>& solids);
+		void Build(const std::vector<Solid>& solids);
+		bool NeedsRebuild(const std::vector<Solid>& solids);
+		void Invalidate() { this->valid = false; }
+		
+		// Pairs are found across the periodic images of the domain, without ghost copies.
+		void Domain(const GeometricalSpaceObjects::PeriodicBox<double>& domain) { this->domain = domain; this->valid = false; }
+		const GeometricalSpaceObjects::PeriodicBox<double>& Domain() const { return this->domain; }
+		
+		double Skin() const { return this->skin; }
+		void Skin(double skin) { this->skin = skin; this->valid = false; }
+		
+		std::size_t SolidCount() const { return this->offsets.empty() ? 0 : this->offsets.size() - 1; }
+		std::size_t PairCount() const { return this->neighbors.size(); }
+		const std::vector<std::uint32_t>& Offsets() const { return this->offsets; }
+		const std::vector<std::uint32_t>& Neighbors() const { return this->neighbors; }
+		const std::uint32_t* Begin(std::size_t solid) const { return this->neighbors.data() + this->offsets[solid]; }
+		const std::uint32_t* End(std::size_t solid) const { return this->neighbors.data() + this->offsets[solid + 1]; }
+		
+		VerletListStatistics Statistics() const;
+		std::size_t MemoryFootprint() const;
+		void ResetStatistics();
+		
+	private:
+		void BuildCells(std::size_t count, double cellSize);
+		std::size_t NeighborCells(std::size_t cell, int axis, std::size_t* neighborCells) const;
+		
+		double skin;
+		GeometricalSpaceObjects::PeriodicBox<double> domain;
+		bool periodic[3];
+		bool valid{false};
+		
+		std::vector<std::uint32_t> offsets;
+		std::vector<std::uint32_t> neighbors;
+		std::vector<double> reference;
+		std::vector<double> radii;
+		
+		double lower[3];
+		double cellWidth[3];
+		std::size_t dimensions[3];
+		std::vector<std::uint32_t> cellOfSolid;
+		std::vector<std::uint32_t> cellStart;
+		std::vector<std::uint32_t> cellSolids;
+		
+		std::size_t updates{0};
+		std::size_t builds{0};
+		double maxDisplacement{0};
+	};
+	
+}
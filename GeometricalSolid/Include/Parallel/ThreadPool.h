@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Profiling/Phase.h"
+
+namespace GeometricalSolid {
+	
+	// Persistent workers running static chunks of an index range. The calling thread
+	// takes the first chunk; dispatching a loop never allocates.
+	class ThreadPool{
+	public:
+		ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+		~ThreadPool();
+		
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+		
+		std::size_t Size() const { return this->workers.size() + 1; }
+		
+		// Calls function(begin, end, thread) on contiguous chunks of [0, count) and
+		// returns once every chunk is done.
+		template<class Function>
+		void ParallelFor(std::size_t count, const Function& function) {
+			if(this->workers.empty() || count < 2){
+				function(static_cast<std::size_t>(0), count, static_cast<std::size_t>(0));
+				return;
+			}
+			this->Run(&ThreadPool::Invoke<Function>, &function, count);
+		}
+		
+	private:
+		typedef void (*Task)(const void* function, std::size_t begin, std::size_t end, std::size_t thread);
+		
+		template<class Function>
+		static void Invoke(const void* function, std::size_t begin, std::size_t end, std::size_t thread) {
+			(*static_cast<const Function*>(function))(begin, end, thread);
+		}
+		
+		void Run(Task task, const void* function, std::size_t count);
+		void RunChunk(std::size_t thread);
+		void WorkerLoop(std::size_t thread);
+		
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wakeUp;
+		std::condition_variable finished;
+		Task task{nullptr};
+		const void* function{nullptr};
+		std::size_t count{0};
+		std::size_t generation{0};
+		std::size_t remaining{0};
+		bool stopping{false};
+		Phase phase{Phase::Count};	// phase of the calling thread, for the workers
+	};
+	
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "ReadAhead.h"
+#include "../Solid.h"
+#include <Parser/BasisParser.h>
+#include <Parser/VectorParser.h>
+
+namespace GeometricalSolid {
+	
+	// How one LuGa record is made and read, as written by its operator<<.
+	template<class Record>
+	struct LuGaRecord;
+	
+	template<>
+	struct LuGaRecord<Solid>{
+		static Solid Make() { return Solid(std::unique_ptr<GeometricalSolid::Shape>()); }
+		
+		static bool Parse(const char*& first, const char* last, Solid& solid) {
+			GeometricalSpaceObjects::Basis<double> basis;
+			GeometricalSpaceObjects::Vector<double> velocity, angularVelocity, force, momentum;
+			GeometricalSpaceObjects::LuGaVectorParser<double> parser;
+			if(!GeometricalSpaceObjects::LuGaBasisParser<double>().Parse(first, last, basis) || !parser.Parse(first, last, velocity)
+			   || !parser.Parse(first, last, angularVelocity) || !parser.Parse(first, last, force) || !parser.Parse(first, last, momentum))
+				return false;
+			solid.Basis(basis);
+			solid.Velocity(velocity);
+			solid.AngularVelocity(angularVelocity);
+			solid.Force(force);
+			solid.Momentum(momentum);
+			return true;
+		}
+	};
+	
+	template<class T>
+	struct LuGaRecord<GeometricalSpaceObjects::Basis<T>>{
+		static GeometricalSpaceObjects::Basis<T> Make() { return GeometricalSpaceObjects::Basis<T>(); }
+		
+		static bool Parse(const char*& first, const char* last, GeometricalSpaceObjects::Basis<T>& basis) {
+			return GeometricalSpaceObjects::LuGaBasisParser<T>().Parse(first, last, basis);
+		}
+	};
+	
+	// Single-pass range over the records of a LuGa file:
+	//     for(auto& solid : LuGaSolidStream(path)) ...
+	// The file is read ahead on a background thread into fixed-size buffers and each
+	// record is parsed into the same object, so memory stays bounded for files of any
+	// size. Solids come without shape. A malformed record throws.
+	template<class Record>
+	class LuGaRecordStream{
+	public:
+		class Iterator{
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef Record value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Record* pointer;
+			typedef Record& reference;
+			
+			Iterator(LuGaRecordStream* stream):stream(stream) {}
+			
+			Record& operator*() const { return this->stream->record; }
+			Record* operator->() const { return &this->stream->record; }
+			
+			Iterator& operator++() {
+				if(!this->stream->Next())
+					this->stream = nullptr;
+				return *this;
+			}
+			
+			bool operator==(const Iterator& other) const { return this->stream == other.stream; }
+			bool operator!=(const Iterator& other) const { return this->stream != other.stream; }
+			
+		private:
+			LuGaRecordStream* stream;
+		};
+		
+		// No LuGa record comes close; longer text without a record is malformed.
+		static const std::size_t maximumRecordSize = 4096;
+		
+		LuGaRecordStream(const std::string& path, std::size_t bufferSize = 1 << 20):path(path), input(path, bufferSize), record(LuGaRecord<Record>::Make()) {}
+		~LuGaRecordStream() {}
+		
+		// Reads the first record; the stream cannot be restarted.
+		Iterator begin() { return Iterator(this->Next() ? this : nullptr); }
+		Iterator end() { return Iterator(nullptr); }
+		
+		std::size_t RecordCount() const { return this->count; }
+		
+	private:
+		bool Next() {
+			while(true){
+				const char* first = this->text.data() + this->position;
+				if(LuGaRecord<Record>::Parse(first, this->text.data() + this->available, this->record)){
+					this->position = first - this->text.data();
+					++this->count;
+					return true;
+				}
+				if(this->finished){
+					if(this->text.find_first_not_of(" \t\r\n", this->position) == std::string::npos)
+						return false;
+					throw(std::runtime_error("LuGaRecordStream: record " + std::to_string(this->count) + " of " + this->path + " is malformed"));
+				}
+				if(this->available - this->position >= maximumRecordSize || this->text.size() - this->available >= maximumRecordSize)
+					throw(std::runtime_error("LuGaRecordStream: record " + std::to_string(this->count) + " of " + this->path + " is malformed"));
+				this->Refill();
+			}
+		}
+		
+		// Only whole lines are parsed, so that no number is cut at the end of a block.
+		void Refill() {
+			this->text.erase(0, this->position);
+			this->position = 0;
+			if(!this->input.Next(this->text)){
+				this->finished = true;
+				this->available = this->text.size();
+				return;
+			}
+			std::size_t newline = this->text.rfind('\n');
+			this->available = newline == std::string::npos ? 0 : newline + 1;
+		}
+		
+		std::string path;
+		ReadAhead input;
+		std::string text;
+		std::size_t position{0};
+		std::size_t available{0};
+		bool finished{false};
+		Record record;
+		std::size_t count{0};
+	};
+	
+	typedef LuGaRecordStream<Solid> LuGaSolidStream;
+	typedef LuGaRecordStream<GeometricalSpaceObjects::Basis<double>> LuGaBasisStream;
+	
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GeometricalSolid {
+	
+	// Reads a file front to back into a ring of fixed-size buffers on a background
+	// thread, so that the disk works while the caller parses the previous block.
+	// Memory is bounded by the ring whatever the size of the file.
+	class ReadAhead{
+	public:
+		ReadAhead(const std::string& path, std::size_t bufferSize = 1 << 20, std::size_t buffers = 2);
+		~ReadAhead();
+		
+		ReadAhead(const ReadAhead& other) = delete;
+		ReadAhead& operator=(const ReadAhead& other) = delete;
+		
+		// Appends the next block of the file to text; false once the file is exhausted.
+		// Read errors of the background thread are thrown here.
+		bool Next(std::string& text);
+		
+	private:
+		void ReaderLoop();
+		
+		std::string path;
+		std::ifstream in;
+		std::vector<std::vector<char>> buffers;
+		std::vector<std::size_t> sizes;
+		std::size_t head{0};	// oldest filled buffer
+		std::size_t filled{0};
+		bool finished{false};
+		bool stopping{false};
+		std::exception_ptr error;
+		
+		std::mutex mutex;
+		std::condition_variable bufferFilled;
+		std::condition_variable bufferReleased;
+		std::thread reader;
+	};
+	
+}
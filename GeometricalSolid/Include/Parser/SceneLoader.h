@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../Parallel/ThreadPool.h"
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	// Reads a LuGa scene, solids written one after the other with operator<<, from a
+	// memory-mapped file. The file is cut into chunks of whole lines, which are parsed
+	// in parallel straight into the solids; a record is six lines holding nineteen
+	// numbers, and blank lines between records are ignored.
+	class SceneLoader{
+	public:
+		static const std::size_t linesPerRecord = 6;
+		
+		SceneLoader(const std::string& path, std::size_t chunkSize = 1 << 22);
+		~SceneLoader();
+		
+		SceneLoader(const SceneLoader& other) = delete;
+		SceneLoader& operator=(const SceneLoader& other) = delete;
+		
+		std::size_t Size() const { return this->size; }
+		
+		// Throws if the lines do not make whole records.
+		std::size_t RecordCount(ThreadPool& pool);
+		
+		// Sets basis, velocities, force and momentum of solids[0, count); count must be
+		// the record count. Shapes and locks are left alone.
+		void Load(Solid* solids, std::size_t count, ThreadPool& pool);
+		
+		// Resizes solids to the record count first; added solids have no shape.
+		void Load(std::vector<Solid>& solids, ThreadPool& pool);
+		
+	private:
+		struct Chunk{
+			const char* begin;
+			const char* end;
+			std::size_t lines;		// non-blank lines
+			std::size_t firstLine;	// non-blank lines before the chunk
+		};
+		
+		void Split();
+		void CountLines(ThreadPool& pool);
+		void Parse(const Chunk& chunk, Solid* solids, std::string& error) const;
+		
+		std::string path;
+		const char* data{nullptr};
+		std::size_t size{0};
+		std::size_t chunkSize;
+		std::vector<Chunk> chunks;
+		std::size_t lineCount{0};
+		bool counted{false};
+	};
+	
+}
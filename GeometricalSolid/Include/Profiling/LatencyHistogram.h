@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace GeometricalSolid {
+	
+	// Log-bucketed histogram of integer values, in the manner of HdrHistogram: values
+	// below 128 are exact, larger ones fall in 64 linear sub-buckets per power of two,
+	// within 1.6% of the value. One thread records while others may query.
+	class LatencyHistogram{
+	public:
+		LatencyHistogram();
+		~LatencyHistogram() {}
+		
+		LatencyHistogram(const LatencyHistogram& other) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+		
+		void Record(std::uint64_t value);
+		void Reset();
+		
+		std::uint64_t Count() const { return this->count.load(std::memory_order_relaxed); }
+		std::uint64_t Max() const { return this->max.load(std::memory_order_relaxed); }
+		double Mean() const;
+		// Smallest recorded bucket below which the fraction of the values lies, 0 when empty.
+		std::uint64_t Percentile(double fraction) const;
+		std::size_t MemoryFootprint() const { return this->buckets.capacity()*sizeof(std::atomic<std::uint64_t>); }
+		
+		static std::size_t Bucket(std::uint64_t value);
+		static std::size_t BucketCount();
+		// Middle of the values of a bucket.
+		static std::uint64_t Value(std::size_t bucket);
+		
+	private:
+		std::vector<std::atomic<std::uint64_t>> buckets;
+		std::atomic<std::uint64_t> count{0};
+		std::atomic<std::uint64_t> sum{0};
+		std::atomic<std::uint64_t> max{0};
+	};
+	
+}
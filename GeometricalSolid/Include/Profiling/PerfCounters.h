@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Phase.h"
+
+namespace GeometricalSolid {
+	
+	enum class Counter{
+		Cycles,
+		Instructions,
+		L1Misses,		// L1 data cache read misses
+		LlcMisses,
+		BranchMisses,
+		Count
+	};
+	
+	const char* CounterName(Counter counter);
+	
+	struct CounterSample{
+		std::uint64_t values[static_cast<int>(Counter::Count)];
+	};
+	
+	struct PerfReport{
+		struct Entry{
+			std::uint64_t calls;
+			std::uint64_t values[static_cast<int>(Counter::Count)];
+			
+			std::uint64_t operator[](Counter counter) const { return this->values[static_cast<int>(counter)]; }
+		};
+		typedef std::vector<Entry> Phases;	// indexed by phase
+		
+		std::vector<Phases> threads;
+		bool available[static_cast<int>(Counter::Count)];
+		
+		bool Available(Counter counter) const { return this->available[static_cast<int>(counter)]; }
+		Entry Total(Phase phase) const;
+		
+		// Derived metrics are given per call and, for the misses, per body.
+		void WriteText(std::ostream& out, std::size_t bodies = 1) const;
+		void WriteJson(std::ostream& out, std::size_t bodies = 1) const;
+	};
+	
+	// Hardware counters per phase and per thread from perf_event_open. Each thread opens
+	// its own counter group on first use and adds to its own totals, so reading takes no
+	// lock. Counters the kernel refuses, for lack of permission or of a PMU, are left
+	// out and read as zero; elsewhere than on Linux none is available.
+	class PerfCounters{
+	public:
+		// Returns whether any counter could be opened.
+		static bool Start();
+		static void Stop();
+		static bool Counting() { return counting.load(std::memory_order_relaxed); }
+		
+		static bool Available(Counter counter);
+		// Why counters are missing, empty when they are all available.
+		static std::string Status();
+		
+		static void Read(CounterSample& sample);
+		// Adds the counts since begin to the phase of the calling thread.
+		static void Record(Phase phase, const CounterSample& begin);
+		
+		static PerfReport Report();
+		static void Reset();
+		
+	private:
+		static std::atomic<bool> counting;
+	};
+	
+}
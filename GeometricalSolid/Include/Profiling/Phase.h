@@ -0,0 +1,19 @@
+#pragma once
+
+namespace GeometricalSolid {
+	
+	enum class Phase{
+		Reorder,
+		Forces,
+		Neighbors,
+		Contacts,
+		Velocities,
+		Positions,
+		Output,
+		Checkpoint,
+		Count
+	};
+	
+	const char* PhaseName(Phase phase);
+	
+}
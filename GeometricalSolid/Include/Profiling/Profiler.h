@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+#include "Phase.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+
+namespace GeometricalSolid {
+	
+	struct PhaseStatistics{
+		std::uint64_t calls;
+		double seconds;
+	};
+	
+	struct ProfileReport{
+		PhaseStatistics phases[static_cast<int>(Phase::Count)];
+		std::size_t threads;
+		double wallSeconds;	// since the last reset
+		
+		const PhaseStatistics& operator[](Phase phase) const { return this->phases[static_cast<int>(phase)]; }
+		double Seconds() const;
+		
+		void WriteText(std::ostream& out) const;
+		void WriteJson(std::ostream& out) const;
+	};
+	
+	// Call counts and time per phase. Each thread adds to its own counters, so recording
+	// takes no lock; Report sums the threads. Ticks come from the time stamp counter on
+	// x86 and from the steady clock elsewhere.
+	class Profiler{
+	public:
+		static std::uint64_t Now();
+		static double TicksPerSecond();
+		
+		static void Record(Phase phase, std::uint64_t ticks);
+		static ProfileReport Report();
+		// Later reports only count what is recorded from now on.
+		static void Reset();
+	};
+	
+	// Times a scope as the current phase of the thread and, when enabled, adds its trace
+	// event and hardware counters.
+	class ScopedPhase{
+	public:
+		explicit ScopedPhase(Phase phase):phase(phase), outer(Trace::Enter(phase)), counting(PerfCounters::Counting()) {
+			if(this->counting)
+				PerfCounters::Read(this->counters);
+			this->start = Profiler::Now();
+		}
+		~ScopedPhase() {
+			std::uint64_t end = Profiler::Now();
+			Profiler::Record(this->phase, end - this->start);
+			if(this->counting)
+				PerfCounters::Record(this->phase, this->counters);
+			if(Trace::Capturing())
+				Trace::Record(this->phase, -1, this->start, end);
+			Trace::Leave(this->outer);
+		}
+		
+		ScopedPhase(const ScopedPhase& other) = delete;
+		ScopedPhase& operator=(const ScopedPhase& other) = delete;
+		
+	private:
+		Phase phase;
+		Phase outer;
+		bool counting;
+		std::uint64_t start;
+		CounterSample counters;
+	};
+	
+}
+
+// Times the rest of the enclosing scope; compiled out unless GEOMETRICALSOLID_PROFILING is defined.
+#ifdef GEOMETRICALSOLID_PROFILING
+#define PROFILE_PHASE_JOIN(a, b) a##b
+#define PROFILE_PHASE_NAME(line) PROFILE_PHASE_JOIN(profilePhase, line)
+#define PROFILE_PHASE(phase) GeometricalSolid::ScopedPhase PROFILE_PHASE_NAME(__LINE__)(GeometricalSolid::Phase::phase)
+#else
+#define PROFILE_PHASE(phase) do{}while(0)
+#endif
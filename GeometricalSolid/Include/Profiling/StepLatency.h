@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "Phase.h"
+#include "LatencyHistogram.h"
+
+namespace GeometricalSolid {
+	
+	struct LatencySummary{
+		std::uint64_t steps;
+		double p50;			// seconds
+		double p99;
+		double p999;
+		double max;
+		double mean;
+		std::uint64_t overruns;
+	};
+	
+	// A step longer than the deadline, blamed on the phase furthest above its median.
+	struct StepOverrun{
+		std::uint64_t step;
+		double seconds;
+		Phase phase;
+		double phaseSeconds;
+		double phaseMedian;
+	};
+	
+	// Wall time of each step and of its phases, taken between Begin, the Mark closing each
+	// phase and End. The stepping thread records without locking; Summary, Histogram and
+	// Overruns may be queried from other threads while it runs.
+	class StepLatency{
+	public:
+		static const std::size_t defaultKept = 64;
+		
+		// A deadline of 0 flags nothing; the last kept overruns are remembered.
+		explicit StepLatency(double deadline = 0, std::size_t kept = defaultKept);
+		~StepLatency() {}
+		
+		StepLatency(const StepLatency& other) = delete;
+		StepLatency& operator=(const StepLatency& other) = delete;
+		
+		void Begin();
+		void Mark(Phase phase);
+		void End(std::uint64_t step);
+		// Ticks of the step in progress, up to its last Mark.
+		std::uint64_t Elapsed() const { return this->last - this->begin; }
+		std::uint64_t Ticks(Phase phase) const { return this->current[static_cast<int>(phase)]; }
+		
+		double Deadline() const { return this->deadline; }
+		void Deadline(double deadline);
+		
+		LatencySummary Summary() const;
+		LatencySummary Summary(Phase phase) const;
+		const LatencyHistogram& Histogram() const { return this->steps; }
+		const LatencyHistogram& Histogram(Phase phase) const { return this->phases[static_cast<int>(phase)]; }
+		std::uint64_t OverrunCount() const { return this->overrunCount.load(std::memory_order_relaxed); }
+		// Oldest first.
+		std::vector<StepOverrun> Overruns() const;
+		
+		void Reset();
+		std::size_t MemoryFootprint() const;
+		void WriteText(std::ostream& out) const;
+		
+	private:
+		LatencySummary Summarize(const LatencyHistogram& histogram) const;
+		void Overrun(std::uint64_t step, std::uint64_t ticks);
+		
+		double deadline;
+		std::uint64_t deadlineTicks{0};
+		double ticksPerSecond;
+		std::uint64_t begin{0};
+		std::uint64_t last{0};
+		std::uint64_t current[static_cast<int>(Phase::Count)];
+		LatencyHistogram steps;
+		LatencyHistogram phases[static_cast<int>(Phase::Count)];
+		
+		std::atomic<std::uint64_t> overrunCount{0};
+		mutable std::mutex mutex;
+		std::vector<StepOverrun> overruns;	// ring of the last kept
+		std::size_t kept;
+		std::size_t next{0};
+	};
+	
+}
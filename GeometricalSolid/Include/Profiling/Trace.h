@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "Phase.h"
+
+namespace GeometricalSolid {
+	
+	struct TraceOptions{
+		std::uint64_t firstStep{0};
+		std::uint64_t steps{10};		// length of the captured window
+		std::size_t capacity{1 << 14};	// events kept per thread, older ones are overwritten
+	};
+	
+	struct TraceEvent{
+		std::uint64_t begin;	// profiler ticks
+		std::uint64_t end;
+		std::uint64_t step;
+		Phase phase;
+		std::int32_t chunk;		// thread pool chunk, -1 for the whole phase
+	};
+	
+	// Timeline of the phases and of the thread pool chunks that run them, for the steps
+	// of a window only. Each thread appends to its own ring buffer; outside the window
+	// recording costs a relaxed load. Start, Stop and the writers are called between
+	// steps, when no thread records.
+	class Trace{
+	public:
+		static void Start(const TraceOptions& options = TraceOptions());
+		static void Stop();
+		// Called by the step loop before each step, opens and closes the window.
+		static void Step(std::uint64_t step);
+		static bool Capturing() { return capturing.load(std::memory_order_relaxed); }
+		
+		// Phase of the enclosing scope on this thread, Phase::Count outside of any.
+		static Phase Enter(Phase phase);
+		static void Leave(Phase outer);
+		static Phase Current();
+		static void Record(Phase phase, std::int32_t chunk, std::uint64_t begin, std::uint64_t end);
+		
+		static std::size_t Events();
+		static std::size_t Overwritten();
+		// Trace event format, for chrome://tracing or Perfetto.
+		static void WriteChromeTrace(std::ostream& out);
+		static void WriteChromeTrace(const std::string& path);
+		
+	private:
+		static std::atomic<bool> capturing;
+	};
+	
+}
+
+// Captures the steps of the trace window; compiled out unless GEOMETRICALSOLID_PROFILING is defined.
+#ifdef GEOMETRICALSOLID_PROFILING
+#define PROFILE_STEP(step) GeometricalSolid::Trace::Step(step)
+#else
+#define PROFILE_STEP(step) do{}while(0)
+#endif
@@ -5,22 +5,26 @@
 
 namespace GeometricalSolid{
 	
-	class Retangle: public Shape{
+	class Rectangle: public Shape{
 	public:
-		Retangle(const double lenght, const double width, const double thickness, const double density):lenght(lenght), width(width), thickness(thickness), density(density) {
+		Rectangle(const double lenght, const double width, const double thickness, const double density):lenght(lenght), width(width), thickness(thickness), density(density) {
 			this->init();
 		}
 		
+		~Rectangle() {}
+		
 		double Density() const { return this->density; }
 		double Volume() const { return this->volume; }
+		virtual std::size_t MemoryFootprint() const { return sizeof(Rectangle); }
 		double Lenght() const { return this->lenght; }
-		double Width const { return this->width; }
-		double Thickness const { return this-> thickness; }
+		double Width() const { return this->width; }
+		double Thickness() const { return this->thickness; }
 		
 	private:
 		void init() {
 			this->nature = Shape::Nature::Container;
 			this->form = Shape::Form::Rectangle;
+			this->boundingRadius = sqrt(this->lenght*this->lenght + this->width*this->width + this->thickness*this->thickness)/2;
 
 			this->volume = this->lenght*this->width*this->thickness;
 			this->mass = this->volume*this->density;			
@@ -35,7 +39,6 @@ namespace GeometricalSolid{
 		double thickness{1};
 		double density{2500};
 		double volume{1};
-		double mass{2500};
 		GeometricalSpaceObjects::Matrix<double> inertia;
 	};
 }
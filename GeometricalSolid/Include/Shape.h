@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <Matrix.h>
 
 namespace GeometricalSolid{
@@ -24,6 +25,9 @@ namespace GeometricalSolid{
 		
 		virtual ~Shape() {}
 		
+		// Bytes of the shape object, held once per solid.
+		virtual std::size_t MemoryFootprint() const { return sizeof(Shape); }
+		
 		const double& Mass() const {
 			return this->mass;
 		}
@@ -31,6 +35,10 @@ namespace GeometricalSolid{
 		const GeometricalSpaceObjects::Matrix<double>& InvertedIntertia() const {
 			return this->invertedInertia;
 		}
+		
+		double BoundingRadius() const {
+			return this->boundingRadius;
+		}
 
 		Shape::Nature Nature() const { return this->nature; }
 		Shape::Form Form() const { return this->form; }
@@ -39,6 +47,7 @@ namespace GeometricalSolid{
 		enum Nature nature;
 		enum Form form;
 		double mass;
+		double boundingRadius{0};
 		GeometricalSpaceObjects::Matrix<double> invertedInertia;
 	};
 
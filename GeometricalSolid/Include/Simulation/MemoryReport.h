@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+namespace GeometricalSolid {
+	
+	enum class Subsystem{
+		Solids,
+		Shapes,
+		Neighbors,	// Verlet list and its cells
+		Contacts,	// contact history
+		Coloring,	// contact batches, with more than one thread
+		Reorder,
+		Profiling,	// step latency histograms and overrun ring
+		Count
+	};
+	
+	const char* SubsystemName(Subsystem subsystem);
+	
+	struct MemoryEstimateOptions{
+		double neighborsPerSolid{8};	// entries of the half neighbor list
+		double contactsPerSolid{3};
+		std::size_t shapeBytes{0};		// 0 for the largest shape
+		std::size_t threads{1};
+		bool reorder{false};
+	};
+	
+	// Bytes held by each subsystem, from the capacity of its buffers, and the items they
+	// hold: solids, shapes, neighbor entries, contacts, colored pairs. Buffers are never
+	// shrunk, so the capacity is the peak of the run so far.
+	struct MemoryReport{
+		std::size_t bytes[static_cast<int>(Subsystem::Count)];
+		std::size_t items[static_cast<int>(Subsystem::Count)];
+		
+		std::size_t operator[](Subsystem subsystem) const { return this->bytes[static_cast<int>(subsystem)]; }
+		std::size_t Items(Subsystem subsystem) const { return this->items[static_cast<int>(subsystem)]; }
+		// Bytes of the subsystem per item held, overheads included; 0 without items.
+		double PerItem(Subsystem subsystem) const;
+		std::size_t Total() const;
+		
+		void WriteText(std::ostream& out) const;
+		
+		// Peak bytes of a simulation of the bodies, before it is built.
+		static MemoryReport Estimate(std::size_t bodies, const MemoryEstimateOptions& options = MemoryEstimateOptions());
+		// Half neighbor entries per solid at the volume fraction, for solids of the mean
+		// bounding radius and volume.
+		static double NeighborsPerSolid(double fraction, double boundingRadius, double volume, double skin);
+	};
+	
+}
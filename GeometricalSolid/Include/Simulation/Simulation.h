@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../Parallel/ThreadPool.h"
+#include "../Contact/ContactColoring.h"
+#include "../Contact/ContactForceEngine.h"
+#include "../Neighbor/SpatialReorder.h"
+#include "../Neighbor/VerletList.h"
+#include "../Profiling/StepLatency.h"
+#include "StepBudget.h"
+#include "MemoryReport.h"
+
+namespace GeometricalSolid {
+	
+	struct SimulationOptions{
+		double timeStep{1e-5};
+		GeometricalSpaceObjects::Vector<double> gravity{0, 0, -9.81};
+		GeometricalSpaceObjects::PeriodicBox<double> domain;
+		double skin{1e-3};
+		std::size_t reorderPeriod{0};	// steps between spatial reorders, 0 never
+		std::size_t threads{1};
+		double deadline{0};		// seconds per step above which a step is reported as an overrun, 0 none
+		double budget{0};		// seconds per step to stay within by deferring work, 0 none
+	};
+	
+	// Advances solids with a fixed time step. Each step resets the forces to gravity,
+	// adds the contact forces of the Verlet candidates, then integrates velocities and
+	// positions. With more than one thread the contacts run in colored batches.
+	// With a budget, a due reorder or output is postponed while it would not fit in what
+	// is left of the step: a reorder for one period at most, an output for less than a
+	// period so that no frame is lost.
+	class Simulation{
+	public:
+		Simulation(std::vector<Solid> solids, std::unique_ptr<ContactForceModel> model, const SimulationOptions& options = SimulationOptions());
+		~Simulation() {}
+		
+		Simulation(const Simulation& other) = delete;
+		Simulation& operator=(const Simulation& other) = delete;
+		
+		void Step();
+		void Run(std::size_t steps);
+		// Calls writer after every period steps; an empty writer or a period of 0 stops output.
+		void Output(std::function<void(const Simulation&)> writer, std::size_t period);
+		
+		std::vector<Solid>& Solids() { return this->solids; }
+		const std::vector<Solid>& Solids() const { return this->solids; }
+		const SimulationOptions& Options() const { return this->options; }
+		std::uint64_t StepCount() const { return this->step; }
+		double Time() const { return this->step*this->options.timeStep; }
+		
+		ThreadPool& Pool() { return this->pool; }
+		const VerletList& Neighbors() const { return this->neighbors; }
+		const ContactForceEngine& Engine() const { return this->engine; }
+		const SpatialReorder& Reorder() const { return this->reorder; }
+		StepLatency& Latency() { return this->latency; }
+		const StepLatency& Latency() const { return this->latency; }
+		StepBudget& Budget() { return this->budget; }
+		const StepBudget& Budget() const { return this->budget; }
+		MemoryReport Memory() const;
+		
+	private:
+		bool UpdateOrder();
+		void ResetForces();
+		bool UpdateNeighbors();
+		void ApplyContacts();
+		void UpdateVelocities();
+		void UpdatePositions();
+		bool WriteOutput();
+		void Account(bool reordered, bool rebuilt, bool wrote);
+		
+		std::vector<Solid> solids;
+		SimulationOptions options;
+		ThreadPool pool;
+		VerletList neighbors;
+		ContactColoring coloring;
+		ContactForceEngine engine;
+		SpatialReorder reorder;
+		StepLatency latency;
+		StepBudget budget;
+		std::size_t reorderDeferred{0};
+		std::function<void(const Simulation&)> writer;
+		std::size_t outputPeriod{0};
+		std::size_t outputDeferred{0};
+		std::uint64_t step{0};
+	};
+	
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace GeometricalSolid {
+	
+	// Work a step may postpone to stay within its budget.
+	enum class Degradation{
+		DeferReorder,	// spatial reorder, with the neighbor rebuild it forces
+		DeferOutput,	// output writer
+		Count
+	};
+	
+	const char* DegradationName(Degradation degradation);
+	
+	struct BudgetReport{
+		double budget;			// seconds per step
+		std::uint64_t steps;
+		std::uint64_t degraded;	// steps with at least one degradation
+		std::uint64_t overruns;	// steps over budget all the same
+		std::uint64_t applied[static_cast<int>(Degradation::Count)];
+		
+		std::uint64_t operator[](Degradation degradation) const { return this->applied[static_cast<int>(degradation)]; }
+		
+		void WriteText(std::ostream& out) const;
+	};
+	
+	// Fixed time budget per step. Keeps the last measured cost of each deferrable work
+	// and a running estimate of the work a step cannot skip, and decides whether the
+	// deferrable work still fits in what is left of the step. Times are in profiler ticks.
+	class StepBudget{
+	public:
+		// A budget of 0 never defers anything.
+		explicit StepBudget(double seconds = 0);
+		~StepBudget() {}
+		
+		bool Enabled() const { return this->budgetTicks > 0; }
+		double Seconds() const { return this->seconds; }
+		void Seconds(double seconds);
+		
+		void Begin();
+		// True, and counted as applied, when the work would not fit after elapsed ticks
+		// with reserved ticks still to come. Work never measured is assumed to fit.
+		bool Defer(Degradation work, std::uint64_t elapsed, std::uint64_t reserved);
+		void Cost(Degradation work, std::uint64_t ticks) { this->cost[static_cast<int>(work)] = ticks; }
+		std::uint64_t Cost(Degradation work) const { return this->cost[static_cast<int>(work)]; }
+		// Work of a step that nothing defers, averaged over the last steps.
+		std::uint64_t Required() const { return static_cast<std::uint64_t>(this->required); }
+		void Required(std::uint64_t ticks);
+		void End(std::uint64_t ticks);
+		
+		// Degradations of the last step.
+		bool Applied(Degradation degradation) const { return (this->last & 1u << static_cast<int>(degradation)) != 0; }
+		
+		BudgetReport Report() const;
+		void Reset();
+		
+	private:
+		double seconds;
+		double ticksPerSecond;
+		std::uint64_t budgetTicks{0};
+		std::uint64_t cost[static_cast<int>(Degradation::Count)];
+		double required{0};
+		unsigned current{0};
+		unsigned last{0};
+		BudgetReport report;
+	};
+	
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Snapshot.h"
+
+namespace GeometricalSolid {
+	
+	// A checkpoint directory holds a base snapshot, a chain of deltas written against
+	// it and a manifest naming them. Files are complete and synced before the manifest
+	// is replaced, so the manifest always describes a checkpoint that can be restored.
+	namespace Checkpoint {
+		
+		const char manifestName[] = "manifest";
+		const char manifestMagic[] = "LuGaCheckpoint";
+		const std::uint32_t manifestVersion = 1;
+		
+		const char deltaMagic[8] = {'L', 'u', 'G', 'a', 'D', 'e', 'l', 't'};
+		const std::uint32_t deltaVersion = 2;
+		
+		struct Manifest{
+			std::uint64_t sequence{0};	// files written so far, numbers the next one
+			std::uint64_t step{0};
+			double time{0};
+			std::uint64_t solidCount{0};
+			std::string base;
+			std::vector<std::string> deltas;
+		};
+		
+		struct DeltaHeader{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byteOrderMark;
+			std::uint64_t fileSize;
+			std::uint64_t solidCount;
+			std::uint64_t recordCount;
+			std::uint64_t step;
+			double time;
+		};
+		
+		// The integrated state of one solid that changed since the previous checkpoint.
+		// Forces and momentums are recomputed at every step and are not recorded.
+		struct DeltaRecord{
+			std::uint32_t index;
+			std::uint32_t locks;	// as in the Locks column of a snapshot
+			Snapshot::ShapeRecord shape;
+			double origin[3];
+			double orientation[4];
+			double velocity[3];
+			double angularVelocity[3];
+		};
+		
+	}
+	
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	// Restores the checkpoint described by the manifest of a directory: the base
+	// snapshot, then every delta of the chain in order.
+	class CheckpointReader{
+	public:
+		CheckpointReader(const std::string& directory);
+		~CheckpointReader() {}
+		
+		static bool Exists(const std::string& directory);
+		
+		const Checkpoint::Manifest& Manifest() const { return this->manifest; }
+		std::uint64_t Step() const { return this->manifest.step; }
+		double Time() const { return this->manifest.time; }
+		
+		// Replaces the content of solids. The restored solids are clean and without forces
+		// or momentums, which the next step recomputes.
+		void Load(std::vector<Solid>& solids) const;
+		
+	private:
+		void ApplyDelta(const std::string& name, std::vector<Solid>& solids) const;
+		
+		std::string directory;
+		Checkpoint::Manifest manifest;
+	};
+	
+}
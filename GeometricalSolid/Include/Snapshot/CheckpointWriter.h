@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "SnapshotWriter.h"
+
+namespace GeometricalSolid {
+	
+	struct CheckpointOptions{
+		std::size_t maximumDeltas{16};	// deltas after which the next checkpoint is full
+		double fullFraction{0.5};		// dirty fraction above which a delta is not worth it
+	};
+	
+	struct CheckpointStatistics{
+		std::size_t fullCheckpoints{0};
+		std::size_t deltaCheckpoints{0};
+		std::size_t solidsWritten{0};
+		std::uint64_t bytes{0};
+	};
+	
+	// Writes a checkpoint of the solids into a directory: a full snapshot the first
+	// time and whenever the chain gets long, otherwise a delta with the dirty solids
+	// only. Dirty flags are cleared once the checkpoint is committed. An existing
+	// checkpoint in the directory is extended.
+	class CheckpointWriter{
+	public:
+		CheckpointWriter(const std::string& directory, const CheckpointOptions& options = CheckpointOptions());
+		~CheckpointWriter() {}
+		
+		// Returns the number of solids written.
+		std::size_t Write(std::vector<Solid>& solids, std::uint64_t step, double time);
+		
+		const Checkpoint::Manifest& Manifest() const { return this->manifest; }
+		const CheckpointStatistics& Statistics() const { return this->statistics; }
+		
+	private:
+		std::string Path(const std::string& name) const { return this->directory + "/" + name; }
+		std::string NextName(const char* kind, const char* extension) const;
+		std::uint64_t WriteDelta(const std::string& path, const std::vector<Solid>& solids, std::size_t dirtyCount, std::uint64_t step, double time);
+		void Commit(const Checkpoint::Manifest& next);
+		
+		std::string directory;
+		CheckpointOptions options;
+		Checkpoint::Manifest manifest;
+		CheckpointStatistics statistics;
+		SnapshotWriter snapshotWriter;
+		std::vector<Checkpoint::DeltaRecord> records;
+	};
+	
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace GeometricalSolid {
+
+	// Layout of a binary snapshot: a fixed header, a table of distinct shapes, then one
+	// column per field, each starting on a 64 byte boundary. All values are stored in
+	// the byte order of the writer, which the header records.
+	namespace Snapshot {
+
+		const char magic[8] = {'L', 'u', 'G', 'a', 'S', 'n', 'a', 'p'};
+		const std::uint32_t version = 1;
+		const std::uint32_t byteOrderMark = 0x01020304;
+		const std::size_t alignment = 64;
+
+		enum Column{
+			ShapeIndex,		// uint32_t per solid, into the shape table
+			Locks,			// uint8_t per solid, translation x,y,z then rotation x,y,z bits
+			Origin,			// 3 doubles per solid
+			Orientation,	// 4 doubles per solid, real part first
+			Velocity,		// 3 doubles per solid
+			AngularVelocity,// 3 doubles per solid, body frame
+			Force,			// 3 doubles per solid
+			Momentum,		// 3 doubles per solid
+			ColumnCount
+		};
+
+		struct Header{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byteOrderMark;
+			std::uint64_t fileSize;
+			std::uint64_t solidCount;
+			std::uint64_t shapeCount;
+			std::uint64_t step;
+			double time;
+			std::uint64_t shapeTableOffset;
+			std::uint64_t columnOffset[ColumnCount];
+		};
+
+		struct ShapeRecord{
+			std::uint32_t form;
+			std::uint32_t nature;
+			double parameters[4];	// Sphere: radius, density; Disk: radius, thickness, density;
+									// Rectangle: length, width, thickness, density
+		};
+
+		inline std::size_t ComponentSize(Column column) {
+			switch(column){
+				case ShapeIndex: return sizeof(std::uint32_t);
+				case Locks: return sizeof(std::uint8_t);
+				case Orientation: return 4*sizeof(double);
+				default: return 3*sizeof(double);
+			}
+		}
+
+		inline std::uint64_t Align(std::uint64_t offset) {
+			return (offset + alignment - 1)/alignment*alignment;
+		}
+
+	}
+
+}
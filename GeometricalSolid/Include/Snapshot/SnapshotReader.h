@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Snapshot.h"
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	// Maps a binary snapshot read-only and exposes its columns without copying them.
+	class SnapshotReader{
+	public:
+		SnapshotReader(const std::string& path);
+		~SnapshotReader();
+		
+		SnapshotReader(const SnapshotReader& other) = delete;
+		SnapshotReader& operator=(const SnapshotReader& other) = delete;
+		
+		std::size_t SolidCount() const { return this->header->solidCount; }
+		std::size_t ShapeCount() const { return this->header->shapeCount; }
+		std::uint64_t Step() const { return this->header->step; }
+		double Time() const { return this->header->time; }
+		
+		const Snapshot::ShapeRecord* Shapes() const { return reinterpret_cast<const Snapshot::ShapeRecord*>(this->data + this->header->shapeTableOffset); }
+		const std::uint32_t* ShapeIndices() const { return this->ColumnData<std::uint32_t>(Snapshot::ShapeIndex); }
+		const std::uint8_t* Locks() const { return this->ColumnData<std::uint8_t>(Snapshot::Locks); }
+		
+		// Interleaved components: solid i starts at 3*i (4*i for orientations).
+		const double* Origins() const { return this->ColumnData<double>(Snapshot::Origin); }
+		const double* Orientations() const { return this->ColumnData<double>(Snapshot::Orientation); }
+		const double* Velocities() const { return this->ColumnData<double>(Snapshot::Velocity); }
+		const double* AngularVelocities() const { return this->ColumnData<double>(Snapshot::AngularVelocity); }
+		const double* Forces() const { return this->ColumnData<double>(Snapshot::Force); }
+		const double* Momentums() const { return this->ColumnData<double>(Snapshot::Momentum); }
+		
+		std::unique_ptr<GeometricalSolid::Shape> MakeShape(std::size_t shape) const;
+		static std::unique_ptr<GeometricalSolid::Shape> MakeShape(const Snapshot::ShapeRecord& record);
+		void Restore(std::size_t index, Solid& solid) const;
+		
+		// Replaces the content of solids with the solids of the snapshot.
+		void Load(std::vector<Solid>& solids) const;
+		
+	private:
+		template<class T>
+		const T* ColumnData(Snapshot::Column column) const {
+			return reinterpret_cast<const T*>(this->data + this->header->columnOffset[column]);
+		}
+		
+		void Validate(const std::string& path) const;
+		
+		const char* data{nullptr};
+		std::size_t size{0};
+		const Snapshot::Header* header{nullptr};
+	};
+	
+}
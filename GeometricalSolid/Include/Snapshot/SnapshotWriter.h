@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Snapshot.h"
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	// Writes the state of all solids as a binary snapshot (see Snapshot.h).
+	class SnapshotWriter{
+	public:
+		SnapshotWriter() {}
+		~SnapshotWriter() {}
+		
+		void Write(const std::string& path, const std::vector<Solid>& solids, std::uint64_t step = 0, double time = 0);
+		void Write(std::ostream& out, const std::vector<Solid>& solids, std::uint64_t step = 0, double time = 0);
+		
+		static Snapshot::ShapeRecord Record(const GeometricalSolid::Shape& shape);
+		static std::uint8_t Locks(const Solid& solid);
+		
+	private:
+		void BuildShapeTable(const std::vector<Solid>& solids);
+		void WriteColumn(std::ostream& out, const std::vector<Solid>& solids, Snapshot::Column column);
+		
+		std::vector<Snapshot::ShapeRecord> shapes;
+		std::vector<std::uint32_t> shapeIndices;
+		std::vector<char> buffer;
+	};
+	
+}
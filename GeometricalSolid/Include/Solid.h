@@ -1,9 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <Basis.h>
 #include <Vector.h>
 #include <Matrix.h>
-#include <memory.h>
+#include <PeriodicBox.h>
 
 #include "Shape.h"
 
@@ -44,19 +45,28 @@ namespace GeometricalSolid{
 		
 		void UpdateVelocities(double dt);
 		void UpdatePosition(double dt);
+		void UpdatePosition(double dt, const GeometricalSpaceObjects::PeriodicBox<double>& domain);
 		
 		void ResetForceAndMomemtum();
 		
 		void LockTranslation(bool xAxis, bool yAxis, bool zAxis);
 		void LockRotation(bool xAxis, bool yAxis, bool zAxis);
 
-		bool IsXTranslationLocked();
-		bool IsYTranslationLocked();
-		bool IsZTranslationLocked();
+		bool IsXTranslationLocked() const;
+		bool IsYTranslationLocked() const;
+		bool IsZTranslationLocked() const;
 		
-		bool IsXRotationLocked();
-		bool IsYRotationLocked();
-		bool IsZRotationLocked();
+		bool IsXRotationLocked() const;
+		bool IsYRotationLocked() const;
+		bool IsZRotationLocked() const;
+		
+		// Set whenever the integrated state (basis, velocities, locks, shape) changes, so
+		// that checkpoints only write the solids that moved since the previous one.
+		// Forces and momentums, recomputed at every step, leave it alone. Solids moved
+		// to another index of their vector must be marked: deltas are by index.
+		bool IsDirty() const;
+		void MarkDirty();
+		void ClearDirty();
 		
 	private:
 		GeometricalSpaceObjects::Basis<double> basis;
@@ -65,6 +75,7 @@ namespace GeometricalSolid{
 		GeometricalSpaceObjects::Vector<int> lockVelocity;
 		GeometricalSpaceObjects::Vector<int> lockAngularVelocity;
 		std::unique_ptr<GeometricalSolid::Shape> shape;
+		bool dirty;
 	};
 }
 
@@ -20,11 +20,13 @@ namespace GeometricalSolid{
 		double Radius() const { return this->radius; }
 		double Density() const { return this->density; }
 		double Volume() const { return this->volume; }
+		virtual std::size_t MemoryFootprint() const { return sizeof(Sphere); }
 		
 	private:
 		void init() {
 			this->nature = Shape::Nature::Particle;
 			this->form = Shape::Form::Sphere;
+			this->boundingRadius = this->radius;
 			this->volume = 4./3.*M_PI*radius*radius*radius;
 			this->mass = this->volume*this->density;
 			this->inertia.Element(0, 0, 2./5.*this->mass*this->radius*this->radius);
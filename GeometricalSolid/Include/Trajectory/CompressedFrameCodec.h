@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "FrameEncoder.h"
+#include "LzCompressor.h"
+#include "TrajectoryFrame.h"
+
+namespace GeometricalSolid {
+	
+	struct CompressedFrameOptions{
+		GeometricalSpaceObjects::PeriodicBox<double> domain;
+		double positionTolerance{1e-6};	// relative to the largest domain length
+		int orientationBits{16};		// per smallest-three component, at most 30
+		double velocityTolerance{0};	// absolute, 0 leaves velocities out
+		std::size_t keyframeInterval{64};
+	};
+	
+	// A compressed frame is a CompressedFrameHeader followed by the LZ compressed
+	// payload: zigzag varints of the quantized values, field after field, as deltas
+	// against the previous frame (against zero in keyframes).
+	// Forces and momentums are not encoded: decoded frames hold zeros for them, as
+	// for velocities when velocityTolerance is 0. Use the LuGa encoder to keep them.
+	struct CompressedFrameHeader{
+		std::uint32_t magic;
+		std::uint16_t flags;
+		std::uint16_t orientationBits;
+		std::uint64_t step;
+		double time;
+		std::uint64_t solidCount;
+		double lower[3];
+		double positionQuantum;
+		double velocityQuantum;
+		std::uint64_t rawSize;
+		std::uint64_t compressedSize;
+		
+		static const std::uint32_t magicNumber = 0x4643474c;	// "LGCF"
+		static const std::uint16_t keyframe = 1;
+		static const std::uint16_t velocities = 2;
+	};
+	
+	// Quantization shared by the encoder and the decoder. Positions are rounded to a
+	// grid anchored on the domain lower corner; orientations drop their largest
+	// component, whose index and sign are implied, and keep the other three.
+	class FrameQuantizer{
+	public:
+		static std::size_t FieldCount(bool velocities) { return velocities ? 13 : 7; }
+		
+		static void Quantize(const TrajectoryFrame& frame, const CompressedFrameHeader& header, std::vector<std::int64_t>& values);
+		static void Restore(const std::vector<std::int64_t>& values, const CompressedFrameHeader& header, TrajectoryFrame& frame);
+	};
+	
+	class CompressedFrameEncoder: public FrameEncoder{
+	public:
+		CompressedFrameEncoder(const CompressedFrameOptions& options);
+		~CompressedFrameEncoder(){}
+		
+		virtual void Encode(const TrajectoryFrame& frame, std::string& bytes);
+		
+		// Starts the next frame with a keyframe.
+		void Reset() { this->framesSinceKeyframe = 0; this->previous.clear(); }
+		
+	private:
+		CompressedFrameOptions options;
+		double positionQuantum;
+		std::size_t framesSinceKeyframe{0};
+		std::vector<std::int64_t> previous;
+		std::vector<std::int64_t> current;
+		std::string raw;
+		LzCompressor compressor;
+	};
+	
+	// Reads a file of compressed frames. Opening scans the frame headers only; reading
+	// frame i decodes forward from the closest keyframe, or from the last frame read
+	// when that is closer.
+	class CompressedTrajectoryReader{
+	public:
+		CompressedTrajectoryReader(const std::string& path);
+		~CompressedTrajectoryReader() {}
+		
+		std::size_t FrameCount() const { return this->frames.size(); }
+		std::size_t KeyframeCount() const;
+		std::uint64_t Step(std::size_t frame) const { return this->frames[frame].step; }
+		
+		void Read(std::size_t frame, TrajectoryFrame& out);
+		
+	private:
+		struct Entry{
+			std::uint64_t offset;
+			std::uint64_t step;
+			std::size_t keyframe;	// index of the keyframe this frame depends on
+		};
+		
+		void Decode(std::size_t frame);
+		
+		std::ifstream in;
+		std::vector<Entry> frames;
+		std::size_t decoded;
+		std::vector<std::int64_t> values;
+		std::string compressed;
+		std::string raw;
+		CompressedFrameHeader header;
+	};
+	
+}
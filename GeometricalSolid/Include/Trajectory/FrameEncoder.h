@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+#include "TrajectoryFrame.h"
+
+namespace GeometricalSolid {
+	
+	class FrameEncoder{
+	public:
+		virtual ~FrameEncoder() {}
+		// Appends the encoded frame to bytes.
+		virtual void Encode(const TrajectoryFrame& frame, std::string& bytes) = 0;
+		
+	};
+	
+	// Same text as LuGaSolidFormatter, one solid after the other.
+	class LuGaFrameEncoder: public FrameEncoder{
+	public:
+		LuGaFrameEncoder(){}
+		~LuGaFrameEncoder(){}
+		
+		virtual void Encode(const TrajectoryFrame& frame, std::string& bytes);
+	};
+	
+	// Step, time and solid count, then the raw columns.
+	class BinaryFrameEncoder: public FrameEncoder{
+	public:
+		BinaryFrameEncoder(){}
+		~BinaryFrameEncoder(){}
+		
+		virtual void Encode(const TrajectoryFrame& frame, std::string& bytes);
+	};
+	
+}
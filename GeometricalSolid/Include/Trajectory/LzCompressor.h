@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace GeometricalSolid {
+	
+	// Byte-oriented LZ77 in sequences of literals followed by a match: a token holding
+	// both lengths in nibbles (15 continues in bytes of 255), the literals, then a 16 bit
+	// offset. The last sequence has no match.
+	class LzCompressor{
+	public:
+		LzCompressor():table(1 << hashBits) {}
+		~LzCompressor() {}
+		
+		// Appends the compressed bytes.
+		void Compress(const char* data, std::size_t size, std::string& compressed);
+		// Throws when the input is not exactly rawSize bytes once decompressed.
+		static void Decompress(const char* compressed, std::size_t size, char* data, std::size_t rawSize);
+		
+	private:
+		static const int hashBits = 14;
+		static const std::size_t minimumMatch = 4;
+		static const std::size_t maximumOffset = 65535;
+		
+		std::vector<std::uint32_t> table;
+	};
+	
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Solid.h"
+
+namespace GeometricalSolid {
+	
+	// Copy of the kinematic state of all solids at one output step, in columns with
+	// interleaved components (3 per solid, 4 for orientations). Capturing into a frame
+	// that already held as many solids does not allocate.
+	struct TrajectoryFrame{
+		std::uint64_t step{0};
+		double time{0};
+		std::vector<double> origins;
+		std::vector<double> orientations;
+		std::vector<double> velocities;
+		std::vector<double> angularVelocities;
+		std::vector<double> forces;
+		std::vector<double> momentums;
+		
+		std::size_t SolidCount() const { return this->origins.size()/3; }
+		
+		void Capture(const std::vector<Solid>& solids, std::uint64_t step, double time);
+	};
+	
+}
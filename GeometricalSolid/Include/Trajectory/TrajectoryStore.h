@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "TrajectoryFrame.h"
+
+namespace GeometricalSolid {
+	
+	// Layout of a columnar trajectory store: a header, then tiles of framesPerChunk
+	// frames by solidsPerChunk solids of one column, then a footer with the step and
+	// time of every frame and the offset of every tile, then a trailer locating the
+	// footer. Inside a tile the values of one solid are contiguous, frame after frame,
+	// so a time series is read with one seek per tile and a frame with one per solid
+	// range. Tiles of the last frame block hold only the frames written.
+	namespace TrajectoryStore {
+		
+		const char magic[8] = {'L', 'u', 'G', 'a', 'T', 'r', 'a', 'j'};
+		const std::uint32_t version = 1;
+		const std::uint32_t byteOrderMark = 0x01020304;
+		const std::size_t alignment = 64;
+		
+		enum Column{
+			Origin,
+			Orientation,
+			Velocity,
+			AngularVelocity,
+			Force,
+			Momentum,
+			ColumnCount
+		};
+		
+		struct Header{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byteOrderMark;
+			std::uint64_t solidCount;
+			std::uint64_t framesPerChunk;
+			std::uint64_t solidsPerChunk;
+			std::uint64_t columnMask;
+		};
+		
+		struct FrameEntry{
+			std::uint64_t step;
+			double time;
+		};
+		
+		// Footer: frameCount FrameEntry, then one offset per tile ordered by frame
+		// block, solid block and column; columns left out have offset 0.
+		struct Trailer{
+			std::uint64_t footerOffset;
+			std::uint64_t frameCount;
+			char magic[8];
+		};
+		
+		inline std::size_t ComponentCount(Column column) { return column == Orientation ? 4 : 3; }
+		
+		inline std::uint64_t Align(std::uint64_t offset) {
+			return (offset + alignment - 1)/alignment*alignment;
+		}
+		
+		inline std::vector<double>& Values(TrajectoryFrame& frame, Column column) {
+			switch(column){
+				case Origin: return frame.origins;
+				case Orientation: return frame.orientations;
+				case Velocity: return frame.velocities;
+				case AngularVelocity: return frame.angularVelocities;
+				case Force: return frame.forces;
+				default: return frame.momentums;
+			}
+		}
+		
+		inline const std::vector<double>& Values(const TrajectoryFrame& frame, Column column) {
+			return Values(const_cast<TrajectoryFrame&>(frame), column);
+		}
+		
+	}
+	
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+#include "TrajectoryStore.h"
+
+namespace GeometricalSolid {
+	
+	// Maps a columnar trajectory store read-only. Every value is located from the tile
+	// index in constant time, without reading anything else.
+	class TrajectoryStoreReader{
+	public:
+		TrajectoryStoreReader(const std::string& path);
+		~TrajectoryStoreReader();
+		
+		TrajectoryStoreReader(const TrajectoryStoreReader& other) = delete;
+		TrajectoryStoreReader& operator=(const TrajectoryStoreReader& other) = delete;
+		
+		std::size_t FrameCount() const { return this->trailer->frameCount; }
+		std::size_t SolidCount() const { return this->header->solidCount; }
+		bool HasColumn(TrajectoryStore::Column column) const { return (this->header->columnMask >> column) & 1; }
+		std::uint64_t Step(std::size_t frame) const { return this->frames[frame].step; }
+		double Time(std::size_t frame) const { return this->frames[frame].time; }
+		
+		// Components of one solid at one frame, inside the mapping.
+		const double* Value(TrajectoryStore::Column column, std::size_t frame, std::size_t solid) const;
+		
+		// Components of solid over frames [first, first + count), interleaved.
+		void Series(TrajectoryStore::Column column, std::size_t solid, std::size_t first, std::size_t count, double* values) const;
+		
+		// Every stored column of one frame; columns left out come back empty.
+		void Read(std::size_t frame, TrajectoryFrame& out) const;
+		
+	private:
+		const double* Tile(TrajectoryStore::Column column, std::size_t frameBlock, std::size_t solidBlock) const;
+		void Validate(const std::string& path);
+		
+		const char* data{nullptr};
+		std::size_t size{0};
+		const TrajectoryStore::Header* header{nullptr};
+		const TrajectoryStore::Trailer* trailer{nullptr};
+		const TrajectoryStore::FrameEntry* frames{nullptr};
+		const std::uint64_t* offsets{nullptr};
+		std::size_t solidBlocks{0};
+	};
+	
+}
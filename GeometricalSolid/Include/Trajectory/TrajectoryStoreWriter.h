@@ -0,0 +1,53 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "TrajectoryStore.h"
+
+namespace GeometricalSolid {
+	
+	struct TrajectoryStoreOptions{
+		std::size_t framesPerChunk{16};
+		std::size_t solidsPerChunk{4096};
+		std::uint64_t columnMask{(1 << TrajectoryStore::ColumnCount) - 1};	// bit per TrajectoryStore::Column
+	};
+	
+	// Appends frames to a columnar trajectory store (see TrajectoryStore.h). A block of
+	// framesPerChunk frames is held in memory and written as tiles once complete; the
+	// footer is written by Close, without which the file cannot be read.
+	class TrajectoryStoreWriter{
+	public:
+		TrajectoryStoreWriter(const std::string& path, std::size_t solidCount, const TrajectoryStoreOptions& options = TrajectoryStoreOptions());
+		~TrajectoryStoreWriter();
+		
+		TrajectoryStoreWriter(const TrajectoryStoreWriter& other) = delete;
+		TrajectoryStoreWriter& operator=(const TrajectoryStoreWriter& other) = delete;
+		
+		void Append(const TrajectoryFrame& frame);
+		void Append(const std::vector<Solid>& solids, std::uint64_t step, double time);
+		void Close();
+		
+		std::size_t FrameCount() const { return this->frames.size(); }
+		
+	private:
+		bool Stored(TrajectoryStore::Column column) const { return (this->options.columnMask >> column) & 1; }
+		void WriteBlock();
+		void Pad();
+		
+		std::string path;
+		std::ofstream out;
+		std::size_t solidCount;
+		TrajectoryStoreOptions options;
+		std::uint64_t position{0};
+		std::vector<TrajectoryStore::FrameEntry> frames;
+		std::vector<std::uint64_t> offsets;
+		std::vector<double> block[TrajectoryStore::ColumnCount];	// buffered frames, frame-major
+		std::size_t blockFrames{0};
+		std::vector<double> tile;
+		TrajectoryFrame captured;
+		bool closed{false};
+	};
+	
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameEncoder.h"
+#include "TrajectoryFrame.h"
+
+namespace GeometricalSolid {
+	
+	struct TrajectoryWriterOptions{
+		enum class Backpressure{
+			Block,	// Capture waits for a free buffer
+			Drop	// Capture skips the frame
+		};
+		
+		std::size_t buffers{2};
+		Backpressure backpressure{Backpressure::Block};
+	};
+	
+	struct TrajectoryWriterStatistics{
+		std::size_t captured;
+		std::size_t written;
+		std::size_t dropped;
+		std::size_t bytes;
+		double stallSeconds;
+	};
+	
+	// Copies the state into recycled frame buffers on the stepping thread; a background
+	// thread encodes and writes them in order. Capture only waits when every buffer is
+	// queued and the backpressure is Block. Errors of the background thread are thrown
+	// by the next Capture or Flush.
+	class TrajectoryWriter{
+	public:
+		TrajectoryWriter(const std::string& path, std::unique_ptr<FrameEncoder> encoder, const TrajectoryWriterOptions& options = TrajectoryWriterOptions());
+		TrajectoryWriter(std::ostream& out, std::unique_ptr<FrameEncoder> encoder, const TrajectoryWriterOptions& options = TrajectoryWriterOptions());
+		~TrajectoryWriter();
+		
+		TrajectoryWriter(const TrajectoryWriter& other) = delete;
+		TrajectoryWriter& operator=(const TrajectoryWriter& other) = delete;
+		
+		// Returns false when the frame was dropped.
+		bool Capture(const std::vector<Solid>& solids, std::uint64_t step, double time);
+		// Waits until every captured frame is written and the stream flushed.
+		void Flush();
+		
+		TrajectoryWriterStatistics Statistics() const;
+		
+	private:
+		void Start();
+		void WriterLoop();
+		void RethrowError();
+		
+		std::unique_ptr<std::ofstream> file;
+		std::ostream& out;
+		std::unique_ptr<FrameEncoder> encoder;
+		TrajectoryWriterOptions options;
+		
+		std::vector<TrajectoryFrame> frames;
+		std::vector<std::size_t> freeFrames;
+		std::vector<std::size_t> queue;	// ring of frame indices, oldest at queueHead
+		std::size_t queueHead{0};
+		std::size_t queueSize{0};
+		bool writing{false};
+		bool stopping{false};
+		std::exception_ptr error;
+		
+		mutable std::mutex mutex;
+		std::condition_variable frameQueued;
+		std::condition_variable frameReleased;
+		std::thread writer;
+		
+		std::size_t captured{0};
+		std::size_t written{0};
+		std::size_t dropped{0};
+		std::size_t bytes{0};
+		double stallSeconds{0};
+	};
+	
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TrajectoryFrame.h"
+
+namespace GeometricalSolid {
+
+	// Numbers the distinct shapes in order of appearance, so that ids stay the same
+	// from one frame to the next. Solids without shape get -1.
+	class VtkShapeTable{
+	public:
+		std::int32_t Id(const GeometricalSolid::Shape* shape);
+		std::size_t Size() const { return this->keys.size(); }
+
+	private:
+		struct Key{
+			int form;
+			int nature;
+			double boundingRadius;
+			double mass;
+		};
+
+		std::vector<Key> keys;
+		std::size_t last{0};
+	};
+
+	// State of one frame with the shape columns of the VTK files.
+	struct VtkFrame{
+		TrajectoryFrame state;
+		std::vector<std::int32_t> shapeIds;
+		std::vector<double> radii;
+
+		void Capture(const std::vector<Solid>& solids, VtkShapeTable& shapes, std::uint64_t step, double time);
+	};
+
+	struct VtkWriterOptions{
+		enum class Format{
+			Xml,	// .vtp with raw appended data
+			Legacy	// .vtk, binary big endian
+		};
+
+		Format format{Format::Xml};
+		std::size_t bufferSize{1 << 16};
+	};
+
+	// Writes solids as VTK PolyData with one vertex per solid: origins are the points,
+	// and orientation, velocity, angular velocity, bounding radius and shape id the
+	// point data. Each array is converted through a fixed buffer straight from the
+	// solids, so the dataset is never held in memory.
+	class VtkWriter{
+	public:
+		VtkWriter(const VtkWriterOptions& options = VtkWriterOptions());
+		~VtkWriter() {}
+
+		void Write(const std::string& path, const std::vector<Solid>& solids, std::uint64_t step = 0, double time = 0);
+		void Write(std::ostream& out, const std::vector<Solid>& solids, std::uint64_t step = 0, double time = 0);
+		void Write(const std::string& path, const VtkFrame& frame);
+		void Write(std::ostream& out, const VtkFrame& frame);
+
+		const char* Extension() const;
+
+	private:
+		template<class Source>
+		void WriteFile(const std::string& path, const Source& source);
+		template<class Source>
+		void WriteXml(std::ostream& out, const Source& source);
+		template<class Source>
+		void WriteLegacy(std::ostream& out, const Source& source);
+		template<class T, class Fill>
+		void WriteArray(std::ostream& out, std::size_t count, int components, bool bigEndian, const Fill& fill);
+
+		VtkWriterOptions options;
+		VtkShapeTable shapes;
+		std::vector<char> buffer;
+	};
+
+	struct VtkSeriesOptions{
+		VtkWriterOptions vtk;
+		std::size_t threads{2};
+		std::size_t buffers{4};
+	};
+
+	// Writes one file per captured frame, <prefix>_<step>.vtp or .vtk, on several
+	// background threads, and keeps <prefix>.pvd listing the frames with their time
+	// for ParaView. Capture copies the state and waits only when every buffer is
+	// queued; errors of the writer threads are thrown by the next Capture or Flush.
+	class VtkSeriesWriter{
+	public:
+		VtkSeriesWriter(const std::string& prefix, const VtkSeriesOptions& options = VtkSeriesOptions());
+		~VtkSeriesWriter();
+
+		VtkSeriesWriter(const VtkSeriesWriter& other) = delete;
+		VtkSeriesWriter& operator=(const VtkSeriesWriter& other) = delete;
+
+		void Capture(const std::vector<Solid>& solids, std::uint64_t step, double time);
+		// Waits until every captured frame is written, then rewrites the collection.
+		void Flush();
+
+		std::size_t Written() const;
+
+	private:
+		struct Entry{
+			std::uint64_t step;
+			double time;
+			std::string file;
+		};
+
+		std::string FileName(std::uint64_t step) const;
+		void WriterLoop();
+		void WriteCollection();
+		void RethrowError();
+
+		std::string prefix;
+		VtkSeriesOptions options;
+		VtkShapeTable shapes;
+
+		std::vector<VtkFrame> frames;
+		std::vector<std::size_t> freeFrames;
+		std::vector<std::size_t> queue;
+		std::size_t writing{0};
+		bool stopping{false};
+		std::exception_ptr error;
+		std::vector<Entry> entries;
+
+		mutable std::mutex mutex;
+		std::condition_variable frameQueued;
+		std::condition_variable frameReleased;
+		std::vector<std::thread> writers;
+	};
+
+}
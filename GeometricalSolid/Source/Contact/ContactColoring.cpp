@@ -0,0 +1,180 @@
+#include <algorithm>
+#include "../../Include/Contact/ContactColoring.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	const std::uint32_t uncolored = ~static_cast<std::uint32_t>(0);
+	
+	std::uint32_t Priority(std::uint32_t pair) {
+		std::uint32_t x = pair*0x9e3779b9u;
+		x ^= x >> 16;
+		x *= 0x85ebca6bu;
+		x ^= x >> 13;
+		return x;
+	}
+	
+	// Ties on the hashed priority are broken by the pair index.
+	bool Precedes(std::uint32_t a, std::uint32_t b) {
+		std::uint32_t priorityA = Priority(a), priorityB = Priority(b);
+		return priorityA != priorityB ? priorityA > priorityB : a > b;
+	}
+	
+	std::uint32_t FirstFreeColor(const std::uint64_t* first, const std::uint64_t* second, std::size_t words) {
+		for(std::size_t word = 0 ; word < words ; ++word){
+			std::uint64_t free = ~(first[word] | second[word]);
+			if(free != 0)
+				return static_cast<std::uint32_t>(64*word + __builtin_ctzll(free));
+		}
+		return static_cast<std::uint32_t>(64*words);
+	}
+}
+
+std::size_t ContactColoring::MemoryFootprint() const {
+	return (this->candidates.capacity() + this->coloredPairs.capacity())*sizeof(ContactPair)
+	+ (this->colors.capacity() + this->solidStart.capacity() + this->solidPairs.capacity() + this->pending.capacity())*sizeof(std::uint32_t)
+	+ this->usedColors.capacity()*sizeof(std::uint64_t) + this->batchStart.capacity()*sizeof(std::size_t) + this->selected.capacity();
+}
+
+void ContactColoring::Color(const std::vector<ContactPair>& pairs, std::size_t solidCount) {
+	// One 64 bit word of used colors per solid, widened when a solid runs out of colors.
+	std::size_t words = 1;
+	this->usedColors.assign(solidCount*words, 0);
+	this->colors.resize(pairs.size());
+	for(std::size_t p = 0 ; p < pairs.size() ; ++p){
+		std::uint64_t* first = &this->usedColors[pairs[p].first*words];
+		std::uint64_t* second = &this->usedColors[pairs[p].second*words];
+		std::uint32_t color = FirstFreeColor(first, second, words);
+		if(color == 64*words){
+			std::vector<std::uint64_t> widened(solidCount*(words + 1), 0);
+			for(std::size_t solid = 0 ; solid < solidCount ; ++solid)
+				std::copy(&this->usedColors[solid*words], &this->usedColors[solid*words] + words, &widened[solid*(words + 1)]);
+			this->usedColors.swap(widened);
+			++words;
+			first = &this->usedColors[pairs[p].first*words];
+			second = &this->usedColors[pairs[p].second*words];
+		}
+		first[color/64] |= static_cast<std::uint64_t>(1) << (color % 64);
+		second[color/64] |= static_cast<std::uint64_t>(1) << (color % 64);
+		this->colors[p] = color;
+	}
+	this->rounds = 1;
+	this->Sort(pairs);
+}
+
+void ContactColoring::Color(const VerletList& neighbors) {
+	this->candidates.clear();
+	for(std::uint32_t i = 0 ; i < neighbors.SolidCount() ; ++i)
+		for(const std::uint32_t* j = neighbors.Begin(i) ; j != neighbors.End(i) ; ++j)
+			this->candidates.push_back(ContactPair{i, *j});
+	this->Color(this->candidates, neighbors.SolidCount());
+}
+
+void ContactColoring::ColorParallel(const std::vector<ContactPair>& pairs, std::size_t solidCount, ThreadPool& pool) {
+	std::size_t count = pairs.size();
+	
+	// Pairs touching each solid, in compressed sparse rows.
+	this->solidStart.assign(solidCount + 1, 0);
+	for(const auto& pair : pairs){
+		++this->solidStart[pair.first + 1];
+		++this->solidStart[pair.second + 1];
+	}
+	for(std::size_t solid = 0 ; solid < solidCount ; ++solid)
+		this->solidStart[solid + 1] += this->solidStart[solid];
+	this->solidPairs.resize(2*count);
+	for(std::uint32_t p = 0 ; p < count ; ++p){
+		this->solidPairs[this->solidStart[pairs[p].first]++] = p;
+		this->solidPairs[this->solidStart[pairs[p].second]++] = p;
+	}
+	for(std::size_t solid = solidCount ; solid > 0 ; --solid)
+		this->solidStart[solid] = this->solidStart[solid - 1];
+	this->solidStart[0] = 0;
+	
+	this->colors.assign(count, uncolored);
+	this->selected.assign(count, 0);
+	std::vector<std::uint32_t>& colors = this->colors;
+	std::vector<std::uint8_t>& selected = this->selected;
+	const std::vector<std::uint32_t>& solidStart = this->solidStart;
+	const std::vector<std::uint32_t>& solidPairs = this->solidPairs;
+	std::vector<std::uint32_t>& pending = this->pending;
+	pending.resize(count);
+	for(std::uint32_t p = 0 ; p < count ; ++p)
+		pending[p] = p;
+	
+	// Two passes per round: selection only reads the colors, coloring only writes the
+	// colors of selected pairs, and two selected pairs never share a solid.
+	this->rounds = 0;
+	while(!pending.empty()){
+		pool.ParallelFor(pending.size(), [&](std::size_t begin, std::size_t end, std::size_t){
+			for(std::size_t i = begin ; i < end ; ++i){
+				std::uint32_t p = pending[i];
+				bool highest = true;
+				std::uint32_t solids[2] = {pairs[p].first, pairs[p].second};
+				for(int s = 0 ; s < 2 && highest ; ++s){
+					for(std::uint32_t k = solidStart[solids[s]] ; k < solidStart[solids[s] + 1] ; ++k){
+						std::uint32_t q = solidPairs[k];
+						if(q != p && colors[q] == uncolored && Precedes(q, p)){
+							highest = false;
+							break;
+						}
+					}
+				}
+				selected[p] = highest;
+			}
+		});
+		pool.ParallelFor(pending.size(), [&](std::size_t begin, std::size_t end, std::size_t){
+			std::uint64_t used[4];
+			for(std::size_t i = begin ; i < end ; ++i){
+				std::uint32_t p = pending[i];
+				if(!selected[p])
+					continue;
+				selected[p] = 0;
+				// Smallest color missing among the colored neighbors, found 256 at a time.
+				std::uint32_t solids[2] = {pairs[p].first, pairs[p].second};
+				for(std::uint32_t base = 0 ; ; base += 256){
+					used[0] = used[1] = used[2] = used[3] = 0;
+					for(int s = 0 ; s < 2 ; ++s){
+						for(std::uint32_t k = solidStart[solids[s]] ; k < solidStart[solids[s] + 1] ; ++k){
+							std::uint32_t color = colors[solidPairs[k]];
+							if(color != uncolored && color >= base && color < base + 256)
+								used[(color - base)/64] |= static_cast<std::uint64_t>(1) << ((color - base) % 64);
+						}
+					}
+					std::uint32_t color = 256;
+					for(int word = 0 ; word < 4 && color == 256 ; ++word)
+						if(~used[word] != 0)
+							color = 64*word + __builtin_ctzll(~used[word]);
+					if(color < 256){
+						colors[p] = base + color;
+						break;
+					}
+				}
+			}
+		});
+		std::size_t kept = 0;
+		for(auto p : pending)
+			if(colors[p] == uncolored)
+				pending[kept++] = p;
+		pending.resize(kept);
+		++this->rounds;
+	}
+	this->Sort(pairs);
+}
+
+void ContactColoring::Sort(const std::vector<ContactPair>& pairs) {
+	std::uint32_t colorCount = 0;
+	for(auto color : this->colors)
+		colorCount = std::max(colorCount, color + 1);
+	this->batchStart.assign(colorCount + 1, 0);
+	for(auto color : this->colors)
+		++this->batchStart[color + 1];
+	for(std::size_t color = 0 ; color < colorCount ; ++color)
+		this->batchStart[color + 1] += this->batchStart[color];
+	
+	this->coloredPairs.resize(pairs.size());
+	for(std::size_t p = 0 ; p < pairs.size() ; ++p)
+		this->coloredPairs[this->batchStart[this->colors[p]]++] = pairs[p];
+	for(std::size_t color = colorCount ; color > 0 ; --color)
+		this->batchStart[color] = this->batchStart[color - 1];
+	this->batchStart[0] = 0;
+}
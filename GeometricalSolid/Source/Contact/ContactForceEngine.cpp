@@ -0,0 +1,137 @@
+#include "../../Include/Contact/ContactForceEngine.h"
+#include "../../Include/Contact/ContactColoring.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+ContactForceEngine::ContactForceEngine(std::unique_ptr<ContactForceModel> model, std::size_t expectedContacts):model(std::move(model)), history(expectedContacts) {}
+
+ContactForceEngine::~ContactForceEngine() {}
+
+double ContactForceEngine::Radius(const Solid& solid) {
+	const GeometricalSolid::Shape* shape = solid.Shape();
+	return shape == nullptr ? 0 : shape->BoundingRadius();
+}
+
+void ContactForceEngine::Apply(std::vector<Solid>& solids, const std::vector<ContactPair>& pairs, double dt) {
+	++this->step;
+	for(const auto& pair : pairs)
+		this->ApplyPair(solids[pair.first], solids[pair.second], pair.first, pair.second, dt);
+	this->history.EvictStale(this->step);
+}
+
+void ContactForceEngine::Apply(std::vector<Solid>& solids, const VerletList& neighbors, double dt) {
+	++this->step;
+	for(std::uint32_t i = 0 ; i < neighbors.SolidCount() ; ++i){
+		for(const std::uint32_t* j = neighbors.Begin(i) ; j != neighbors.End(i) ; ++j)
+			this->ApplyPair(solids[i], solids[*j], i, *j, dt);
+	}
+	this->history.EvictStale(this->step);
+}
+
+void ContactForceEngine::Apply(std::vector<Solid>& solids, const ContactColoring& coloring, ThreadPool& pool, double dt) {
+	this->Prepare(solids, coloring.Pairs());
+	const std::vector<ContactPair>& pairs = coloring.Pairs();
+	for(std::size_t color = 0 ; color < coloring.ColorCount() ; ++color){
+		std::size_t batchBegin = coloring.BatchBegin(color);
+		pool.ParallelFor(coloring.BatchEnd(color) - batchBegin, [&](std::size_t begin, std::size_t end, std::size_t){
+			ContactForces forces;
+			for(std::size_t p = batchBegin + begin ; p < batchBegin + end ; ++p){
+				Solid& first = solids[pairs[p].first];
+				Solid& second = solids[pairs[p].second];
+				if(!this->Evaluate(first, second, pairs[p].first, pairs[p].second, dt, forces))
+					continue;
+				first.AddForce(forces.force);
+				second.AddForce(forces.force*(-1.));
+				first.AddMomentum(forces.firstMomentum);
+				second.AddMomentum(forces.secondMomentum);
+			}
+		});
+	}
+	this->EndStep();
+}
+
+void ContactForceEngine::Prepare(const std::vector<Solid>& solids, const std::vector<ContactPair>& pairs) {
+	++this->step;
+	ContactGeometry geometry;
+	bool inserted;
+	for(const auto& pair : pairs){
+		if(this->Touching(solids[pair.first], solids[pair.second], geometry))
+			this->history.FindOrInsert(this->Key(pair.first, pair.second), this->step, inserted);
+	}
+}
+
+bool ContactForceEngine::Evaluate(const Solid& first, const Solid& second, std::uint32_t firstIndex, std::uint32_t secondIndex, double dt, ContactForces& forces) {
+	ContactGeometry geometry;
+	if(!this->Touching(first, second, geometry))
+		return false;
+	ContactHistory::Entry* entry = this->history.Find(this->Key(firstIndex, secondIndex));
+	if(entry == nullptr)
+		return false;
+	this->ComputeOriented(first, second, firstIndex, secondIndex, geometry, *entry, dt, forces);
+	return true;
+}
+
+bool ContactForceEngine::Touching(const Solid& first, const Solid& second, ContactGeometry& geometry) const {
+	geometry.firstRadius = Radius(first);
+	geometry.secondRadius = Radius(second);
+	Vector<double> branch = this->domain.Displacement(second.Basis().Origin(), first.Basis().Origin());
+	double distance = branch.Norme();
+	geometry.overlap = geometry.firstRadius + geometry.secondRadius - distance;
+	if(geometry.overlap <= 0 || distance == 0)
+		return false;
+	geometry.normal = branch/distance;
+	return true;
+}
+
+void ContactForceEngine::Compute(const Solid& first, const Solid& second, const ContactGeometry& geometry, ContactHistory::Entry& history, double dt, ContactForces& forces) const {
+	const Vector<double>& normal = geometry.normal;
+	
+	// Angular velocities are expressed in the local frame of each solid.
+	Vector<double> firstAngularVelocity = first.AngularVelocity();
+	first.Basis().Global(firstAngularVelocity);
+	Vector<double> secondAngularVelocity = second.AngularVelocity();
+	second.Basis().Global(secondAngularVelocity);
+	
+	Vector<double> relativeVelocity = first.Velocity() - second.Velocity()
+	+ geometry.firstRadius*(firstAngularVelocity^normal) + geometry.secondRadius*(secondAngularVelocity^normal);
+	double normalVelocity = relativeVelocity*normal;
+	Vector<double> tangentialVelocity = relativeVelocity - normalVelocity*normal;
+	
+	double firstMass = first.Shape()->Mass();
+	double secondMass = second.Shape()->Mass();
+	double effectiveMass = firstMass*secondMass/(firstMass + secondMass);
+	double effectiveRadius = geometry.firstRadius*geometry.secondRadius/(geometry.firstRadius + geometry.secondRadius);
+	ContactCoefficients coefficients;
+	this->model->Coefficients(geometry.overlap, effectiveRadius, effectiveMass, coefficients);
+	
+	double normalForce = coefficients.normalStiffness*geometry.overlap + coefficients.normalDamping*normalVelocity;
+	if(normalForce < 0)
+		normalForce = 0;
+	
+	// Rotate the tangential spring onto the current tangent plane, keeping its length.
+	Vector<double> spring(history.tangentialDisplacement[0], history.tangentialDisplacement[1], history.tangentialDisplacement[2]);
+	double length = spring.Norme();
+	spring -= (spring*normal)*normal;
+	double projectedLength = spring.Norme();
+	if(projectedLength != 0)
+		spring *= length/projectedLength;
+	spring += dt*tangentialVelocity;
+	
+	Vector<double> tangentialForce = spring*(-coefficients.tangentialStiffness) - tangentialVelocity*coefficients.tangentialDamping;
+	double tangentialNorm = tangentialForce.Norme();
+	double coulombLimit = this->model->Friction()*normalForce;
+	if(tangentialNorm > coulombLimit){
+		// Sliding: the spring is reset to the length matching the Coulomb limit.
+		tangentialForce *= coulombLimit/tangentialNorm;
+		if(coefficients.tangentialStiffness != 0)
+			spring = (tangentialForce + tangentialVelocity*coefficients.tangentialDamping)*(-1./coefficients.tangentialStiffness);
+	}
+	history.tangentialDisplacement[0] = spring.ComponantX();
+	history.tangentialDisplacement[1] = spring.ComponantY();
+	history.tangentialDisplacement[2] = spring.ComponantZ();
+	
+	forces.force = tangentialForce - normalForce*normal;
+	forces.firstMomentum = (geometry.firstRadius*normal)^tangentialForce;
+	forces.secondMomentum = (geometry.secondRadius*normal)^tangentialForce;
+}
@@ -0,0 +1,122 @@
+#include "../../Include/Contact/ContactHistory.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	// Keeps the probe sequences short: at most half of the slots are used (live or erased).
+	const std::size_t maxLoadDenominator = 2;
+	
+	std::size_t CapacityFor(std::size_t contacts) {
+		std::size_t capacity = 16;
+		while(capacity < contacts*maxLoadDenominator)
+			capacity <<= 1;
+		return capacity;
+	}
+}
+
+ContactHistory::ContactHistory(std::size_t expectedContacts) {
+	this->Rehash(CapacityFor(expectedContacts));
+}
+
+ContactHistory::Entry* ContactHistory::Find(std::uint64_t key) {
+	std::size_t index = Hash(key) & this->mask;
+	while(true){
+		Entry& entry = this->entries[index];
+		if(entry.key == key)
+			return &entry;
+		if(entry.key == emptyKey)
+			return nullptr;
+		index = (index + 1) & this->mask;
+	}
+}
+
+ContactHistory::Entry* ContactHistory::FindOrInsert(std::uint64_t key, std::uint32_t step, bool& inserted) {
+	if((this->size + this->erased + 1)*maxLoadDenominator > this->entries.size())
+		this->Rehash(CapacityFor(this->size + 1));
+	
+	std::size_t index = Hash(key) & this->mask;
+	Entry* firstErased = nullptr;
+	while(true){
+		Entry& entry = this->entries[index];
+		if(entry.key == key){
+			entry.lastStep = step;
+			inserted = false;
+			return &entry;
+		}
+		if(entry.key == erasedKey && firstErased == nullptr)
+			firstErased = &entry;
+		if(entry.key == emptyKey)
+			break;
+		index = (index + 1) & this->mask;
+	}
+	
+	Entry* entry = &this->entries[index];
+	if(firstErased != nullptr){
+		entry = firstErased;
+		--this->erased;
+	}
+	entry->key = key;
+	entry->lastStep = step;
+	entry->tangentialDisplacement[0] = entry->tangentialDisplacement[1] = entry->tangentialDisplacement[2] = 0;
+	++this->size;
+	inserted = true;
+	return entry;
+}
+
+bool ContactHistory::Erase(std::uint64_t key) {
+	Entry* entry = this->Find(key);
+	if(entry == nullptr)
+		return false;
+	entry->key = erasedKey;
+	--this->size;
+	++this->erased;
+	return true;
+}
+
+std::size_t ContactHistory::EvictStale(std::uint32_t step, std::uint32_t maxAge) {
+	std::size_t evicted = 0;
+	for(auto& entry : this->entries){
+		if(entry.key == emptyKey || entry.key == erasedKey)
+			continue;
+		if(step - entry.lastStep > maxAge){
+			entry.key = erasedKey;
+			++evicted;
+		}
+	}
+	this->size -= evicted;
+	this->erased += evicted;
+	
+	// Erased slots lengthen probes; compact in bulk once they dominate.
+	if(this->erased*4 > this->entries.size())
+		this->Rehash(this->entries.size());
+	return evicted;
+}
+
+void ContactHistory::Reserve(std::size_t contacts) {
+	if(CapacityFor(contacts) > this->entries.size())
+		this->Rehash(CapacityFor(contacts));
+}
+
+void ContactHistory::Clear() {
+	for(auto& entry : this->entries)
+		entry.key = emptyKey;
+	this->size = 0;
+	this->erased = 0;
+}
+
+void ContactHistory::Rehash(std::size_t capacity) {
+	Entry empty = {emptyKey, 0, {0, 0, 0}};
+	this->spare.assign(capacity, empty);
+	std::size_t mask = capacity - 1;
+	for(const auto& entry : this->entries){
+		if(entry.key == emptyKey || entry.key == erasedKey)
+			continue;
+		std::size_t index = Hash(entry.key) & mask;
+		while(this->spare[index].key != emptyKey)
+			index = (index + 1) & mask;
+		this->spare[index] = entry;
+	}
+	this->entries.swap(this->spare);
+	this->mask = mask;
+	this->erased = 0;
+}
@@ -0,0 +1,119 @@
+#include "../../Include/Neighbor/SpatialReorder.h"
+#include <algorithm>
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	const std::uint32_t mortonBits = 21;
+	
+	std::uint64_t SpreadBits(std::uint64_t x) {
+		x &= 0x1fffff;
+		x = (x | x << 32) & 0x1f00000000ffffULL;
+		x = (x | x << 16) & 0x1f0000ff0000ffULL;
+		x = (x | x << 8) & 0x100f00f00f00f00fULL;
+		x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+		x = (x | x << 2) & 0x1249249249249249ULL;
+		return x;
+	}
+}
+
+SpatialReorder::SpatialReorder(std::size_t period):period(period) {}
+
+std::uint64_t SpatialReorder::MortonKey(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+	return SpreadBits(x) | SpreadBits(y) << 1 | SpreadBits(z) << 2;
+}
+
+std::size_t SpatialReorder::MemoryFootprint() const {
+	return (this->ids.capacity() + this->indices.capacity() + this->permutation.capacity() + this->reorderedIds.capacity())*sizeof(std::uint32_t)
+	+ this->keys.capacity()*sizeof(std::uint64_t) + this->placed.capacity()/8;
+}
+
+bool SpatialReorder::Update(std::vector<Solid>& solids, std::size_t step) {
+	this->Track(solids.size());
+	if(!this->Due(step))
+		return false;
+	this->Reorder(solids);
+	return true;
+}
+
+void SpatialReorder::Track(std::size_t count) {
+	// Solids appended since the last call get the next ids.
+	if(this->ids.size() > count){
+		this->ids.clear();
+		this->indices.clear();
+	}
+	for(std::size_t i = this->ids.size() ; i < count ; ++i){
+		this->ids.push_back(static_cast<std::uint32_t>(this->indices.size()));
+		this->indices.push_back(static_cast<std::uint32_t>(i));
+	}
+}
+
+void SpatialReorder::Reorder(std::vector<Solid>& solids) {
+	std::size_t count = solids.size();
+	this->Track(count);
+	if(count == 0)
+		return;
+	
+	double lower[3], upper[3];
+	Point<double> origin = solids[0].Basis().Origin();
+	lower[0] = upper[0] = origin.CoordinateX();
+	lower[1] = upper[1] = origin.CoordinateY();
+	lower[2] = upper[2] = origin.CoordinateZ();
+	for(const auto& solid : solids){
+		origin = solid.Basis().Origin();
+		double coordinates[3] = {origin.CoordinateX(), origin.CoordinateY(), origin.CoordinateZ()};
+		for(int d = 0 ; d < 3 ; ++d){
+			lower[d] = std::min(lower[d], coordinates[d]);
+			upper[d] = std::max(upper[d], coordinates[d]);
+		}
+	}
+	double scale = 0;
+	for(int d = 0 ; d < 3 ; ++d)
+		scale = std::max(scale, upper[d] - lower[d]);
+	scale = scale > 0 ? ((1u << mortonBits) - 1)/scale : 0;
+	
+	this->keys.resize(count);
+	for(std::size_t i = 0 ; i < count ; ++i){
+		origin = solids[i].Basis().Origin();
+		this->keys[i] = MortonKey(static_cast<std::uint32_t>((origin.CoordinateX() - lower[0])*scale),
+															static_cast<std::uint32_t>((origin.CoordinateY() - lower[1])*scale),
+															static_cast<std::uint32_t>((origin.CoordinateZ() - lower[2])*scale));
+	}
+	this->permutation.resize(count);
+	for(std::size_t i = 0 ; i < count ; ++i)
+		this->permutation[i] = static_cast<std::uint32_t>(i);
+	std::vector<std::uint64_t>& keys = this->keys;
+	// Ties broken by index give the order of a stable sort without its temporary buffer.
+	std::sort(this->permutation.begin(), this->permutation.end(), [&keys](std::uint32_t a, std::uint32_t b){ return keys[a] < keys[b] || (keys[a] == keys[b] && a < b); });
+	
+	// Apply the permutation in place, one cycle at a time. Moved solids are dirty for
+	// checkpoints, which write solids by index.
+	this->placed.assign(count, false);
+	for(std::size_t start = 0 ; start < count ; ++start){
+		if(this->placed[start])
+			continue;
+		this->placed[start] = true;
+		if(this->permutation[start] == start)
+			continue;
+		Solid moved(std::move(solids[start]));
+		std::size_t current = start;
+		while(this->permutation[current] != start){
+			std::size_t next = this->permutation[current];
+			solids[current] = std::move(solids[next]);
+			solids[current].MarkDirty();
+			this->placed[next] = true;
+			current = next;
+		}
+		solids[current] = std::move(moved);
+		solids[current].MarkDirty();
+	}
+	
+	this->reorderedIds.resize(count);
+	for(std::size_t i = 0 ; i < count ; ++i)
+		this->reorderedIds[i] = this->ids[this->permutation[i]];
+	this->ids.swap(this->reorderedIds);
+	for(std::size_t i = 0 ; i < count ; ++i)
+		this->indices[this->ids[i]] = static_cast<std::uint32_t>(i);
+	++this->reorders;
+}
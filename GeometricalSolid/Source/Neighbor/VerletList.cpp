@@ -0,0 +1,207 @@
+#include "../../Include/Neighbor/VerletList.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+VerletList::VerletList(double skin):skin(skin) {
+	for(int d = 0 ; d < 3 ; ++d){
+		this->periodic[d] = false;
+		this->lower[d] = 0;
+		this->cellWidth[d] = 1;
+		this->dimensions[d] = 1;
+	}
+}
+
+bool VerletList::Update(const std::vector<Solid>& solids) {
+	++this->updates;
+	if(!this->NeedsRebuild(solids))
+		return false;
+	this->Build(solids);
+	return true;
+}
+
+bool VerletList::NeedsRebuild(const std::vector<Solid>& solids) {
+	if(!this->valid || solids.size() != this->SolidCount())
+		return true;
+	
+	// Two solids moving towards each other may both use their largest displacement.
+	double first = 0, second = 0;
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		Point<double> reference(this->reference[3*i], this->reference[3*i + 1], this->reference[3*i + 2]);
+		double displacement = this->domain.Displacement(solids[i].Basis().Origin(), reference).Norme();
+		if(displacement > first){
+			second = first;
+			first = displacement;
+		}
+		else if(displacement > second)
+			second = displacement;
+	}
+	this->maxDisplacement = first;
+	return first + second > this->skin;
+}
+
+void VerletList::Build(const std::vector<Solid>& solids) {
+	std::size_t count = solids.size();
+	this->reference.resize(3*count);
+	this->radii.resize(count);
+	double maxRadius = 0;
+	for(std::size_t i = 0 ; i < count ; ++i){
+		Point<double> origin = this->domain.Wrapped(solids[i].Basis().Origin());
+		this->reference[3*i] = origin.CoordinateX();
+		this->reference[3*i + 1] = origin.CoordinateY();
+		this->reference[3*i + 2] = origin.CoordinateZ();
+		this->radii[i] = solids[i].Shape() != nullptr ? solids[i].Shape()->BoundingRadius() : 0;
+		maxRadius = std::max(maxRadius, this->radii[i]);
+	}
+	
+	this->BuildCells(count, 2*maxRadius + this->skin);
+	
+	std::size_t neighborCells[3][3];
+	std::size_t neighborCount[3];
+	this->offsets.resize(count + 1);
+	this->neighbors.clear();
+	for(std::size_t i = 0 ; i < count ; ++i){
+		this->offsets[i] = static_cast<std::uint32_t>(this->neighbors.size());
+		Point<double> origin(this->reference[3*i], this->reference[3*i + 1], this->reference[3*i + 2]);
+		std::size_t cell = this->cellOfSolid[i];
+		for(int d = 0 ; d < 3 ; ++d){
+			neighborCount[d] = this->NeighborCells(cell % this->dimensions[d], d, neighborCells[d]);
+			cell /= this->dimensions[d];
+		}
+		for(std::size_t z = 0 ; z < neighborCount[2] ; ++z){
+			for(std::size_t y = 0 ; y < neighborCount[1] ; ++y){
+				for(std::size_t x = 0 ; x < neighborCount[0] ; ++x){
+					std::size_t neighborCell = neighborCells[0][x] + this->dimensions[0]*(neighborCells[1][y] + this->dimensions[1]*neighborCells[2][z]);
+					for(std::uint32_t k = this->cellStart[neighborCell] ; k < this->cellStart[neighborCell + 1] ; ++k){
+						std::uint32_t j = this->cellSolids[k];
+						if(j <= i)
+							continue;
+						Point<double> neighbor(this->reference[3*j], this->reference[3*j + 1], this->reference[3*j + 2]);
+						Vector<double> branch = this->domain.Displacement(neighbor, origin);
+						double cutoff = this->radii[i] + this->radii[j] + this->skin;
+						if(branch*branch < cutoff*cutoff)
+							this->neighbors.push_back(j);
+					}
+				}
+			}
+		}
+		// Sorted rows keep the accesses to the neighbors streaming.
+		std::sort(this->neighbors.begin() + this->offsets[i], this->neighbors.end());
+	}
+	this->offsets[count] = static_cast<std::uint32_t>(this->neighbors.size());
+	
+	this->valid = true;
+	this->maxDisplacement = 0;
+	++this->builds;
+}
+
+std::size_t VerletList::NeighborCells(std::size_t cell, int axis, std::size_t* neighborCells) const {
+	std::size_t dimension = this->dimensions[axis];
+	std::size_t count = 0;
+	if(this->periodic[axis]){
+		// Small boxes wrap onto the same cell: list each one once.
+		std::size_t candidates[3] = {(cell + dimension - 1) % dimension, cell, (cell + 1) % dimension};
+		for(std::size_t candidate : candidates){
+			if(std::find(neighborCells, neighborCells + count, candidate) == neighborCells + count)
+				neighborCells[count++] = candidate;
+		}
+		return count;
+	}
+	for(std::size_t candidate = (cell > 0 ? cell - 1 : 0) ; candidate <= std::min(cell + 1, dimension - 1) ; ++candidate)
+		neighborCells[count++] = candidate;
+	return count;
+}
+
+void VerletList::BuildCells(std::size_t count, double cellSize) {
+	Point<double> domainLower = this->domain.Lower();
+	Vector<double> lengths = this->domain.Lengths();
+	double boxLower[3] = {domainLower.CoordinateX(), domainLower.CoordinateY(), domainLower.CoordinateZ()};
+	double boxLength[3] = {lengths.ComponantX(), lengths.ComponantY(), lengths.ComponantZ()};
+	this->periodic[0] = this->domain.IsXPeriodic();
+	this->periodic[1] = this->domain.IsYPeriodic();
+	this->periodic[2] = this->domain.IsZPeriodic();
+	
+	double extent[3];
+	for(int d = 0 ; d < 3 ; ++d){
+		if(this->periodic[d]){
+			this->lower[d] = boxLower[d];
+			extent[d] = boxLength[d];
+			continue;
+		}
+		double upper = count > 0 ? this->reference[d] : 0;
+		this->lower[d] = upper;
+		for(std::size_t i = 0 ; i < count ; ++i){
+			this->lower[d] = std::min(this->lower[d], this->reference[3*i + d]);
+			upper = std::max(upper, this->reference[3*i + d]);
+		}
+		extent[d] = upper - this->lower[d];
+	}
+	
+	// Sparse packings would allocate too many empty cells: cap them to a few per solid.
+	if(cellSize <= 0)
+		cellSize = 1;
+	std::size_t maxCells = 8*count + 1;
+	while(true){
+		std::size_t cells = 1;
+		for(int d = 0 ; d < 3 ; ++d){
+			if(this->periodic[d]){
+				// Periodic cells tile the box exactly and are never smaller than the cutoff.
+				this->dimensions[d] = std::max(static_cast<std::size_t>(extent[d]/cellSize), static_cast<std::size_t>(1));
+				this->cellWidth[d] = extent[d]/this->dimensions[d];
+			}
+			else{
+				this->dimensions[d] = static_cast<std::size_t>(extent[d]/cellSize) + 1;
+				this->cellWidth[d] = cellSize;
+			}
+			cells *= this->dimensions[d];
+		}
+		if(cells <= maxCells)
+			break;
+		cellSize *= 2;
+	}
+	
+	std::size_t cells = this->dimensions[0]*this->dimensions[1]*this->dimensions[2];
+	this->cellStart.assign(cells + 1, 0);
+	this->cellOfSolid.resize(count);
+	for(std::size_t i = 0 ; i < count ; ++i){
+		std::size_t index[3];
+		for(int d = 0 ; d < 3 ; ++d){
+			double position = (this->reference[3*i + d] - this->lower[d])/this->cellWidth[d];
+			index[d] = position > 0 ? std::min(static_cast<std::size_t>(position), this->dimensions[d] - 1) : 0;
+		}
+		std::size_t cell = index[0] + this->dimensions[0]*(index[1] + this->dimensions[1]*index[2]);
+		this->cellOfSolid[i] = static_cast<std::uint32_t>(cell);
+		++this->cellStart[cell + 1];
+	}
+	for(std::size_t cell = 0 ; cell < cells ; ++cell)
+		this->cellStart[cell + 1] += this->cellStart[cell];
+	
+	this->cellSolids.resize(count);
+	for(std::size_t i = 0 ; i < count ; ++i)
+		this->cellSolids[this->cellStart[this->cellOfSolid[i]]++] = static_cast<std::uint32_t>(i);
+	// Restore the starts shifted by the scatter above.
+	for(std::size_t cell = cells ; cell > 0 ; --cell)
+		this->cellStart[cell] = this->cellStart[cell - 1];
+	this->cellStart[0] = 0;
+}
+
+std::size_t VerletList::MemoryFootprint() const {
+	return (this->offsets.capacity() + this->neighbors.capacity() + this->cellOfSolid.capacity() + this->cellStart.capacity() + this->cellSolids.capacity())*sizeof(std::uint32_t)
+	+ (this->reference.capacity() + this->radii.capacity())*sizeof(double);
+}
+
+VerletListStatistics VerletList::Statistics() const {
+	VerletListStatistics statistics;
+	statistics.updates = this->updates;
+	statistics.builds = this->builds;
+	statistics.stepsPerBuild = this->builds > 0 ? static_cast<double>(this->updates)/this->builds : 0;
+	statistics.maxDisplacement = this->maxDisplacement;
+	return statistics;
+}
+
+void VerletList::ResetStatistics() {
+	this->updates = 0;
+	this->builds = 0;
+}
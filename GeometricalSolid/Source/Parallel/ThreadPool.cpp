@@ -0,0 +1,81 @@
+#include "../../Include/Parallel/ThreadPool.h"
+#include "../../Include/Profiling/Profiler.h"
+
+using namespace GeometricalSolid;
+
+ThreadPool::ThreadPool(std::size_t threads) {
+	for(std::size_t thread = 1 ; thread < threads ; ++thread)
+		this->workers.emplace_back(&ThreadPool::WorkerLoop, this, thread);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->wakeUp.notify_all();
+	for(auto& worker : this->workers)
+		worker.join();
+}
+
+void ThreadPool::Run(Task task, const void* function, std::size_t count) {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->task = task;
+		this->function = function;
+		this->count = count;
+		this->remaining = this->workers.size();
+#ifdef GEOMETRICALSOLID_PROFILING
+		this->phase = Trace::Current();
+#endif
+		++this->generation;
+	}
+	this->wakeUp.notify_all();
+	this->RunChunk(0);
+	
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->finished.wait(lock, [this]{ return this->remaining == 0; });
+}
+
+void ThreadPool::RunChunk(std::size_t thread) {
+	std::size_t threads = this->Size();
+	std::size_t begin = this->count*thread/threads;
+	std::size_t end = this->count*(thread + 1)/threads;
+	if(begin >= end)
+		return;
+#ifdef GEOMETRICALSOLID_PROFILING
+	// Workers run their chunk in the phase of the loop; the calling thread counts its
+	// own chunk within the phase scope already.
+	Phase outer = Trace::Enter(this->phase);
+	bool counting = thread != 0 && this->phase != Phase::Count && PerfCounters::Counting();
+	CounterSample counters;
+	if(counting)
+		PerfCounters::Read(counters);
+	std::uint64_t start = Profiler::Now();
+#endif
+	this->task(this->function, begin, end, thread);
+#ifdef GEOMETRICALSOLID_PROFILING
+	if(counting)
+		PerfCounters::Record(this->phase, counters);
+	if(this->phase != Phase::Count && Trace::Capturing())
+		Trace::Record(this->phase, static_cast<std::int32_t>(thread), start, Profiler::Now());
+	Trace::Leave(outer);
+#endif
+}
+
+void ThreadPool::WorkerLoop(std::size_t thread) {
+	std::size_t seen = 0;
+	while(true){
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->wakeUp.wait(lock, [this, seen]{ return this->stopping || this->generation != seen; });
+			if(this->stopping)
+				return;
+			seen = this->generation;
+		}
+		this->RunChunk(thread);
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if(--this->remaining == 0)
+			this->finished.notify_one();
+	}
+}
@@ -0,0 +1,71 @@
+#include <stdexcept>
+#include "../../Include/Parser/ReadAhead.h"
+
+using namespace GeometricalSolid;
+
+ReadAhead::ReadAhead(const std::string& path, std::size_t bufferSize, std::size_t buffers):path(path), in(path.c_str(), std::ios::binary),
+buffers(buffers > 0 ? buffers : 1, std::vector<char>(bufferSize > 0 ? bufferSize : 1)), sizes(this->buffers.size(), 0) {
+	if(!this->in)
+		throw(std::runtime_error("ReadAhead: cannot open " + path));
+	this->reader = std::thread(&ReadAhead::ReaderLoop, this);
+}
+
+ReadAhead::~ReadAhead() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->bufferReleased.notify_all();
+	this->reader.join();
+}
+
+bool ReadAhead::Next(std::string& text) {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->bufferFilled.wait(lock, [this]{ return this->filled > 0 || this->finished; });
+	if(this->filled == 0){
+		if(this->error)
+			std::rethrow_exception(this->error);
+		return false;
+	}
+	std::size_t slot = this->head;
+	lock.unlock();
+	// The reader thread never touches a filled buffer.
+	text.append(this->buffers[slot].data(), this->sizes[slot]);
+	lock.lock();
+	this->head = (this->head + 1) % this->buffers.size();
+	--this->filled;
+	lock.unlock();
+	this->bufferReleased.notify_one();
+	return true;
+}
+
+void ReadAhead::ReaderLoop() {
+	std::size_t tail = 0;
+	while(true){
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->bufferReleased.wait(lock, [this]{ return this->stopping || this->filled < this->buffers.size(); });
+			if(this->stopping)
+				return;
+		}
+		std::vector<char>& buffer = this->buffers[tail];
+		this->in.read(buffer.data(), buffer.size());
+		std::size_t size = this->in.gcount();
+		bool end = this->in.eof();
+		bool failed = !end && !this->in;
+		
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if(size > 0){
+			this->sizes[tail] = size;
+			tail = (tail + 1) % this->buffers.size();
+			++this->filled;
+		}
+		if(failed)
+			this->error = std::make_exception_ptr(std::runtime_error("ReadAhead: cannot read " + this->path));
+		if(end || failed)
+			this->finished = true;
+		this->bufferFilled.notify_one();
+		if(this->finished)
+			return;
+	}
+}
@@ -0,0 +1,185 @@
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <Parser/NumberParser.h>
+#include "../../Include/Parser/SceneLoader.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	const int numbersPerLine[SceneLoader::linesPerRecord] = {3, 4, 3, 3, 3, 3};
+	
+	bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+	
+	const char* EndOfLine(const char* p, const char* end) {
+		const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		return newline ? newline : end;
+	}
+	
+	bool HasContent(const char* p, const char* end) {
+		for(; p != end ; ++p)
+			if(!IsBlank(*p))
+				return true;
+		return false;
+	}
+	
+	// Moves p past the next non-blank line.
+	const char* SkipLine(const char* p, const char* end) {
+		while(p != end){
+			const char* eol = EndOfLine(p, end);
+			bool content = HasContent(p, eol);
+			p = eol == end ? end : eol + 1;
+			if(content)
+				break;
+		}
+		return p;
+	}
+	
+	// Each line is parsed within its own bounds, so that a short line is an error
+	// instead of borrowing numbers from the next one.
+	bool ParseRecord(const char*& p, const char* end, Solid& solid) {
+		double values[19];
+		double* value = values;
+		for(std::size_t line = 0 ; line < SceneLoader::linesPerRecord ; ++line){
+			const char* eol = EndOfLine(p, end);
+			while(eol != end && !HasContent(p, eol)){
+				p = eol + 1;
+				eol = EndOfLine(p, end);
+			}
+			for(int k = 0 ; k < numbersPerLine[line] ; ++k)
+				if(!NumberParser<double>::Parse(p, eol, *value++))
+					return false;
+			if(HasContent(p, eol))
+				return false;
+			p = eol == end ? end : eol + 1;
+		}
+		solid.Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(values[0], values[1], values[2]), Quaternion<double>(values[3], values[4], values[5], values[6])));
+		solid.Velocity(Vector<double>(values[7], values[8], values[9]));
+		solid.AngularVelocity(Vector<double>(values[10], values[11], values[12]));
+		solid.Force(Vector<double>(values[13], values[14], values[15]));
+		solid.Momentum(Vector<double>(values[16], values[17], values[18]));
+		return true;
+	}
+}
+
+SceneLoader::SceneLoader(const std::string& path, std::size_t chunkSize):path(path), chunkSize(chunkSize > 0 ? chunkSize : 1) {
+	int file = open(path.c_str(), O_RDONLY);
+	if(file < 0)
+		throw(std::runtime_error("SceneLoader: cannot open " + path));
+	struct stat status;
+	if(fstat(file, &status) != 0){
+		close(file);
+		throw(std::runtime_error("SceneLoader: cannot read " + path));
+	}
+	this->size = status.st_size;
+	if(this->size > 0){
+		void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(mapping == MAP_FAILED){
+			close(file);
+			throw(std::runtime_error("SceneLoader: cannot map " + path));
+		}
+		// Advice values are not flags: one call each.
+		madvise(mapping, this->size, MADV_SEQUENTIAL);
+		madvise(mapping, this->size, MADV_WILLNEED);
+		this->data = static_cast<const char*>(mapping);
+	}
+	close(file);
+	this->Split();
+}
+
+SceneLoader::~SceneLoader() {
+	if(this->data)
+		munmap(const_cast<char*>(this->data), this->size);
+}
+
+void SceneLoader::Split() {
+	const char* end = this->data + this->size;
+	const char* begin = this->data;
+	while(begin != end){
+		const char* next = begin + (static_cast<std::size_t>(end - begin) > this->chunkSize ? this->chunkSize : end - begin);
+		if(next != end){
+			next = EndOfLine(next, end);
+			next = next == end ? end : next + 1;
+		}
+		this->chunks.push_back(Chunk{begin, next, 0, 0});
+		begin = next;
+	}
+}
+
+void SceneLoader::CountLines(ThreadPool& pool) {
+	if(this->counted)
+		return;
+	pool.ParallelFor(this->chunks.size(), [this](std::size_t begin, std::size_t end, std::size_t){
+		for(std::size_t c = begin ; c < end ; ++c){
+			Chunk& chunk = this->chunks[c];
+			std::size_t lines = 0;
+			for(const char* p = chunk.begin ; p != chunk.end ; ){
+				const char* eol = EndOfLine(p, chunk.end);
+				lines += HasContent(p, eol);
+				p = eol == chunk.end ? eol : eol + 1;
+			}
+			chunk.lines = lines;
+		}
+	});
+	this->lineCount = 0;
+	for(auto& chunk : this->chunks){
+		chunk.firstLine = this->lineCount;
+		this->lineCount += chunk.lines;
+	}
+	this->counted = true;
+}
+
+std::size_t SceneLoader::RecordCount(ThreadPool& pool) {
+	this->CountLines(pool);
+	if(this->lineCount % linesPerRecord != 0)
+		throw(std::runtime_error("SceneLoader: " + this->path + " ends with an incomplete record"));
+	return this->lineCount/linesPerRecord;
+}
+
+void SceneLoader::Parse(const Chunk& chunk, Solid* solids, std::string& error) const {
+	const char* end = this->data + this->size;
+	std::size_t skipped = (linesPerRecord - chunk.firstLine % linesPerRecord) % linesPerRecord;
+	if(skipped >= chunk.lines)
+		return;
+	const char* p = chunk.begin;
+	for(std::size_t line = 0 ; line < skipped ; ++line)
+		p = SkipLine(p, chunk.end);
+	
+	std::size_t record = (chunk.firstLine + skipped)/linesPerRecord;
+	std::size_t lastRecord = (chunk.firstLine + chunk.lines - 1)/linesPerRecord;
+	for(; record <= lastRecord ; ++record){
+		if(!ParseRecord(p, end, solids[record])){
+			error = "SceneLoader: record " + std::to_string(record) + " of " + this->path + " is malformed";
+			return;
+		}
+	}
+}
+
+void SceneLoader::Load(Solid* solids, std::size_t count, ThreadPool& pool) {
+	std::size_t records = this->RecordCount(pool);
+	if(count != records)
+		throw(std::runtime_error("SceneLoader: " + this->path + " holds " + std::to_string(records) + " solids, not " + std::to_string(count)));
+	
+	std::vector<std::string> errors(this->chunks.size());
+	pool.ParallelFor(this->chunks.size(), [&](std::size_t begin, std::size_t end, std::size_t){
+		for(std::size_t c = begin ; c < end ; ++c)
+			this->Parse(this->chunks[c], solids, errors[c]);
+	});
+	for(const auto& error : errors)
+		if(!error.empty())
+			throw(std::runtime_error(error));
+}
+
+void SceneLoader::Load(std::vector<Solid>& solids, ThreadPool& pool) {
+	std::size_t records = this->RecordCount(pool);
+	if(solids.size() > records)
+		solids.erase(solids.begin() + records, solids.end());
+	solids.reserve(records);
+	while(solids.size() < records)
+		solids.emplace_back(std::unique_ptr<Shape>());
+	this->Load(solids.data(), records, pool);
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include "../../Include/Profiling/LatencyHistogram.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	const unsigned exactBits = 7;		// values below 128 have a bucket each
+	const std::uint64_t exact = 1ull << exactBits;
+	const std::uint64_t half = exact/2;
+	const std::size_t bucketCount = exact + (64 - exactBits)*half;
+	
+	unsigned BitLength(std::uint64_t value) {
+		return value == 0 ? 0 : 64 - __builtin_clzll(value);
+	}
+	
+	// Single writer: plain read-modify-write through relaxed atomics.
+	void Add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+}
+
+LatencyHistogram::LatencyHistogram():buckets(bucketCount) {
+	this->Reset();
+}
+
+std::size_t LatencyHistogram::Bucket(std::uint64_t value) {
+	if(value < exact)
+		return static_cast<std::size_t>(value);
+	unsigned shift = BitLength(value) - exactBits;
+	return static_cast<std::size_t>(exact + (shift - 1)*half + ((value >> shift) - half));
+}
+
+std::size_t LatencyHistogram::BucketCount() {
+	return bucketCount;
+}
+
+std::uint64_t LatencyHistogram::Value(std::size_t bucket) {
+	if(bucket < exact)
+		return bucket;
+	unsigned shift = static_cast<unsigned>((bucket - exact)/half) + 1;
+	std::uint64_t top = (bucket - exact)%half + half;
+	return (top << shift) + ((1ull << shift) >> 1);
+}
+
+void LatencyHistogram::Record(std::uint64_t value) {
+	Add(this->buckets[Bucket(value)], 1);
+	Add(this->sum, value);
+	if(value > this->max.load(std::memory_order_relaxed))
+		this->max.store(value, std::memory_order_relaxed);
+	// Counted last, so that a reader never sees more values than buckets hold.
+	this->count.store(this->count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void LatencyHistogram::Reset() {
+	for(auto& bucket : this->buckets)
+		bucket.store(0, std::memory_order_relaxed);
+	this->count.store(0, std::memory_order_relaxed);
+	this->sum.store(0, std::memory_order_relaxed);
+	this->max.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::Mean() const {
+	std::uint64_t count = this->Count();
+	return count > 0 ? static_cast<double>(this->sum.load(std::memory_order_relaxed))/count : 0;
+}
+
+std::uint64_t LatencyHistogram::Percentile(double fraction) const {
+	std::uint64_t count = this->count.load(std::memory_order_acquire);
+	if(count == 0)
+		return 0;
+	std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(fraction*count));
+	rank = rank < 1 ? 1 : rank > count ? count : rank;
+	std::uint64_t seen = 0;
+	for(std::size_t b = 0 ; b < this->buckets.size() ; ++b){
+		seen += this->buckets[b].load(std::memory_order_relaxed);
+		if(seen >= rank)
+			return std::min(Value(b), this->Max());
+	}
+	return this->Max();
+}
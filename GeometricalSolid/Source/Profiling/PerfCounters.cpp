@@ -0,0 +1,324 @@
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "../../Include/Profiling/PerfCounters.h"
+
+using namespace GeometricalSolid;
+
+std::atomic<bool> PerfCounters::counting{false};
+
+namespace {
+	const int counterCount = static_cast<int>(Counter::Count);
+	const int phaseCount = static_cast<int>(Phase::Count);
+	
+	// Totals of one thread, written by that thread only.
+	struct Slot{
+		std::atomic<std::uint64_t> calls[phaseCount];
+		std::atomic<std::uint64_t> values[phaseCount][counterCount];
+		
+		Slot() {
+			for(int p = 0 ; p < phaseCount ; ++p){
+				this->calls[p].store(0, std::memory_order_relaxed);
+				for(int c = 0 ; c < counterCount ; ++c)
+					this->values[p][c].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+	
+	struct Registry{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Slot>> slots;
+		std::atomic<bool> probed{false};
+		bool available[counterCount] = {};
+		std::string status;
+	};
+	
+	Registry& Instance() {
+		static Registry registry;
+		return registry;
+	}
+	
+	// Counter group of the calling thread, closed when the thread exits.
+	struct Group{
+		int leader{-1};
+		int descriptors[counterCount];
+		int position[counterCount];		// in the group read, -1 when not open
+		int opened{0};
+		bool tried{false};
+		
+		Group() {
+			for(int c = 0 ; c < counterCount ; ++c)
+				this->descriptors[c] = this->position[c] = -1;
+		}
+		~Group() {
+#ifdef __linux__
+			for(int c = 0 ; c < counterCount ; ++c)
+				if(this->descriptors[c] >= 0)
+					close(this->descriptors[c]);
+#endif
+		}
+		
+		void Open(Registry& registry);
+		void Read(CounterSample& sample) const;
+	};
+	
+	thread_local Group group;
+	thread_local Slot* localSlot = nullptr;
+	
+#ifdef __linux__
+	void Describe(Counter counter, perf_event_attr& attr) {
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		switch(counter){
+			case Counter::Cycles: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+			case Counter::Instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+			case Counter::L1Misses:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case Counter::LlcMisses: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+			default: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+		}
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+	}
+#endif
+	
+	void Group::Open(Registry& registry) {
+		this->tried = true;
+		std::string status;
+#ifdef __linux__
+		for(int c = 0 ; c < counterCount ; ++c){
+			perf_event_attr attr;
+			Describe(static_cast<Counter>(c), attr);
+			int descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, this->leader, 0));
+			if(descriptor < 0){
+				if(status.empty())
+					status = std::string(CounterName(static_cast<Counter>(c))) + ": " + std::strerror(errno);
+				continue;
+			}
+			if(this->leader < 0)
+				this->leader = descriptor;
+			this->descriptors[c] = descriptor;
+			this->position[c] = this->opened++;
+		}
+#else
+		status = "perf_event_open is only available on Linux";
+#endif
+		if(!registry.probed.load(std::memory_order_acquire)){
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			for(int c = 0 ; c < counterCount ; ++c)
+				registry.available[c] = this->position[c] >= 0;
+			registry.status = status;
+			registry.probed.store(true, std::memory_order_release);
+		}
+	}
+	
+	void Group::Read(CounterSample& sample) const {
+		for(int c = 0 ; c < counterCount ; ++c)
+			sample.values[c] = 0;
+#ifdef __linux__
+		if(this->leader < 0)
+			return;
+		std::uint64_t buffer[3 + counterCount];
+		if(read(this->leader, buffer, sizeof(buffer)) < static_cast<ssize_t>(3*sizeof(std::uint64_t)))
+			return;
+		// Scaled up when the kernel multiplexed the group.
+		double scale = buffer[2] > 0 ? static_cast<double>(buffer[1])/buffer[2] : 0;
+		for(int c = 0 ; c < counterCount ; ++c)
+			if(this->position[c] >= 0 && static_cast<std::uint64_t>(this->position[c]) < buffer[0])
+				sample.values[c] = static_cast<std::uint64_t>(buffer[3 + this->position[c]]*scale);
+#endif
+	}
+	
+	Slot* LocalSlot() {
+		if(localSlot == nullptr){
+			Registry& registry = Instance();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.slots.emplace_back(new Slot());
+			localSlot = registry.slots.back().get();
+		}
+		return localSlot;
+	}
+	
+	void Ratio(std::ostream& out, bool available, double value) {
+		if(available)
+			out << value;
+		else
+			out << "n/a";
+	}
+}
+
+const char* GeometricalSolid::CounterName(Counter counter) {
+	static const char* names[] = {"cycles", "instructions", "l1_misses", "llc_misses", "branch_misses"};
+	return counter < Counter::Count ? names[static_cast<int>(counter)] : "unknown";
+}
+
+bool PerfCounters::Start() {
+	if(!group.tried)
+		group.Open(Instance());
+	bool available = false;
+	for(int c = 0 ; c < counterCount ; ++c)
+		available |= Available(static_cast<Counter>(c));
+	counting.store(available, std::memory_order_relaxed);
+	return available;
+}
+
+void PerfCounters::Stop() {
+	counting.store(false, std::memory_order_relaxed);
+}
+
+bool PerfCounters::Available(Counter counter) {
+	Registry& registry = Instance();
+	if(!registry.probed.load(std::memory_order_acquire))
+		return false;
+	return registry.available[static_cast<int>(counter)];
+}
+
+std::string PerfCounters::Status() {
+	Registry& registry = Instance();
+	if(!registry.probed.load(std::memory_order_acquire))
+		return "not started";
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	return registry.status;
+}
+
+void PerfCounters::Read(CounterSample& sample) {
+	if(!group.tried)
+		group.Open(Instance());
+	group.Read(sample);
+}
+
+void PerfCounters::Record(Phase phase, const CounterSample& begin) {
+	CounterSample end;
+	group.Read(end);
+	Slot* slot = LocalSlot();
+	int p = static_cast<int>(phase);
+	slot->calls[p].store(slot->calls[p].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	for(int c = 0 ; c < counterCount ; ++c){
+		std::uint64_t delta = end.values[c] > begin.values[c] ? end.values[c] - begin.values[c] : 0;
+		slot->values[p][c].store(slot->values[p][c].load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+}
+
+PerfReport PerfCounters::Report() {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	PerfReport report;
+	for(int c = 0 ; c < counterCount ; ++c)
+		report.available[c] = registry.probed.load(std::memory_order_acquire) && registry.available[c];
+	for(const auto& slot : registry.slots){
+		PerfReport::Phases phases(phaseCount);
+		for(int p = 0 ; p < phaseCount ; ++p){
+			phases[p].calls = slot->calls[p].load(std::memory_order_relaxed);
+			for(int c = 0 ; c < counterCount ; ++c)
+				phases[p].values[c] = slot->values[p][c].load(std::memory_order_relaxed);
+		}
+		report.threads.push_back(phases);
+	}
+	return report;
+}
+
+void PerfCounters::Reset() {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for(auto& slot : registry.slots)
+		for(int p = 0 ; p < phaseCount ; ++p){
+			slot->calls[p].store(0, std::memory_order_relaxed);
+			for(int c = 0 ; c < counterCount ; ++c)
+				slot->values[p][c].store(0, std::memory_order_relaxed);
+		}
+}
+
+PerfReport::Entry PerfReport::Total(Phase phase) const {
+	Entry total = {};
+	for(const auto& phases : this->threads){
+		const Entry& entry = phases[static_cast<int>(phase)];
+		total.calls += entry.calls;
+		for(int c = 0 ; c < counterCount ; ++c)
+			total.values[c] += entry.values[c];
+	}
+	return total;
+}
+
+void PerfReport::WriteText(std::ostream& out, std::size_t bodies) const {
+	double perBody = bodies > 0 ? 1./bodies : 0;
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::left << std::setw(14) << "Phase" << std::setw(8) << "Thread" << std::right << std::setw(10) << "Calls"
+	<< std::setw(16) << "Cycles/call" << std::setw(8) << "IPC" << std::setw(12) << "L1/body" << std::setw(12) << "LLC/body"
+	<< std::setw(14) << "Branch/body" << "\n" << std::fixed;
+	auto row = [&](const std::string& phase, const std::string& thread, const Entry& entry){
+		double calls = static_cast<double>(entry.calls);
+		out << std::left << std::setw(14) << phase << std::setw(8) << thread << std::right << std::setw(10) << entry.calls
+		<< std::setw(16) << std::setprecision(0);
+		Ratio(out, this->Available(Counter::Cycles), entry[Counter::Cycles]/calls);
+		out << std::setw(8) << std::setprecision(2);
+		Ratio(out, this->Available(Counter::Cycles) && this->Available(Counter::Instructions) && entry[Counter::Cycles] > 0,
+			  static_cast<double>(entry[Counter::Instructions])/entry[Counter::Cycles]);
+		out << std::setprecision(3) << std::setw(12);
+		Ratio(out, this->Available(Counter::L1Misses), perBody*entry[Counter::L1Misses]/calls);
+		out << std::setw(12);
+		Ratio(out, this->Available(Counter::LlcMisses), perBody*entry[Counter::LlcMisses]/calls);
+		out << std::setw(14);
+		Ratio(out, this->Available(Counter::BranchMisses), perBody*entry[Counter::BranchMisses]/calls);
+		out << "\n";
+	};
+	for(int p = 0 ; p < phaseCount ; ++p){
+		Entry total = this->Total(static_cast<Phase>(p));
+		if(total.calls == 0)
+			continue;
+		std::string name = PhaseName(static_cast<Phase>(p));
+		row(name, "all", total);
+		for(std::size_t t = 0 ; t < this->threads.size() && this->threads.size() > 1 ; ++t)
+			if(this->threads[t][p].calls > 0)
+				row("", std::to_string(t), this->threads[t][p]);
+	}
+	out.flags(flags);
+	out.precision(precision);
+	out << std::flush;
+}
+
+void PerfReport::WriteJson(std::ostream& out, std::size_t bodies) const {
+	std::streamsize precision = out.precision(17);
+	out << "{\"bodies\": " << bodies << ", \"available\": [";
+	const char* separator = "";
+	for(int c = 0 ; c < counterCount ; ++c)
+		if(this->available[c]){
+			out << separator << "\"" << CounterName(static_cast<Counter>(c)) << "\"";
+			separator = ", ";
+		}
+	out << "], \"phases\": [";
+	separator = "";
+	for(int p = 0 ; p < phaseCount ; ++p){
+		if(this->Total(static_cast<Phase>(p)).calls == 0)
+			continue;
+		out << separator << "{\"name\": \"" << PhaseName(static_cast<Phase>(p)) << "\", \"threads\": [";
+		separator = ", ";
+		const char* threadSeparator = "";
+		for(std::size_t t = 0 ; t < this->threads.size() ; ++t){
+			const Entry& entry = this->threads[t][p];
+			if(entry.calls == 0)
+				continue;
+			out << threadSeparator << "{\"thread\": " << t << ", \"calls\": " << entry.calls;
+			for(int c = 0 ; c < counterCount ; ++c)
+				if(this->available[c])
+					out << ", \"" << CounterName(static_cast<Counter>(c)) << "\": " << entry.values[c];
+			out << "}";
+			threadSeparator = ", ";
+		}
+		out << "]}";
+	}
+	out << "]}" << std::endl;
+	out.precision(precision);
+}
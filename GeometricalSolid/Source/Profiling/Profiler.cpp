@@ -0,0 +1,169 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_TIME_STAMP_COUNTER
+#endif
+#include "../../Include/Profiling/Profiler.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	const int phaseCount = static_cast<int>(Phase::Count);
+	
+	// Written by its thread only, with plain stores; atomics keep the reads of Report defined.
+	struct Slot{
+		std::atomic<std::uint64_t> calls[phaseCount];
+		std::atomic<std::uint64_t> ticks[phaseCount];
+		
+		Slot() {
+			for(int p = 0 ; p < phaseCount ; ++p){
+				this->calls[p].store(0, std::memory_order_relaxed);
+				this->ticks[p].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+	
+	struct Registry{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Slot>> slots;
+		std::uint64_t baseCalls[phaseCount] = {};
+		std::uint64_t baseTicks[phaseCount] = {};
+		std::chrono::steady_clock::time_point resetTime{std::chrono::steady_clock::now()};
+		// Pairs the tick counter with the steady clock to calibrate it.
+		std::uint64_t originTicks{Profiler::Now()};
+		std::chrono::steady_clock::time_point originTime{std::chrono::steady_clock::now()};
+	};
+	
+	Registry& Instance() {
+		static Registry registry;
+		return registry;
+	}
+	
+	thread_local Slot* localSlot = nullptr;
+	
+	Slot* Register() {
+		Registry& registry = Instance();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.slots.emplace_back(new Slot());
+		return registry.slots.back().get();
+	}
+	
+	void Sum(Registry& registry, std::uint64_t* calls, std::uint64_t* ticks) {
+		for(int p = 0 ; p < phaseCount ; ++p)
+			calls[p] = ticks[p] = 0;
+		for(const auto& slot : registry.slots)
+			for(int p = 0 ; p < phaseCount ; ++p){
+				calls[p] += slot->calls[p].load(std::memory_order_relaxed);
+				ticks[p] += slot->ticks[p].load(std::memory_order_relaxed);
+			}
+	}
+}
+
+const char* GeometricalSolid::PhaseName(Phase phase) {
+	static const char* names[] = {"Reorder", "Forces", "Neighbors", "Contacts", "Velocities", "Positions", "Output", "Checkpoint"};
+	return phase < Phase::Count ? names[static_cast<int>(phase)] : "Unknown";
+}
+
+std::uint64_t Profiler::Now() {
+#ifdef PROFILER_TIME_STAMP_COUNTER
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+double Profiler::TicksPerSecond() {
+#ifdef PROFILER_TIME_STAMP_COUNTER
+	Registry& registry = Instance();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - registry.originTime).count();
+	if(seconds < 0.01){
+		std::this_thread::sleep_for(std::chrono::duration<double>(0.01 - seconds));
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - registry.originTime).count();
+	}
+	return (Now() - registry.originTicks)/seconds;
+#else
+	return 1e9;
+#endif
+}
+
+void Profiler::Record(Phase phase, std::uint64_t ticks) {
+	Slot* slot = localSlot;
+	if(slot == nullptr)
+		slot = localSlot = Register();
+	int p = static_cast<int>(phase);
+	slot->calls[p].store(slot->calls[p].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	slot->ticks[p].store(slot->ticks[p].load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+}
+
+ProfileReport Profiler::Report() {
+	double ticksPerSecond = TicksPerSecond();
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	std::uint64_t calls[phaseCount], ticks[phaseCount];
+	Sum(registry, calls, ticks);
+	ProfileReport report;
+	for(int p = 0 ; p < phaseCount ; ++p){
+		report.phases[p].calls = calls[p] - registry.baseCalls[p];
+		report.phases[p].seconds = (ticks[p] - registry.baseTicks[p])/ticksPerSecond;
+	}
+	report.threads = registry.slots.size();
+	report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - registry.resetTime).count();
+	return report;
+}
+
+void Profiler::Reset() {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	Sum(registry, registry.baseCalls, registry.baseTicks);
+	registry.resetTime = std::chrono::steady_clock::now();
+}
+
+double ProfileReport::Seconds() const {
+	double seconds = 0;
+	for(const auto& phase : this->phases)
+		seconds += phase.seconds;
+	return seconds;
+}
+
+void ProfileReport::WriteText(std::ostream& out) const {
+	double total = this->Seconds();
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::left << std::setw(14) << "Phase" << std::right << std::setw(12) << "Calls" << std::setw(14) << "Total (ms)"
+	<< std::setw(14) << "Mean (us)" << std::setw(10) << "Share %" << "\n" << std::fixed;
+	for(int p = 0 ; p < phaseCount ; ++p){
+		const PhaseStatistics& phase = this->phases[p];
+		if(phase.calls == 0)
+			continue;
+		out << std::left << std::setw(14) << PhaseName(static_cast<Phase>(p)) << std::right << std::setw(12) << phase.calls
+		<< std::setw(14) << std::setprecision(3) << 1e3*phase.seconds
+		<< std::setw(14) << 1e6*phase.seconds/phase.calls
+		<< std::setw(10) << std::setprecision(1) << (total > 0 ? 100*phase.seconds/total : 0) << "\n";
+	}
+	out << std::left << std::setw(26) << "Total" << std::right << std::setw(14) << std::setprecision(3) << 1e3*total
+	<< "  of " << 1e3*this->wallSeconds << " ms wall on " << this->threads << " threads" << std::endl;
+	out.flags(flags);
+	out.precision(precision);
+}
+
+void ProfileReport::WriteJson(std::ostream& out) const {
+	std::streamsize precision = out.precision(17);
+	out << "{\"threads\": " << this->threads << ", \"wall_seconds\": " << this->wallSeconds << ", \"phases\": [";
+	bool first = true;
+	for(int p = 0 ; p < phaseCount ; ++p){
+		const PhaseStatistics& phase = this->phases[p];
+		if(phase.calls == 0)
+			continue;
+		out << (first ? "" : ", ") << "{\"name\": \"" << PhaseName(static_cast<Phase>(p)) << "\", \"calls\": " << phase.calls
+		<< ", \"seconds\": " << phase.seconds << "}";
+		first = false;
+	}
+	out << "]}" << std::endl;
+	out.precision(precision);
+}
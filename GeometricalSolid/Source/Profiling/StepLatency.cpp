@@ -0,0 +1,137 @@
+#include <iomanip>
+#include "../../Include/Profiling/StepLatency.h"
+#include "../../Include/Profiling/Profiler.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	const int phaseCount = static_cast<int>(Phase::Count);
+}
+
+StepLatency::StepLatency(double deadline, std::size_t kept):deadline(0), ticksPerSecond(Profiler::TicksPerSecond()), kept(kept) {
+	this->Deadline(deadline);
+	// Overruns are recorded from the step loop, which must not allocate.
+	this->overruns.reserve(kept);
+	for(auto& ticks : this->current)
+		ticks = 0;
+}
+
+void StepLatency::Deadline(double deadline) {
+	this->deadline = deadline > 0 ? deadline : 0;
+	this->deadlineTicks = static_cast<std::uint64_t>(this->deadline*this->ticksPerSecond);
+}
+
+void StepLatency::Begin() {
+	this->begin = this->last = Profiler::Now();
+}
+
+void StepLatency::Mark(Phase phase) {
+	std::uint64_t now = Profiler::Now();
+	this->current[static_cast<int>(phase)] += now - this->last;
+	this->last = now;
+}
+
+void StepLatency::End(std::uint64_t step) {
+	std::uint64_t ticks = this->last - this->begin;
+	this->steps.Record(ticks);
+	for(int p = 0 ; p < phaseCount ; ++p)
+		this->phases[p].Record(this->current[p]);
+	if(this->deadlineTicks > 0 && ticks > this->deadlineTicks)
+		this->Overrun(step, ticks);
+	for(auto& phaseTicks : this->current)
+		phaseTicks = 0;
+}
+
+void StepLatency::Overrun(std::uint64_t step, std::uint64_t ticks) {
+	int worst = 0;
+	double excess = 0, median = 0;
+	for(int p = 0 ; p < phaseCount ; ++p){
+		double typical = static_cast<double>(this->phases[p].Percentile(0.5));
+		if(p == 0 || this->current[p] - typical > excess){
+			worst = p;
+			excess = this->current[p] - typical;
+			median = typical;
+		}
+	}
+	StepOverrun overrun{step, ticks/this->ticksPerSecond, static_cast<Phase>(worst), this->current[worst]/this->ticksPerSecond, median/this->ticksPerSecond};
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if(this->kept > 0){
+		if(this->overruns.size() < this->kept)
+			this->overruns.push_back(overrun);
+		else
+			this->overruns[this->next] = overrun;
+		this->next = (this->next + 1) % this->kept;
+	}
+	this->overrunCount.store(this->overrunCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+LatencySummary StepLatency::Summarize(const LatencyHistogram& histogram) const {
+	LatencySummary summary;
+	summary.steps = histogram.Count();
+	summary.p50 = histogram.Percentile(0.5)/this->ticksPerSecond;
+	summary.p99 = histogram.Percentile(0.99)/this->ticksPerSecond;
+	summary.p999 = histogram.Percentile(0.999)/this->ticksPerSecond;
+	summary.max = histogram.Max()/this->ticksPerSecond;
+	summary.mean = histogram.Mean()/this->ticksPerSecond;
+	summary.overruns = this->OverrunCount();
+	return summary;
+}
+
+LatencySummary StepLatency::Summary() const {
+	return this->Summarize(this->steps);
+}
+
+LatencySummary StepLatency::Summary(Phase phase) const {
+	return this->Summarize(this->Histogram(phase));
+}
+
+std::vector<StepOverrun> StepLatency::Overruns() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	std::vector<StepOverrun> ordered;
+	ordered.reserve(this->overruns.size());
+	std::size_t first = this->overruns.size() < this->kept ? 0 : this->next;
+	for(std::size_t i = 0 ; i < this->overruns.size() ; ++i)
+		ordered.push_back(this->overruns[(first + i) % this->overruns.size()]);
+	return ordered;
+}
+
+void StepLatency::Reset() {
+	this->steps.Reset();
+	for(auto& histogram : this->phases)
+		histogram.Reset();
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->overruns.clear();
+	this->next = 0;
+	this->overrunCount.store(0, std::memory_order_relaxed);
+}
+
+std::size_t StepLatency::MemoryFootprint() const {
+	std::size_t bytes = this->steps.MemoryFootprint() + this->overruns.capacity()*sizeof(StepOverrun);
+	for(const auto& histogram : this->phases)
+		bytes += histogram.MemoryFootprint();
+	return bytes;
+}
+
+void StepLatency::WriteText(std::ostream& out) const {
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(1);
+	out << std::left << std::setw(12) << "latency (us)" << std::right << std::setw(10) << "p50" << std::setw(10) << "p99"
+	<< std::setw(10) << "p99.9" << std::setw(10) << "max" << "\n";
+	auto line = [&out](const char* name, const LatencySummary& summary){
+		out << std::left << std::setw(12) << name << std::right << std::setw(10) << 1e6*summary.p50 << std::setw(10) << 1e6*summary.p99
+		<< std::setw(10) << 1e6*summary.p999 << std::setw(10) << 1e6*summary.max << "\n";
+	};
+	line("step", this->Summary());
+	for(int p = 0 ; p < phaseCount ; ++p)
+		if(this->phases[p].Max() > 0)
+			line(PhaseName(static_cast<Phase>(p)), this->Summary(static_cast<Phase>(p)));
+	if(this->deadline > 0){
+		out << this->OverrunCount() << " of " << this->steps.Count() << " steps over the " << 1e6*this->deadline << " us deadline\n";
+		for(const auto& overrun : this->Overruns())
+			out << "  step " << overrun.step << ": " << 1e6*overrun.seconds << " us, " << PhaseName(overrun.phase) << " "
+			<< 1e6*overrun.phaseSeconds << " us (median " << 1e6*overrun.phaseMedian << ")\n";
+	}
+	out.flags(flags);
+	out.precision(precision);
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "../../Include/Profiling/Trace.h"
+#include "../../Include/Profiling/Profiler.h"
+
+using namespace GeometricalSolid;
+
+std::atomic<bool> Trace::capturing{false};
+
+namespace {
+	// Filled by its thread only; head is published with release so that a reader
+	// between steps sees complete events.
+	struct Ring{
+		std::vector<TraceEvent> events;
+		std::atomic<std::uint64_t> head{0};
+	};
+	
+	struct Registry{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Ring>> rings;
+		TraceOptions options;
+		bool started{false};
+		std::atomic<std::uint64_t> step{0};
+	};
+	
+	Registry& Instance() {
+		static Registry registry;
+		return registry;
+	}
+	
+	thread_local Ring* localRing = nullptr;
+	thread_local Phase currentPhase = Phase::Count;
+	
+	Ring* Register() {
+		Registry& registry = Instance();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.rings.emplace_back(new Ring());
+		registry.rings.back()->events.resize(std::max<std::size_t>(registry.options.capacity, 1));
+		return registry.rings.back().get();
+	}
+	
+	std::uint64_t Held(const Ring& ring) {
+		return std::min<std::uint64_t>(ring.head.load(std::memory_order_acquire), ring.events.size());
+	}
+}
+
+void Trace::Start(const TraceOptions& options) {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.options = options;
+	registry.started = true;
+	for(auto& ring : registry.rings){
+		ring->events.resize(std::max<std::size_t>(options.capacity, 1));
+		ring->head.store(0, std::memory_order_relaxed);
+	}
+	capturing.store(false, std::memory_order_relaxed);
+}
+
+void Trace::Stop() {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.started = false;
+	capturing.store(false, std::memory_order_relaxed);
+}
+
+void Trace::Step(std::uint64_t step) {
+	Registry& registry = Instance();
+	if(!registry.started)
+		return;
+	registry.step.store(step, std::memory_order_relaxed);
+	const TraceOptions& options = registry.options;
+	capturing.store(step >= options.firstStep && step - options.firstStep < options.steps, std::memory_order_relaxed);
+}
+
+Phase Trace::Enter(Phase phase) {
+	Phase outer = currentPhase;
+	currentPhase = phase;
+	return outer;
+}
+
+void Trace::Leave(Phase outer) {
+	currentPhase = outer;
+}
+
+Phase Trace::Current() {
+	return currentPhase;
+}
+
+void Trace::Record(Phase phase, std::int32_t chunk, std::uint64_t begin, std::uint64_t end) {
+	Ring* ring = localRing;
+	if(ring == nullptr)
+		ring = localRing = Register();
+	std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+	TraceEvent& event = ring->events[head % ring->events.size()];
+	event.begin = begin;
+	event.end = end;
+	event.step = Instance().step.load(std::memory_order_relaxed);
+	event.phase = phase;
+	event.chunk = chunk;
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+std::size_t Trace::Events() {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	std::size_t events = 0;
+	for(const auto& ring : registry.rings)
+		events += Held(*ring);
+	return events;
+}
+
+std::size_t Trace::Overwritten() {
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	std::size_t overwritten = 0;
+	for(const auto& ring : registry.rings)
+		overwritten += ring->head.load(std::memory_order_acquire) - Held(*ring);
+	return overwritten;
+}
+
+void Trace::WriteChromeTrace(std::ostream& out) {
+	double microsecondsPerTick = 1e6/Profiler::TicksPerSecond();
+	Registry& registry = Instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	std::uint64_t origin = UINT64_MAX;
+	for(const auto& ring : registry.rings){
+		std::uint64_t head = ring->head.load(std::memory_order_acquire);
+		for(std::uint64_t i = head - Held(*ring) ; i < head ; ++i)
+			origin = std::min(origin, ring->events[i % ring->events.size()].begin);
+	}
+	
+	std::streamsize precision = out.precision(3);
+	std::ios::fmtflags flags = out.setf(std::ios::fixed, std::ios::floatfield);
+	out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+	const char* separator = "\n";
+	for(std::size_t t = 0 ; t < registry.rings.size() ; ++t){
+		const Ring& ring = *registry.rings[t];
+		out << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << t << ", \"args\": {\"name\": \"Thread " << t << "\"}}";
+		separator = ",\n";
+		std::uint64_t head = ring.head.load(std::memory_order_acquire);
+		for(std::uint64_t i = head - Held(ring) ; i < head ; ++i){
+			const TraceEvent& event = ring.events[i % ring.events.size()];
+			out << separator << "{\"name\": \"" << PhaseName(event.phase) << "\", \"cat\": \"" << (event.chunk < 0 ? "phase" : "chunk")
+			<< "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << t
+			<< ", \"ts\": " << (event.begin - origin)*microsecondsPerTick << ", \"dur\": " << (event.end - event.begin)*microsecondsPerTick
+			<< ", \"args\": {\"step\": " << event.step;
+			if(event.chunk >= 0)
+				out << ", \"chunk\": " << event.chunk;
+			out << "}}";
+		}
+	}
+	out << "\n]}" << std::endl;
+	out.precision(precision);
+	out.flags(flags);
+}
+
+void Trace::WriteChromeTrace(const std::string& path) {
+	std::ofstream out(path.c_str());
+	if(!out)
+		throw(std::runtime_error("Trace: cannot open " + path));
+	WriteChromeTrace(out);
+	if(!out)
+		throw(std::runtime_error("Trace: cannot write " + path));
+}
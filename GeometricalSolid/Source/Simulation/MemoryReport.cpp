@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include "../../Include/Simulation/MemoryReport.h"
+#include "../../Include/Profiling/LatencyHistogram.h"
+#include "../../Include/Profiling/Phase.h"
+#include "../../Include/Profiling/StepLatency.h"
+#include "../../Include/Contact/ContactForceEngine.h"
+#include "../../Include/Sphere.h"
+#include "../../Include/Disk.h"
+#include "../../Include/Rectangle.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	const int subsystemCount = static_cast<int>(Subsystem::Count);
+	// Contacts the engine of a simulation reserves for.
+	const std::size_t expectedContacts = 1024;
+	
+	// Capacity of a vector grown by push_back, which doubles it. Buffers resized to a
+	// count that varies between rebuilds end up at twice the count.
+	std::size_t Grown(std::size_t size) {
+		std::size_t capacity = 1;
+		while(capacity < size)
+			capacity <<= 1;
+		return size == 0 ? 0 : capacity;
+	}
+	
+	// Slots of the contact history, at most half used.
+	std::size_t HistorySlots(std::size_t contacts) {
+		std::size_t capacity = 16;
+		while(capacity < 2*contacts)
+			capacity <<= 1;
+		return capacity;
+	}
+	
+	std::size_t Count(double perSolid, std::size_t bodies) {
+		return static_cast<std::size_t>(std::ceil(perSolid*bodies));
+	}
+}
+
+const char* GeometricalSolid::SubsystemName(Subsystem subsystem) {
+	static const char* names[] = {"Solids", "Shapes", "Neighbors", "Contacts", "Coloring", "Reorder", "Profiling"};
+	return subsystem < Subsystem::Count ? names[static_cast<int>(subsystem)] : "Unknown";
+}
+
+double MemoryReport::PerItem(Subsystem subsystem) const {
+	std::size_t items = this->Items(subsystem);
+	return items > 0 ? static_cast<double>((*this)[subsystem])/items : 0;
+}
+
+std::size_t MemoryReport::Total() const {
+	std::size_t total = 0;
+	for(auto bytes : this->bytes)
+		total += bytes;
+	return total;
+}
+
+MemoryReport MemoryReport::Estimate(std::size_t bodies, const MemoryEstimateOptions& options) {
+	const std::size_t n = bodies;
+	const std::size_t pairs = Count(options.neighborsPerSolid, n);
+	const std::size_t contacts = Count(options.contactsPerSolid, n);
+	// Cells are about the cutoff wide, which holds 2 pi/3 solids per half neighbor entry;
+	// sparse packings are capped as the list caps them.
+	std::size_t cells = 8*n + 1;
+	if(options.neighborsPerSolid > 0)
+		cells = std::min(cells, std::max(Count(2*M_PI/(3*options.neighborsPerSolid), n), static_cast<std::size_t>(1)));
+	std::size_t shapeBytes = options.shapeBytes;
+	if(shapeBytes == 0)
+		shapeBytes = std::max(sizeof(Sphere), std::max(sizeof(Disk), sizeof(Rectangle)));
+	
+	MemoryReport report;
+	std::size_t* bytes = report.bytes;
+	bytes[static_cast<int>(Subsystem::Solids)] = n*sizeof(Solid);
+	bytes[static_cast<int>(Subsystem::Shapes)] = n*shapeBytes;
+	bytes[static_cast<int>(Subsystem::Neighbors)] = (n + 1 + Grown(pairs) + 2*n + cells + 1)*sizeof(std::uint32_t) + 4*n*sizeof(double);
+	// The spare table of a rehash is as large as the live one.
+	bytes[static_cast<int>(Subsystem::Contacts)] = 2*HistorySlots(std::max(contacts, expectedContacts))*sizeof(ContactHistory::Entry);
+	bytes[static_cast<int>(Subsystem::Coloring)] = options.threads > 1 ? (Grown(pairs) + 2*pairs)*sizeof(ContactPair) + 2*pairs*sizeof(std::uint32_t) + n*sizeof(std::uint64_t) : 0;
+	bytes[static_cast<int>(Subsystem::Reorder)] = 2*Grown(n)*sizeof(std::uint32_t) + (options.reorder ? 2*n*sizeof(std::uint32_t) + n*sizeof(std::uint64_t) + (n + 63)/64*8 : 0);
+	bytes[static_cast<int>(Subsystem::Profiling)] = (static_cast<int>(Phase::Count) + 1)*LatencyHistogram::BucketCount()*sizeof(std::atomic<std::uint64_t>) + StepLatency::defaultKept*sizeof(StepOverrun);
+	
+	std::size_t* items = report.items;
+	items[static_cast<int>(Subsystem::Solids)] = n;
+	items[static_cast<int>(Subsystem::Shapes)] = n;
+	items[static_cast<int>(Subsystem::Neighbors)] = pairs;
+	items[static_cast<int>(Subsystem::Contacts)] = contacts;
+	items[static_cast<int>(Subsystem::Coloring)] = options.threads > 1 ? pairs : 0;
+	items[static_cast<int>(Subsystem::Reorder)] = n;
+	items[static_cast<int>(Subsystem::Profiling)] = 0;
+	return report;
+}
+
+double MemoryReport::NeighborsPerSolid(double fraction, double boundingRadius, double volume, double skin) {
+	if(volume <= 0)
+		return 0;
+	double cutoff = 2*boundingRadius + skin;
+	return 0.5*fraction/volume*4./3.*M_PI*cutoff*cutoff*cutoff;
+}
+
+void MemoryReport::WriteText(std::ostream& out) const {
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(1);
+	out << std::left << std::setw(14) << "memory" << std::right << std::setw(12) << "KiB" << std::setw(12) << "items" << std::setw(14) << "bytes/item" << "\n";
+	for(int s = 0 ; s < subsystemCount ; ++s){
+		Subsystem subsystem = static_cast<Subsystem>(s);
+		out << std::left << std::setw(14) << SubsystemName(subsystem) << std::right << std::setw(12) << this->bytes[s]/1024.
+		<< std::setw(12) << this->items[s] << std::setw(14) << this->PerItem(subsystem) << "\n";
+	}
+	out << std::left << std::setw(14) << "total" << std::right << std::setw(12) << this->Total()/1024. << "\n";
+	out.flags(flags);
+	out.precision(precision);
+}
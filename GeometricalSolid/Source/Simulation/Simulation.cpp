@@ -0,0 +1,165 @@
+#include <stdexcept>
+#include "../../Include/Simulation/Simulation.h"
+#include "../../Include/Profiling/Profiler.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+Simulation::Simulation(std::vector<Solid> solids, std::unique_ptr<ContactForceModel> model, const SimulationOptions& options):
+solids(std::move(solids)), options(options), pool(options.threads), neighbors(options.skin), engine(std::move(model)), reorder(options.reorderPeriod), latency(options.deadline), budget(options.budget) {
+	for(const auto& solid : this->solids)
+		if(solid.Shape() == nullptr)
+			throw(std::runtime_error("Simulation: solid without shape"));
+	this->neighbors.Domain(this->options.domain);
+	this->engine.Domain(this->options.domain);
+	// Contact histories follow the solids across reorders.
+	this->engine.Ids(&this->reorder.Ids());
+}
+
+void Simulation::Run(std::size_t steps) {
+	for(std::size_t s = 0 ; s < steps ; ++s)
+		this->Step();
+}
+
+MemoryReport Simulation::Memory() const {
+	MemoryReport report;
+	auto set = [&report](Subsystem subsystem, std::size_t bytes, std::size_t items){
+		report.bytes[static_cast<int>(subsystem)] = bytes;
+		report.items[static_cast<int>(subsystem)] = items;
+	};
+	std::size_t shapeBytes = 0;
+	for(const auto& solid : this->solids)
+		shapeBytes += solid.Shape()->MemoryFootprint();
+	set(Subsystem::Solids, this->solids.capacity()*sizeof(Solid), this->solids.size());
+	set(Subsystem::Shapes, shapeBytes, this->solids.size());
+	set(Subsystem::Neighbors, this->neighbors.MemoryFootprint(), this->neighbors.PairCount());
+	set(Subsystem::Contacts, this->engine.History().MemoryFootprint(), this->engine.ActiveContacts());
+	set(Subsystem::Coloring, this->coloring.MemoryFootprint(), this->coloring.Pairs().size());
+	set(Subsystem::Reorder, this->reorder.MemoryFootprint(), this->solids.size());
+	set(Subsystem::Profiling, this->latency.MemoryFootprint(), 0);
+	return report;
+}
+
+void Simulation::Step() {
+	PROFILE_STEP(this->step);
+	this->latency.Begin();
+	this->budget.Begin();
+	bool reordered = this->UpdateOrder();
+	this->latency.Mark(Phase::Reorder);
+	this->ResetForces();
+	this->latency.Mark(Phase::Forces);
+	bool rebuilt = this->UpdateNeighbors();
+	this->latency.Mark(Phase::Neighbors);
+	this->ApplyContacts();
+	this->latency.Mark(Phase::Contacts);
+	this->UpdateVelocities();
+	this->latency.Mark(Phase::Velocities);
+	this->UpdatePositions();
+	this->latency.Mark(Phase::Positions);
+	++this->step;
+	bool wrote = this->WriteOutput();
+	this->latency.Mark(Phase::Output);
+	this->Account(reordered, rebuilt, wrote);
+	this->latency.End(this->step - 1);
+}
+
+void Simulation::Output(std::function<void(const Simulation&)> writer, std::size_t period) {
+	this->writer = std::move(writer);
+	this->outputPeriod = this->writer ? period : 0;
+	this->outputDeferred = 0;
+}
+
+bool Simulation::UpdateOrder() {
+	PROFILE_PHASE(Reorder);
+	bool due = this->reorderDeferred > 0 || this->reorder.Due(this->step);
+	if(due && this->reorderDeferred < this->reorder.Period()
+	   && this->budget.Defer(Degradation::DeferReorder, this->latency.Elapsed(), this->budget.Required())){
+		++this->reorderDeferred;
+		return false;
+	}
+	bool reordered = this->reorder.Update(this->solids, this->step);
+	if(due && !reordered){
+		this->reorder.Reorder(this->solids);
+		reordered = true;
+	}
+	this->reorderDeferred = 0;
+	if(reordered)
+		this->neighbors.Invalidate();
+	return reordered;
+}
+
+void Simulation::ResetForces() {
+	PROFILE_PHASE(Forces);
+	const Vector<double> gravity = this->options.gravity;
+	this->pool.ParallelFor(this->solids.size(), [this, &gravity](std::size_t begin, std::size_t end, std::size_t){
+		for(std::size_t i = begin ; i < end ; ++i){
+			Solid& solid = this->solids[i];
+			solid.ResetForceAndMomemtum();
+			solid.AddForce(gravity*solid.Shape()->Mass());
+		}
+	});
+}
+
+bool Simulation::UpdateNeighbors() {
+	PROFILE_PHASE(Neighbors);
+	if(!this->neighbors.Update(this->solids))
+		return false;
+	if(this->pool.Size() > 1)
+		this->coloring.Color(this->neighbors);
+	return true;
+}
+
+void Simulation::ApplyContacts() {
+	PROFILE_PHASE(Contacts);
+	if(this->pool.Size() == 1)
+		this->engine.Apply(this->solids, this->neighbors, this->options.timeStep);
+	else
+		this->engine.Apply(this->solids, this->coloring, this->pool, this->options.timeStep);
+}
+
+void Simulation::UpdateVelocities() {
+	PROFILE_PHASE(Velocities);
+	const double dt = this->options.timeStep;
+	this->pool.ParallelFor(this->solids.size(), [this, dt](std::size_t begin, std::size_t end, std::size_t){
+		for(std::size_t i = begin ; i < end ; ++i)
+			this->solids[i].UpdateVelocities(dt);
+	});
+}
+
+void Simulation::UpdatePositions() {
+	PROFILE_PHASE(Positions);
+	const double dt = this->options.timeStep;
+	this->pool.ParallelFor(this->solids.size(), [this, dt](std::size_t begin, std::size_t end, std::size_t){
+		for(std::size_t i = begin ; i < end ; ++i)
+			this->solids[i].UpdatePosition(dt, this->options.domain);
+	});
+}
+
+// Called once the step is counted: a frame holds the state after StepCount steps.
+bool Simulation::WriteOutput() {
+	if(this->outputPeriod == 0 || (this->outputDeferred == 0 && this->step % this->outputPeriod != 0))
+		return false;
+	// A frame waits less than a period, so that it is out before the next one is due.
+	if(this->outputDeferred + 1 < this->outputPeriod && this->budget.Defer(Degradation::DeferOutput, this->latency.Elapsed(), 0)){
+		++this->outputDeferred;
+		return false;
+	}
+	PROFILE_PHASE(Output);
+	this->writer(*this);
+	this->outputDeferred = 0;
+	return true;
+}
+
+// Costs of the deferrable work as last measured, and of the rest of the step.
+void Simulation::Account(bool reordered, bool rebuilt, bool wrote) {
+	std::uint64_t reorderTicks = this->latency.Ticks(Phase::Reorder);
+	std::uint64_t neighborTicks = this->latency.Ticks(Phase::Neighbors);
+	std::uint64_t outputTicks = this->latency.Ticks(Phase::Output);
+	if(reordered)
+		this->budget.Cost(Degradation::DeferReorder, reorderTicks + neighborTicks);
+	if(wrote)
+		this->budget.Cost(Degradation::DeferOutput, outputTicks);
+	if(!reordered && !rebuilt)
+		this->budget.Required(this->latency.Elapsed() - reorderTicks - outputTicks);
+	this->budget.End(this->latency.Elapsed());
+}
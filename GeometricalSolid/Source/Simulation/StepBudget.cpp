@@ -0,0 +1,80 @@
+#include <iomanip>
+#include "../../Include/Simulation/StepBudget.h"
+#include "../../Include/Profiling/Profiler.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	const int degradationCount = static_cast<int>(Degradation::Count);
+	// Weight of the last step in the estimate of the required work.
+	const double requiredWeight = 1./8;
+}
+
+const char* GeometricalSolid::DegradationName(Degradation degradation) {
+	static const char* names[] = {"defer_reorder", "defer_output"};
+	return degradation < Degradation::Count ? names[static_cast<int>(degradation)] : "unknown";
+}
+
+StepBudget::StepBudget(double seconds):seconds(0), ticksPerSecond(Profiler::TicksPerSecond()) {
+	for(auto& ticks : this->cost)
+		ticks = 0;
+	this->Seconds(seconds);
+	this->Reset();
+}
+
+void StepBudget::Seconds(double seconds) {
+	this->seconds = seconds > 0 ? seconds : 0;
+	this->budgetTicks = static_cast<std::uint64_t>(this->seconds*this->ticksPerSecond);
+	this->report.budget = this->seconds;
+}
+
+void StepBudget::Begin() {
+	this->current = 0;
+}
+
+bool StepBudget::Defer(Degradation work, std::uint64_t elapsed, std::uint64_t reserved) {
+	if(!this->Enabled() || this->Cost(work) == 0 || elapsed + this->Cost(work) + reserved <= this->budgetTicks)
+		return false;
+	this->current |= 1u << static_cast<int>(work);
+	return true;
+}
+
+void StepBudget::Required(std::uint64_t ticks) {
+	this->required = this->required == 0 ? ticks : this->required + requiredWeight*(ticks - this->required);
+}
+
+void StepBudget::End(std::uint64_t ticks) {
+	this->last = this->current;
+	if(!this->Enabled())
+		return;
+	++this->report.steps;
+	if(this->current != 0)
+		++this->report.degraded;
+	if(ticks > this->budgetTicks)
+		++this->report.overruns;
+	for(int d = 0 ; d < degradationCount ; ++d)
+		if(this->current & 1u << d)
+			++this->report.applied[d];
+}
+
+BudgetReport StepBudget::Report() const {
+	return this->report;
+}
+
+void StepBudget::Reset() {
+	this->report.budget = this->seconds;
+	this->report.steps = this->report.degraded = this->report.overruns = 0;
+	for(auto& count : this->report.applied)
+		count = 0;
+}
+
+void BudgetReport::WriteText(std::ostream& out) const {
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(1) << "budget " << 1e6*this->budget << " us: " << this->steps << " steps, "
+	<< this->degraded << " degraded, " << this->overruns << " over budget\n";
+	for(int d = 0 ; d < degradationCount ; ++d)
+		out << "  " << std::left << std::setw(16) << DegradationName(static_cast<Degradation>(d)) << std::right << this->applied[d] << "\n";
+	out.flags(flags);
+	out.precision(precision);
+}
@@ -0,0 +1,86 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "../../Include/Snapshot/CheckpointReader.h"
+#include "../../Include/Snapshot/SnapshotReader.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+CheckpointReader::CheckpointReader(const std::string& directory):directory(directory) {
+	std::string path = directory + "/" + Checkpoint::manifestName;
+	std::ifstream in(path.c_str());
+	if(!in)
+		throw(std::runtime_error("CheckpointReader: no checkpoint in " + directory));
+	std::string magic, key;
+	std::uint32_t version = 0;
+	in >> magic >> version;
+	if(magic != Checkpoint::manifestMagic)
+		throw(std::runtime_error("CheckpointReader: " + path + " is not a checkpoint manifest"));
+	if(version != Checkpoint::manifestVersion)
+		throw(std::runtime_error("CheckpointReader: unsupported manifest version in " + path));
+	while(in >> key){
+		if(key == "sequence")
+			in >> this->manifest.sequence;
+		else if(key == "step")
+			in >> this->manifest.step;
+		else if(key == "time")
+			in >> this->manifest.time;
+		else if(key == "solids")
+			in >> this->manifest.solidCount;
+		else if(key == "base")
+			in >> this->manifest.base;
+		else if(key == "delta"){
+			this->manifest.deltas.push_back(std::string());
+			in >> this->manifest.deltas.back();
+		}
+		else
+			throw(std::runtime_error("CheckpointReader: unknown entry " + key + " in " + path));
+	}
+	if(this->manifest.base.empty())
+		throw(std::runtime_error("CheckpointReader: " + path + " names no base snapshot"));
+}
+
+bool CheckpointReader::Exists(const std::string& directory) {
+	return std::ifstream((directory + "/" + Checkpoint::manifestName).c_str()).good();
+}
+
+void CheckpointReader::Load(std::vector<Solid>& solids) const {
+	SnapshotReader(this->directory + "/" + this->manifest.base).Load(solids);
+	for(const auto& delta : this->manifest.deltas)
+		this->ApplyDelta(delta, solids);
+	if(solids.size() != this->manifest.solidCount)
+		throw(std::runtime_error("CheckpointReader: solid count of " + this->directory + " does not match its manifest"));
+	for(auto& solid : solids){
+		solid.ResetForceAndMomemtum();
+		solid.ClearDirty();
+	}
+}
+
+void CheckpointReader::ApplyDelta(const std::string& name, std::vector<Solid>& solids) const {
+	std::string path = this->directory + "/" + name;
+	std::ifstream in(path.c_str(), std::ios::binary);
+	Checkpoint::DeltaHeader header;
+	if(!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, Checkpoint::deltaMagic, sizeof(header.magic)) != 0)
+		throw(std::runtime_error("CheckpointReader: " + path + " is not a checkpoint delta"));
+	if(header.byteOrderMark != Snapshot::byteOrderMark)
+		throw(std::runtime_error("CheckpointReader: " + path + " was written with another byte order"));
+	if(header.version != Checkpoint::deltaVersion)
+		throw(std::runtime_error("CheckpointReader: unsupported delta version in " + path));
+	if(header.solidCount != solids.size() || header.fileSize != sizeof(header) + header.recordCount*sizeof(Checkpoint::DeltaRecord))
+		throw(std::runtime_error("CheckpointReader: " + path + " does not match its base"));
+	
+	Checkpoint::DeltaRecord record;
+	for(std::uint64_t r = 0 ; r < header.recordCount ; ++r){
+		if(!in.read(reinterpret_cast<char*>(&record), sizeof(record)) || record.index >= solids.size())
+			throw(std::runtime_error("CheckpointReader: " + path + " is truncated"));
+		Solid& solid = solids[record.index];
+		solid.Shape(SnapshotReader::MakeShape(record.shape));
+		solid.Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(record.origin[0], record.origin[1], record.origin[2]),
+														   Quaternion<double>(record.orientation[0], record.orientation[1], record.orientation[2], record.orientation[3])));
+		solid.Velocity(Vector<double>(record.velocity[0], record.velocity[1], record.velocity[2]));
+		solid.AngularVelocity(Vector<double>(record.angularVelocity[0], record.angularVelocity[1], record.angularVelocity[2]));
+		solid.LockTranslation(record.locks & 1, record.locks & 2, record.locks & 4);
+		solid.LockRotation(record.locks & 8, record.locks & 16, record.locks & 32);
+	}
+}
@@ -0,0 +1,166 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../Include/Snapshot/CheckpointWriter.h"
+#include "../../Include/Snapshot/CheckpointReader.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	// Files and the directory entry must reach the disk before the manifest names them.
+	void Sync(const std::string& path) {
+		int file = open(path.c_str(), O_RDONLY);
+		if(file < 0)
+			throw(std::runtime_error("CheckpointWriter: cannot open " + path));
+		int result = fsync(file);
+		close(file);
+		if(result != 0)
+			throw(std::runtime_error("CheckpointWriter: cannot sync " + path));
+	}
+	
+	std::uint64_t FileSize(const std::string& path) {
+		struct stat status;
+		return stat(path.c_str(), &status) == 0 ? status.st_size : 0;
+	}
+	
+	void Put(double* target, const Vector<double>& v) {
+		target[0] = v.ComponantX();
+		target[1] = v.ComponantY();
+		target[2] = v.ComponantZ();
+	}
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& directory, const CheckpointOptions& options):directory(directory), options(options) {
+	if(mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+		throw(std::runtime_error("CheckpointWriter: cannot create " + directory));
+	if(CheckpointReader::Exists(directory))
+		this->manifest = CheckpointReader(directory).Manifest();
+}
+
+std::string CheckpointWriter::NextName(const char* kind, const char* extension) const {
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s-%08llu.%s", kind, static_cast<unsigned long long>(this->manifest.sequence + 1), extension);
+	return name;
+}
+
+std::size_t CheckpointWriter::Write(std::vector<Solid>& solids, std::uint64_t step, double time) {
+	std::size_t dirtyCount = 0;
+	for(const auto& solid : solids)
+		dirtyCount += solid.IsDirty();
+	bool full = this->manifest.base.empty() || this->manifest.solidCount != solids.size()
+		|| this->manifest.deltas.size() >= this->options.maximumDeltas || dirtyCount > this->options.fullFraction*solids.size();
+	
+	Checkpoint::Manifest next = this->manifest;
+	++next.sequence;
+	next.step = step;
+	next.time = time;
+	next.solidCount = solids.size();
+	std::string name = full ? this->NextName("base", "snap") : this->NextName("delta", "bin");
+	std::size_t written;
+	if(full){
+		this->snapshotWriter.Write(this->Path(name), solids, step, time);
+		this->statistics.bytes += FileSize(this->Path(name));
+		next.base = name;
+		next.deltas.clear();
+		written = solids.size();
+		++this->statistics.fullCheckpoints;
+	}
+	else{
+		this->statistics.bytes += this->WriteDelta(this->Path(name), solids, dirtyCount, step, time);
+		next.deltas.push_back(name);
+		written = dirtyCount;
+		++this->statistics.deltaCheckpoints;
+	}
+	Sync(this->Path(name));
+	this->Commit(next);
+	
+	// The previous chain is unreachable once the new base is committed.
+	if(full && !this->manifest.base.empty()){
+		std::remove(this->Path(this->manifest.base).c_str());
+		for(const auto& delta : this->manifest.deltas)
+			std::remove(this->Path(delta).c_str());
+	}
+	this->manifest = next;
+	for(auto& solid : solids)
+		solid.ClearDirty();
+	this->statistics.solidsWritten += written;
+	return written;
+}
+
+std::uint64_t CheckpointWriter::WriteDelta(const std::string& path, const std::vector<Solid>& solids, std::size_t dirtyCount, std::uint64_t step, double time) {
+	this->records.resize(dirtyCount);
+	std::size_t r = 0;
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		const Solid& solid = solids[i];
+		if(!solid.IsDirty())
+			continue;
+		if(solid.Shape() == nullptr)
+			throw(std::runtime_error("CheckpointWriter: solid without shape"));
+		Checkpoint::DeltaRecord& record = this->records[r++];
+		std::memset(&record, 0, sizeof(record));
+		record.index = static_cast<std::uint32_t>(i);
+		record.locks = SnapshotWriter::Locks(solid);
+		record.shape = SnapshotWriter::Record(*solid.Shape());
+		const Point<double> origin = solid.Basis().Origin();
+		record.origin[0] = origin.CoordinateX();
+		record.origin[1] = origin.CoordinateY();
+		record.origin[2] = origin.CoordinateZ();
+		const Quaternion<double> q = solid.Basis().Orientation();
+		record.orientation[0] = q.ComponantReal();
+		record.orientation[1] = q.ComponantI();
+		record.orientation[2] = q.ComponantJ();
+		record.orientation[3] = q.ComponantK();
+		Put(record.velocity, solid.Velocity());
+		Put(record.angularVelocity, solid.AngularVelocity());
+	}
+	
+	Checkpoint::DeltaHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, Checkpoint::deltaMagic, sizeof(header.magic));
+	header.version = Checkpoint::deltaVersion;
+	header.byteOrderMark = Snapshot::byteOrderMark;
+	header.fileSize = sizeof(header) + dirtyCount*sizeof(Checkpoint::DeltaRecord);
+	header.solidCount = solids.size();
+	header.recordCount = dirtyCount;
+	header.step = step;
+	header.time = time;
+	
+	std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+	if(!out)
+		throw(std::runtime_error("CheckpointWriter: cannot open " + path));
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(this->records.data()), dirtyCount*sizeof(Checkpoint::DeltaRecord));
+	out.close();
+	if(!out)
+		throw(std::runtime_error("CheckpointWriter: cannot write " + path));
+	return header.fileSize;
+}
+
+void CheckpointWriter::Commit(const Checkpoint::Manifest& next) {
+	std::string temporary = this->Path(std::string(Checkpoint::manifestName) + ".tmp");
+	std::ofstream out(temporary.c_str(), std::ios::trunc);
+	if(!out)
+		throw(std::runtime_error("CheckpointWriter: cannot open " + temporary));
+	out.precision(17);
+	out << Checkpoint::manifestMagic << " " << Checkpoint::manifestVersion << "\n"
+	<< "sequence " << next.sequence << "\n"
+	<< "step " << next.step << "\n"
+	<< "time " << next.time << "\n"
+	<< "solids " << next.solidCount << "\n"
+	<< "base " << next.base << "\n";
+	for(const auto& delta : next.deltas)
+		out << "delta " << delta << "\n";
+	out.close();
+	if(!out)
+		throw(std::runtime_error("CheckpointWriter: cannot write " + temporary));
+	Sync(temporary);
+	if(std::rename(temporary.c_str(), this->Path(Checkpoint::manifestName).c_str()) != 0)
+		throw(std::runtime_error("CheckpointWriter: cannot replace the manifest in " + this->directory));
+	Sync(this->directory);
+}
@@ -0,0 +1,109 @@
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../Include/Snapshot/SnapshotReader.h"
+#include "../../Include/Sphere.h"
+#include "../../Include/Disk.h"
+#include "../../Include/Rectangle.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+SnapshotReader::SnapshotReader(const std::string& path) {
+	int file = open(path.c_str(), O_RDONLY);
+	if(file < 0)
+		throw(std::runtime_error("SnapshotReader: cannot open " + path));
+	struct stat status;
+	if(fstat(file, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(Snapshot::Header))){
+		close(file);
+		throw(std::runtime_error("SnapshotReader: " + path + " is not a snapshot"));
+	}
+	this->size = status.st_size;
+	void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if(mapping == MAP_FAILED)
+		throw(std::runtime_error("SnapshotReader: cannot map " + path));
+	this->data = static_cast<const char*>(mapping);
+	this->header = reinterpret_cast<const Snapshot::Header*>(this->data);
+	try{
+		this->Validate(path);
+	}
+	catch(...){
+		munmap(const_cast<char*>(this->data), this->size);
+		throw;
+	}
+}
+
+SnapshotReader::~SnapshotReader() {
+	munmap(const_cast<char*>(this->data), this->size);
+}
+
+void SnapshotReader::Validate(const std::string& path) const {
+	const Snapshot::Header& header = *this->header;
+	if(std::memcmp(header.magic, Snapshot::magic, sizeof(header.magic)) != 0)
+		throw(std::runtime_error("SnapshotReader: " + path + " is not a snapshot"));
+	if(header.byteOrderMark != Snapshot::byteOrderMark)
+		throw(std::runtime_error("SnapshotReader: " + path + " was written with another byte order"));
+	if(header.version != Snapshot::version)
+		throw(std::runtime_error("SnapshotReader: unsupported snapshot version in " + path));
+	if(header.fileSize != this->size)
+		throw(std::runtime_error("SnapshotReader: " + path + " is truncated"));
+	
+	if(header.shapeTableOffset % Snapshot::alignment != 0 || header.shapeTableOffset + header.shapeCount*sizeof(Snapshot::ShapeRecord) > this->size)
+		throw(std::runtime_error("SnapshotReader: corrupted shape table in " + path));
+	for(int column = 0 ; column < Snapshot::ColumnCount ; ++column){
+		std::uint64_t offset = header.columnOffset[column];
+		if(offset % Snapshot::alignment != 0 || offset + header.solidCount*Snapshot::ComponentSize(static_cast<Snapshot::Column>(column)) > this->size)
+			throw(std::runtime_error("SnapshotReader: corrupted column in " + path));
+	}
+}
+
+std::unique_ptr<GeometricalSolid::Shape> SnapshotReader::MakeShape(std::size_t shape) const {
+	if(shape >= this->ShapeCount())
+		throw(std::runtime_error("SnapshotReader: shape index out of range"));
+	return MakeShape(this->Shapes()[shape]);
+}
+
+std::unique_ptr<GeometricalSolid::Shape> SnapshotReader::MakeShape(const Snapshot::ShapeRecord& record) {
+	switch(static_cast<enum Shape::Form>(record.form)){
+		case Shape::Form::Sphere:
+			return std::unique_ptr<GeometricalSolid::Shape>(new Sphere(record.parameters[0], record.parameters[1]));
+		case Shape::Form::Disk:
+			return std::unique_ptr<GeometricalSolid::Shape>(new Disk(record.parameters[0], record.parameters[1], record.parameters[2]));
+		case Shape::Form::Rectangle:
+			return std::unique_ptr<GeometricalSolid::Shape>(new Rectangle(record.parameters[0], record.parameters[1], record.parameters[2], record.parameters[3]));
+		default:
+			throw(std::runtime_error("SnapshotReader: unsupported shape"));
+	}
+}
+
+void SnapshotReader::Restore(std::size_t index, Solid& solid) const {
+	const double* origin = this->Origins() + 3*index;
+	const double* orientation = this->Orientations() + 4*index;
+	const double* velocity = this->Velocities() + 3*index;
+	const double* angularVelocity = this->AngularVelocities() + 3*index;
+	const double* force = this->Forces() + 3*index;
+	const double* momentum = this->Momentums() + 3*index;
+	std::uint8_t locks = this->Locks()[index];
+	
+	solid.Shape(this->MakeShape(this->ShapeIndices()[index]));
+	solid.Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(origin[0], origin[1], origin[2]), Quaternion<double>(orientation[0], orientation[1], orientation[2], orientation[3])));
+	solid.Velocity(Vector<double>(velocity[0], velocity[1], velocity[2]));
+	solid.AngularVelocity(Vector<double>(angularVelocity[0], angularVelocity[1], angularVelocity[2]));
+	solid.Force(Vector<double>(force[0], force[1], force[2]));
+	solid.Momentum(Vector<double>(momentum[0], momentum[1], momentum[2]));
+	solid.LockTranslation(locks & 1, locks & 2, locks & 4);
+	solid.LockRotation(locks & 8, locks & 16, locks & 32);
+}
+
+void SnapshotReader::Load(std::vector<Solid>& solids) const {
+	solids.clear();
+	solids.reserve(this->SolidCount());
+	for(std::size_t i = 0 ; i < this->SolidCount() ; ++i){
+		solids.emplace_back(std::unique_ptr<GeometricalSolid::Shape>());
+		this->Restore(i, solids.back());
+	}
+}
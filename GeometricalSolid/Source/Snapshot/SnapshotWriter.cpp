@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "../../Include/Snapshot/SnapshotWriter.h"
+#include "../../Include/Sphere.h"
+#include "../../Include/Disk.h"
+#include "../../Include/Rectangle.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	const std::size_t bufferSize = 1 << 16;
+	
+	// Shape records are hashed (FNV-1a) and compared bytewise.
+	struct RecordHash{
+		std::size_t operator()(const Snapshot::ShapeRecord& record) const {
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+			std::uint64_t hash = 14695981039346656037ull;
+			for(std::size_t i = 0 ; i < sizeof(record) ; ++i)
+				hash = (hash ^ bytes[i])*1099511628211ull;
+			return static_cast<std::size_t>(hash);
+		}
+	};
+	
+	struct RecordEqual{
+		bool operator()(const Snapshot::ShapeRecord& a, const Snapshot::ShapeRecord& b) const {
+			return std::memcmp(&a, &b, sizeof(Snapshot::ShapeRecord)) == 0;
+		}
+	};
+	
+	void Padding(std::ostream& out, std::uint64_t position) {
+		static const char zeros[Snapshot::alignment] = {};
+		out.write(zeros, Snapshot::Align(position) - position);
+	}
+	
+	void Put(char* target, const Vector<double>& v) {
+		double values[3] = {v.ComponantX(), v.ComponantY(), v.ComponantZ()};
+		std::memcpy(target, values, sizeof(values));
+	}
+}
+
+Snapshot::ShapeRecord SnapshotWriter::Record(const GeometricalSolid::Shape& shape) {
+	Snapshot::ShapeRecord record;
+	std::memset(&record, 0, sizeof(record));
+	record.form = static_cast<std::uint32_t>(shape.Form());
+	record.nature = static_cast<std::uint32_t>(shape.Nature());
+	switch(shape.Form()){
+		case Shape::Form::Sphere:
+			record.parameters[0] = static_cast<const Sphere&>(shape).Radius();
+			record.parameters[1] = static_cast<const Sphere&>(shape).Density();
+			break;
+		case Shape::Form::Disk:
+			record.parameters[0] = static_cast<const Disk&>(shape).Radius();
+			record.parameters[1] = static_cast<const Disk&>(shape).Thickness();
+			record.parameters[2] = static_cast<const Disk&>(shape).Density();
+			break;
+		case Shape::Form::Rectangle:
+			record.parameters[0] = static_cast<const Rectangle&>(shape).Lenght();
+			record.parameters[1] = static_cast<const Rectangle&>(shape).Width();
+			record.parameters[2] = static_cast<const Rectangle&>(shape).Thickness();
+			record.parameters[3] = static_cast<const Rectangle&>(shape).Density();
+			break;
+		default:
+			throw(std::runtime_error("SnapshotWriter: unsupported shape"));
+	}
+	return record;
+}
+
+std::uint8_t SnapshotWriter::Locks(const Solid& solid) {
+	return static_cast<std::uint8_t>(solid.IsXTranslationLocked() | solid.IsYTranslationLocked() << 1 | solid.IsZTranslationLocked() << 2
+									 | solid.IsXRotationLocked() << 3 | solid.IsYRotationLocked() << 4 | solid.IsZRotationLocked() << 5);
+}
+
+void SnapshotWriter::Write(const std::string& path, const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+	if(!out)
+		throw(std::runtime_error("SnapshotWriter: cannot open " + path));
+	this->Write(out, solids, step, time);
+	out.close();
+	if(!out)
+		throw(std::runtime_error("SnapshotWriter: cannot write " + path));
+}
+
+void SnapshotWriter::Write(std::ostream& out, const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	this->BuildShapeTable(solids);
+	
+	Snapshot::Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, Snapshot::magic, sizeof(header.magic));
+	header.version = Snapshot::version;
+	header.byteOrderMark = Snapshot::byteOrderMark;
+	header.solidCount = solids.size();
+	header.shapeCount = this->shapes.size();
+	header.step = step;
+	header.time = time;
+	std::uint64_t offset = Snapshot::Align(sizeof(header));
+	header.shapeTableOffset = offset;
+	offset += this->shapes.size()*sizeof(Snapshot::ShapeRecord);
+	for(int column = 0 ; column < Snapshot::ColumnCount ; ++column){
+		offset = Snapshot::Align(offset);
+		header.columnOffset[column] = offset;
+		offset += solids.size()*Snapshot::ComponentSize(static_cast<Snapshot::Column>(column));
+	}
+	header.fileSize = offset;
+	
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	Padding(out, sizeof(header));
+	out.write(reinterpret_cast<const char*>(this->shapes.data()), this->shapes.size()*sizeof(Snapshot::ShapeRecord));
+	std::uint64_t position = header.shapeTableOffset + this->shapes.size()*sizeof(Snapshot::ShapeRecord);
+	for(int column = 0 ; column < Snapshot::ColumnCount ; ++column){
+		Padding(out, position);
+		this->WriteColumn(out, solids, static_cast<Snapshot::Column>(column));
+		position = header.columnOffset[column] + solids.size()*Snapshot::ComponentSize(static_cast<Snapshot::Column>(column));
+	}
+	if(!out)
+		throw(std::runtime_error("SnapshotWriter: write failed"));
+}
+
+void SnapshotWriter::BuildShapeTable(const std::vector<Solid>& solids) {
+	// Solids sharing a shape usually come in runs, so the last match is tried
+	// before the lookup.
+	this->shapes.clear();
+	this->shapeIndices.resize(solids.size());
+	std::unordered_map<Snapshot::ShapeRecord, std::uint32_t, RecordHash, RecordEqual> lookup;
+	RecordEqual same;
+	std::uint32_t last = 0;
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		if(solids[i].Shape() == nullptr)
+			throw(std::runtime_error("SnapshotWriter: solid without shape"));
+		Snapshot::ShapeRecord record = Record(*solids[i].Shape());
+		if(this->shapes.empty() || !same(record, this->shapes[last])){
+			auto inserted = lookup.emplace(record, static_cast<std::uint32_t>(this->shapes.size()));
+			if(inserted.second)
+				this->shapes.push_back(record);
+			last = inserted.first->second;
+		}
+		this->shapeIndices[i] = last;
+	}
+}
+
+void SnapshotWriter::WriteColumn(std::ostream& out, const std::vector<Solid>& solids, Snapshot::Column column) {
+	std::size_t componentSize = Snapshot::ComponentSize(column);
+	std::size_t perBuffer = bufferSize/componentSize;
+	this->buffer.resize(perBuffer*componentSize);
+	for(std::size_t begin = 0 ; begin < solids.size() ; begin += perBuffer){
+		std::size_t end = std::min(begin + perBuffer, solids.size());
+		char* target = this->buffer.data();
+		for(std::size_t i = begin ; i < end ; ++i, target += componentSize){
+			const Solid& solid = solids[i];
+			switch(column){
+				case Snapshot::ShapeIndex:
+					std::memcpy(target, &this->shapeIndices[i], sizeof(std::uint32_t));
+					break;
+				case Snapshot::Locks:
+					*target = static_cast<char>(Locks(solid));
+					break;
+				case Snapshot::Origin:{
+					const Point<double> origin = solid.Basis().Origin();
+					double values[3] = {origin.CoordinateX(), origin.CoordinateY(), origin.CoordinateZ()};
+					std::memcpy(target, values, sizeof(values));
+					break;
+				}
+				case Snapshot::Orientation:{
+					const Quaternion<double> q = solid.Basis().Orientation();
+					double values[4] = {q.ComponantReal(), q.ComponantI(), q.ComponantJ(), q.ComponantK()};
+					std::memcpy(target, values, sizeof(values));
+					break;
+				}
+				case Snapshot::Velocity: Put(target, solid.Velocity()); break;
+				case Snapshot::AngularVelocity: Put(target, solid.AngularVelocity()); break;
+				case Snapshot::Force: Put(target, solid.Force()); break;
+				case Snapshot::Momentum: Put(target, solid.Momentum()); break;
+				default: break;
+			}
+		}
+		out.write(this->buffer.data(), (end - begin)*componentSize);
+	}
+}
@@ -6,7 +6,18 @@
 using namespace GeometricalSolid;
 using namespace GeometricalSpaceObjects;
 
-Solid::Solid(std::unique_ptr<GeometricalSolid::Shape> shape):basis(),velocity(0,0,0),angularVelocity(0,0,0),force(0,0,0),momentum(0,0,0), lockVelocity(1,1,1), lockAngularVelocity(1,1,1), shape(std::move(shape)) {}
+namespace {
+	// Exact comparisons: operator== of Vector has a tolerance.
+	bool IsZero(const Vector<double>& v) {
+		return v.ComponantX() == 0 && v.ComponantY() == 0 && v.ComponantZ() == 0;
+	}
+	
+	bool Differs(const Vector<double>& a, const Vector<double>& b) {
+		return a.ComponantX() != b.ComponantX() || a.ComponantY() != b.ComponantY() || a.ComponantZ() != b.ComponantZ();
+	}
+}
+
+Solid::Solid(std::unique_ptr<GeometricalSolid::Shape> shape):basis(),velocity(0,0,0),angularVelocity(0,0,0),force(0,0,0),momentum(0,0,0), lockVelocity(1,1,1), lockAngularVelocity(1,1,1), shape(std::move(shape)), dirty(true) {}
 
 Solid::~Solid() {}
 
@@ -22,11 +33,11 @@ const Vector<double>& Solid::Force() const{return force;}
 
 const Vector<double>& Solid::Momentum() const{return momentum;}
 
-void Solid::Basis(const GeometricalSpaceObjects::Basis<double> & basis){this->basis = basis;}
+void Solid::Basis(const GeometricalSpaceObjects::Basis<double> & basis){this->basis = basis; this->dirty = true;}
 
-void Solid::Velocity(const Vector<double> & v) {this->velocity = v;}
+void Solid::Velocity(const Vector<double> & v) {this->velocity = v; this->dirty = true;}
 
-void Solid::AngularVelocity(const Vector<double>& w) {this->angularVelocity = w;}
+void Solid::AngularVelocity(const Vector<double>& w) {this->angularVelocity = w; this->dirty = true;}
 
 void Solid::Force(const Vector<double>& f) {this->force = f;}
 
@@ -34,6 +45,7 @@ void Solid::Momentum(const Vector<double>& m) {this->momentum = m;}
 
 void Solid::Shape(std::unique_ptr<GeometricalSolid::Shape> shape) {
 	this->shape = std::move(shape);
+	this->dirty = true;
 }
 
 void Solid::AddForce(const GeometricalSpaceObjects::Vector<double> & force) {
@@ -45,6 +57,8 @@ void Solid::AddMomentum(const GeometricalSpaceObjects::Vector<double> momentum){
 }
 
 void Solid::UpdateVelocities(double dt){
+	Vector<double> previousVelocity = this->velocity;
+	Vector<double> previousAngularVelocity = this->angularVelocity;
   velocity += dt*force/(this->shape->Mass());
 	localMomentum = momentum;
 	basis.Local(localMomentum);
@@ -58,11 +72,21 @@ void Solid::UpdateVelocities(double dt){
 	this->angularVelocity.ComponantX(this->angularVelocity.ComponantX() * this->lockAngularVelocity.ComponantX());
 	this->angularVelocity.ComponantY(this->angularVelocity.ComponantY() * this->lockAngularVelocity.ComponantY());
 	this->angularVelocity.ComponantZ(this->angularVelocity.ComponantZ() * this->lockAngularVelocity.ComponantZ());
+	
+	this->dirty |= Differs(this->velocity, previousVelocity) || Differs(this->angularVelocity, previousAngularVelocity);
 }
 
 void Solid::UpdatePosition(double dt){
+	if(IsZero(this->velocity) && IsZero(this->angularVelocity))
+		return;
 	basis += dt*velocity;
 	basis *= Quaternion<double>(angularVelocity*dt);
+	this->dirty = true;
+}
+
+void Solid::UpdatePosition(double dt, const PeriodicBox<double>& domain){
+	this->UpdatePosition(dt);
+	basis.Origin(domain.Wrapped(basis.Origin()));
 }
 
 void Solid::ResetForceAndMomemtum(){
@@ -72,21 +96,30 @@ void Solid::ResetForceAndMomemtum(){
 
 void Solid::LockTranslation(bool xAxis, bool yAxis, bool zAxis) {
 	this->lockVelocity.SetComponants(xAxis ? 0 : 1, yAxis ? 0 : 1, zAxis ? 0 : 1);
+	this->dirty = true;
 }
 
 void Solid::LockRotation(bool xAxis, bool yAxis, bool zAxis) {
 	this->lockAngularVelocity.SetComponants(xAxis ? 0 : 1, yAxis ? 0 : 1, zAxis ? 0 : 1);
+	this->dirty = true;
 }
 
-bool Solid::IsXTranslationLocked() { return this->lockVelocity.ComponantX() == 0; }
-bool Solid::IsYTranslationLocked() { return this->lockVelocity.ComponantY() == 0; }
-bool Solid::IsZTranslationLocked() { return this->lockVelocity.ComponantZ() == 0; }
+bool Solid::IsXTranslationLocked() const { return this->lockVelocity.ComponantX() == 0; }
+bool Solid::IsYTranslationLocked() const { return this->lockVelocity.ComponantY() == 0; }
+bool Solid::IsZTranslationLocked() const { return this->lockVelocity.ComponantZ() == 0; }
+
+bool Solid::IsXRotationLocked() const { return this->lockAngularVelocity.ComponantX() == 0; }
+bool Solid::IsYRotationLocked() const { return this->lockAngularVelocity.ComponantY() == 0; }
+bool Solid::IsZRotationLocked() const { return this->lockAngularVelocity.ComponantZ() == 0; }
+
+bool Solid::IsDirty() const { return this->dirty; }
+
+void Solid::MarkDirty() { this->dirty = true; }
 
-bool Solid::IsXRotationLocked() { return this->lockAngularVelocity.ComponantX() == 0; }
-bool Solid::IsYRotationLocked() { return this->lockAngularVelocity.ComponantY() == 0; }
-bool Solid::IsZRotationLocked() { return this->lockAngularVelocity.ComponantZ() == 0; }
+void Solid::ClearDirty() { this->dirty = false; }
 
 void Solid::LoadFromIstream(std::istream & in){
 	in >> this->basis >> this->velocity >> this->angularVelocity >> this->force >> this->momentum;
+	this->dirty = true;
 }
 
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "../../Include/Trajectory/CompressedFrameCodec.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	const double inverseSqrt2 = 0.70710678118654752440;
+	
+	void PutVarint(std::string& out, std::int64_t value) {
+		std::uint64_t zigzag = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+		while(zigzag >= 0x80){
+			out.push_back(static_cast<char>(zigzag | 0x80));
+			zigzag >>= 7;
+		}
+		out.push_back(static_cast<char>(zigzag));
+	}
+	
+	std::int64_t GetVarint(const unsigned char*& in, const unsigned char* end) {
+		std::uint64_t zigzag = 0;
+		for(int shift = 0 ; ; shift += 7){
+			if(in == end || shift > 63)
+				throw(std::runtime_error("CompressedTrajectoryReader: corrupted frame"));
+			unsigned char byte = *in++;
+			zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if(byte < 0x80)
+				break;
+		}
+		return static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+	}
+	
+	std::int64_t Round(double value) {
+		return static_cast<std::int64_t>(std::llround(value));
+	}
+}
+
+void FrameQuantizer::Quantize(const TrajectoryFrame& frame, const CompressedFrameHeader& header, std::vector<std::int64_t>& values) {
+	std::size_t n = frame.SolidCount();
+	bool velocities = header.flags & CompressedFrameHeader::velocities;
+	values.resize(FieldCount(velocities)*n);
+	double scale = ((std::int64_t(1) << (header.orientationBits - 1)) - 1)/inverseSqrt2;
+	for(std::size_t i = 0 ; i < n ; ++i){
+		for(int axis = 0 ; axis < 3 ; ++axis)
+			values[axis*n + i] = Round((frame.origins[3*i + axis] - header.lower[axis])/header.positionQuantum);
+		
+		double q[4];
+		double norm = 0;
+		for(int k = 0 ; k < 4 ; ++k){
+			q[k] = frame.orientations[4*i + k];
+			norm += q[k]*q[k];
+		}
+		norm = norm > 0 ? 1/std::sqrt(norm) : 1;
+		int largest = 0;
+		for(int k = 1 ; k < 4 ; ++k)
+			if(std::fabs(q[k]) > std::fabs(q[largest]))
+				largest = k;
+		double sign = q[largest] < 0 ? -norm : norm;
+		values[3*n + i] = largest;
+		for(int k = 0, field = 4 ; k < 4 ; ++k)
+			if(k != largest)
+				values[(field++)*n + i] = Round(q[k]*sign*scale);
+		
+		if(velocities){
+			for(int axis = 0 ; axis < 3 ; ++axis){
+				values[(7 + axis)*n + i] = Round(frame.velocities[3*i + axis]/header.velocityQuantum);
+				values[(10 + axis)*n + i] = Round(frame.angularVelocities[3*i + axis]/header.velocityQuantum);
+			}
+		}
+	}
+}
+
+void FrameQuantizer::Restore(const std::vector<std::int64_t>& values, const CompressedFrameHeader& header, TrajectoryFrame& frame) {
+	std::size_t n = header.solidCount;
+	bool velocities = header.flags & CompressedFrameHeader::velocities;
+	frame.step = header.step;
+	frame.time = header.time;
+	frame.origins.resize(3*n);
+	frame.orientations.resize(4*n);
+	frame.velocities.assign(3*n, 0);
+	frame.angularVelocities.assign(3*n, 0);
+	frame.forces.assign(3*n, 0);
+	frame.momentums.assign(3*n, 0);
+	double scale = inverseSqrt2/((std::int64_t(1) << (header.orientationBits - 1)) - 1);
+	for(std::size_t i = 0 ; i < n ; ++i){
+		for(int axis = 0 ; axis < 3 ; ++axis)
+			frame.origins[3*i + axis] = header.lower[axis] + values[axis*n + i]*header.positionQuantum;
+		
+		std::int64_t largest = values[3*n + i];
+		if(largest < 0 || largest > 3)
+			throw(std::runtime_error("CompressedTrajectoryReader: corrupted frame"));
+		double* q = &frame.orientations[4*i];
+		double sum = 0;
+		for(int k = 0, field = 4 ; k < 4 ; ++k){
+			if(k == largest)
+				continue;
+			q[k] = values[(field++)*n + i]*scale;
+			sum += q[k]*q[k];
+		}
+		q[largest] = std::sqrt(std::max(0., 1 - sum));
+		
+		if(velocities){
+			for(int axis = 0 ; axis < 3 ; ++axis){
+				frame.velocities[3*i + axis] = values[(7 + axis)*n + i]*header.velocityQuantum;
+				frame.angularVelocities[3*i + axis] = values[(10 + axis)*n + i]*header.velocityQuantum;
+			}
+		}
+	}
+}
+
+CompressedFrameEncoder::CompressedFrameEncoder(const CompressedFrameOptions& options):options(options) {
+	Vector<double> lengths = options.domain.Lengths();
+	double length = std::max(lengths.ComponantX(), std::max(lengths.ComponantY(), lengths.ComponantZ()));
+	if(!(length > 0) || !(options.positionTolerance > 0))
+		throw(std::runtime_error("CompressedFrameEncoder: a domain and a positive tolerance are needed"));
+	if(options.orientationBits < 2 || options.orientationBits > 30)
+		throw(std::runtime_error("CompressedFrameEncoder: orientation bits out of range"));
+	this->positionQuantum = 2*options.positionTolerance*length;
+	this->options.keyframeInterval = std::max<std::size_t>(options.keyframeInterval, 1);
+}
+
+void CompressedFrameEncoder::Encode(const TrajectoryFrame& frame, std::string& bytes) {
+	CompressedFrameHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = CompressedFrameHeader::magicNumber;
+	header.orientationBits = this->options.orientationBits;
+	header.step = frame.step;
+	header.time = frame.time;
+	header.solidCount = frame.SolidCount();
+	Point<double> lower = this->options.domain.Lower();
+	header.lower[0] = lower.CoordinateX();
+	header.lower[1] = lower.CoordinateY();
+	header.lower[2] = lower.CoordinateZ();
+	header.positionQuantum = this->positionQuantum;
+	if(this->options.velocityTolerance > 0){
+		header.flags |= CompressedFrameHeader::velocities;
+		header.velocityQuantum = 2*this->options.velocityTolerance;
+	}
+	
+	FrameQuantizer::Quantize(frame, header, this->current);
+	bool keyframe = this->framesSinceKeyframe % this->options.keyframeInterval == 0 || this->previous.size() != this->current.size();
+	if(keyframe){
+		header.flags |= CompressedFrameHeader::keyframe;
+		this->framesSinceKeyframe = 0;
+	}
+	++this->framesSinceKeyframe;
+	
+	this->raw.clear();
+	for(std::size_t k = 0 ; k < this->current.size() ; ++k)
+		PutVarint(this->raw, keyframe ? this->current[k] : this->current[k] - this->previous[k]);
+	this->previous.swap(this->current);
+	
+	std::size_t headerPosition = bytes.size();
+	bytes.append(reinterpret_cast<const char*>(&header), sizeof(header));
+	std::size_t payloadPosition = bytes.size();
+	this->compressor.Compress(this->raw.data(), this->raw.size(), bytes);
+	header.rawSize = this->raw.size();
+	header.compressedSize = bytes.size() - payloadPosition;
+	std::memcpy(&bytes[headerPosition], &header, sizeof(header));
+}
+
+CompressedTrajectoryReader::CompressedTrajectoryReader(const std::string& path):in(path.c_str(), std::ios::binary), decoded(std::numeric_limits<std::size_t>::max()) {
+	if(!this->in)
+		throw(std::runtime_error("CompressedTrajectoryReader: cannot open " + path));
+	std::uint64_t offset = 0;
+	std::size_t keyframe = 0;
+	while(this->in.read(reinterpret_cast<char*>(&this->header), sizeof(this->header))){
+		if(this->header.magic != CompressedFrameHeader::magicNumber)
+			throw(std::runtime_error("CompressedTrajectoryReader: corrupted frame in " + path));
+		if(this->header.flags & CompressedFrameHeader::keyframe)
+			keyframe = this->frames.size();
+		else if(this->frames.empty())
+			throw(std::runtime_error("CompressedTrajectoryReader: " + path + " does not start with a keyframe"));
+		this->frames.push_back(Entry{offset, this->header.step, keyframe});
+		offset += sizeof(this->header) + this->header.compressedSize;
+		this->in.seekg(offset);
+	}
+	this->in.clear();
+}
+
+std::size_t CompressedTrajectoryReader::KeyframeCount() const {
+	std::size_t count = 0;
+	for(std::size_t frame = 0 ; frame < this->frames.size() ; ++frame)
+		count += this->frames[frame].keyframe == frame;
+	return count;
+}
+
+void CompressedTrajectoryReader::Read(std::size_t frame, TrajectoryFrame& out) {
+	if(frame >= this->frames.size())
+		throw(std::runtime_error("CompressedTrajectoryReader: frame out of range"));
+	std::size_t keyframe = this->frames[frame].keyframe;
+	std::size_t first = keyframe;
+	if(this->decoded != std::numeric_limits<std::size_t>::max() && this->decoded >= keyframe && this->decoded <= frame)
+		first = this->decoded + 1;
+	for(std::size_t k = first ; k <= frame ; ++k)
+		this->Decode(k);
+	// Decode leaves the header of the last decoded frame.
+	if(first > frame){
+		this->in.seekg(this->frames[frame].offset);
+		this->in.read(reinterpret_cast<char*>(&this->header), sizeof(this->header));
+	}
+	FrameQuantizer::Restore(this->values, this->header, out);
+}
+
+void CompressedTrajectoryReader::Decode(std::size_t frame) {
+	this->decoded = std::numeric_limits<std::size_t>::max();
+	this->in.seekg(this->frames[frame].offset);
+	this->in.read(reinterpret_cast<char*>(&this->header), sizeof(this->header));
+	this->compressed.resize(this->header.compressedSize);
+	this->in.read(&this->compressed[0], this->compressed.size());
+	if(!this->in)
+		throw(std::runtime_error("CompressedTrajectoryReader: truncated frame"));
+	this->raw.resize(this->header.rawSize);
+	LzCompressor::Decompress(this->compressed.data(), this->compressed.size(), &this->raw[0], this->raw.size());
+	
+	bool keyframe = this->header.flags & CompressedFrameHeader::keyframe;
+	std::size_t count = FrameQuantizer::FieldCount(this->header.flags & CompressedFrameHeader::velocities)*this->header.solidCount;
+	if(keyframe)
+		this->values.assign(count, 0);
+	else if(this->values.size() != count)
+		throw(std::runtime_error("CompressedTrajectoryReader: corrupted frame"));
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(this->raw.data());
+	const unsigned char* end = in + this->raw.size();
+	for(std::size_t k = 0 ; k < count ; ++k)
+		this->values[k] += GetVarint(in, end);
+	this->decoded = frame;
+}
@@ -0,0 +1,51 @@
+#include <cstdio>
+#include <cstring>
+#include "../../Include/Trajectory/FrameEncoder.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	// printf("%.15e") matches the std::scientific output of precision 15 used by the
+	// LuGa formatters, without a stringstream per value.
+	void AppendLine(std::string& bytes, const double* values, int count) {
+		char line[4*32];
+		int length = 0;
+		for(int k = 0 ; k < count ; ++k)
+			length += std::snprintf(line + length, sizeof(line) - length, k == 0 ? "%.15e" : "\t%.15e", values[k]);
+		bytes.append(line, length);
+	}
+	
+	template<class T>
+	void Append(std::string& bytes, const T& value) {
+		bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+	
+	void Append(std::string& bytes, const std::vector<double>& column) {
+		bytes.append(reinterpret_cast<const char*>(column.data()), column.size()*sizeof(double));
+	}
+}
+
+void LuGaFrameEncoder::Encode(const TrajectoryFrame& frame, std::string& bytes) {
+	for(std::size_t i = 0 ; i < frame.SolidCount() ; ++i){
+		AppendLine(bytes, &frame.origins[3*i], 3);
+		bytes.push_back('\n');
+		AppendLine(bytes, &frame.orientations[4*i], 4);
+		bytes.push_back('\n');
+		AppendLine(bytes, &frame.forces[3*i], 3);
+		bytes.push_back('\n');
+		AppendLine(bytes, &frame.momentums[3*i], 3);
+		bytes.push_back('\n');
+	}
+}
+
+void BinaryFrameEncoder::Encode(const TrajectoryFrame& frame, std::string& bytes) {
+	Append(bytes, frame.step);
+	Append(bytes, frame.time);
+	Append(bytes, static_cast<std::uint64_t>(frame.SolidCount()));
+	Append(bytes, frame.origins);
+	Append(bytes, frame.orientations);
+	Append(bytes, frame.velocities);
+	Append(bytes, frame.angularVelocities);
+	Append(bytes, frame.forces);
+	Append(bytes, frame.momentums);
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "../../Include/Trajectory/LzCompressor.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	std::uint32_t Read32(const char* p) {
+		std::uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+	
+	void PutLength(std::string& out, std::size_t length) {
+		for(; length >= 255 ; length -= 255)
+			out.push_back(static_cast<char>(255));
+		out.push_back(static_cast<char>(length));
+	}
+	
+	void PutSequence(std::string& out, const char* literals, std::size_t literalLength, std::size_t offset, std::size_t matchLength) {
+		std::size_t matchCode = matchLength == 0 ? 0 : matchLength - 4;
+		out.push_back(static_cast<char>((std::min<std::size_t>(literalLength, 15) << 4) | std::min<std::size_t>(matchCode, 15)));
+		if(literalLength >= 15)
+			PutLength(out, literalLength - 15);
+		out.append(literals, literalLength);
+		if(matchLength == 0)
+			return;
+		out.push_back(static_cast<char>(offset & 0xff));
+		out.push_back(static_cast<char>(offset >> 8));
+		if(matchCode >= 15)
+			PutLength(out, matchCode - 15);
+	}
+	
+	[[noreturn]] void Corrupted() {
+		throw(std::runtime_error("LzCompressor: corrupted data"));
+	}
+	
+	std::size_t GetLength(const unsigned char*& in, const unsigned char* end, std::size_t length) {
+		if(length != 15)
+			return length;
+		unsigned char byte;
+		do{
+			if(in == end)
+				Corrupted();
+			byte = *in++;
+			length += byte;
+		}while(byte == 255);
+		return length;
+	}
+}
+
+void LzCompressor::Compress(const char* data, std::size_t size, std::string& compressed) {
+	std::fill(this->table.begin(), this->table.end(), 0);
+	std::size_t anchor = 0;
+	std::size_t i = 0;
+	// Positions are stored plus one, zero marks an empty slot.
+	while(i + minimumMatch <= size){
+		std::uint32_t sequence = Read32(data + i);
+		std::uint32_t hash = (sequence*2654435761u) >> (32 - hashBits);
+		std::size_t candidate = this->table[hash];
+		this->table[hash] = static_cast<std::uint32_t>(i + 1);
+		if(candidate == 0 || i + 1 - candidate > maximumOffset || Read32(data + candidate - 1) != sequence){
+			// Skip faster through data that does not compress.
+			i += 1 + ((i - anchor) >> 6);
+			continue;
+		}
+		--candidate;
+		std::size_t length = minimumMatch;
+		while(i + length < size && data[candidate + length] == data[i + length])
+			++length;
+		PutSequence(compressed, data + anchor, i - anchor, i - candidate, length);
+		i += length;
+		anchor = i;
+	}
+	PutSequence(compressed, data + anchor, size - anchor, 0, 0);
+}
+
+void LzCompressor::Decompress(const char* compressed, std::size_t size, char* data, std::size_t rawSize) {
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(compressed);
+	const unsigned char* end = in + size;
+	std::size_t out = 0;
+	while(true){
+		if(in == end)
+			Corrupted();
+		unsigned char token = *in++;
+		std::size_t literalLength = GetLength(in, end, token >> 4);
+		if(literalLength > static_cast<std::size_t>(end - in) || literalLength > rawSize - out)
+			Corrupted();
+		std::memcpy(data + out, in, literalLength);
+		in += literalLength;
+		out += literalLength;
+		if(in == end)
+			break;
+		
+		if(end - in < 2)
+			Corrupted();
+		std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+		in += 2;
+		std::size_t matchLength = GetLength(in, end, token & 15) + minimumMatch;
+		if(offset == 0 || offset > out || matchLength > rawSize - out)
+			Corrupted();
+		// Byte by byte: the match may overlap the bytes it produces.
+		const char* source = data + out - offset;
+		for(std::size_t k = 0 ; k < matchLength ; ++k)
+			data[out + k] = source[k];
+		out += matchLength;
+	}
+	if(out != rawSize)
+		Corrupted();
+}
@@ -0,0 +1,40 @@
+#include "../../Include/Trajectory/TrajectoryFrame.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	void Put(double* target, const Vector<double>& v) {
+		target[0] = v.ComponantX();
+		target[1] = v.ComponantY();
+		target[2] = v.ComponantZ();
+	}
+}
+
+void TrajectoryFrame::Capture(const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	this->step = step;
+	this->time = time;
+	std::size_t count = solids.size();
+	this->origins.resize(3*count);
+	this->orientations.resize(4*count);
+	this->velocities.resize(3*count);
+	this->angularVelocities.resize(3*count);
+	this->forces.resize(3*count);
+	this->momentums.resize(3*count);
+	for(std::size_t i = 0 ; i < count ; ++i){
+		const GeometricalSpaceObjects::Basis<double>& basis = solids[i].Basis();
+		const Point<double> origin = basis.Origin();
+		const Quaternion<double> q = basis.Orientation();
+		this->origins[3*i] = origin.CoordinateX();
+		this->origins[3*i + 1] = origin.CoordinateY();
+		this->origins[3*i + 2] = origin.CoordinateZ();
+		this->orientations[4*i] = q.ComponantReal();
+		this->orientations[4*i + 1] = q.ComponantI();
+		this->orientations[4*i + 2] = q.ComponantJ();
+		this->orientations[4*i + 3] = q.ComponantK();
+		Put(&this->velocities[3*i], solids[i].Velocity());
+		Put(&this->angularVelocities[3*i], solids[i].AngularVelocity());
+		Put(&this->forces[3*i], solids[i].Force());
+		Put(&this->momentums[3*i], solids[i].Momentum());
+	}
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../Include/Trajectory/TrajectoryStoreReader.h"
+
+using namespace GeometricalSolid;
+
+TrajectoryStoreReader::TrajectoryStoreReader(const std::string& path) {
+	int file = open(path.c_str(), O_RDONLY);
+	if(file < 0)
+		throw(std::runtime_error("TrajectoryStoreReader: cannot open " + path));
+	struct stat status;
+	if(fstat(file, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(TrajectoryStore::Header) + sizeof(TrajectoryStore::Trailer))){
+		close(file);
+		throw(std::runtime_error("TrajectoryStoreReader: " + path + " is not a trajectory store"));
+	}
+	this->size = status.st_size;
+	void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if(mapping == MAP_FAILED)
+		throw(std::runtime_error("TrajectoryStoreReader: cannot map " + path));
+	this->data = static_cast<const char*>(mapping);
+	this->header = reinterpret_cast<const TrajectoryStore::Header*>(this->data);
+	this->trailer = reinterpret_cast<const TrajectoryStore::Trailer*>(this->data + this->size - sizeof(TrajectoryStore::Trailer));
+	try{
+		this->Validate(path);
+	}
+	catch(...){
+		munmap(const_cast<char*>(this->data), this->size);
+		throw;
+	}
+	// Analysis jumps around the file; read-ahead would mostly fetch unused tiles.
+	madvise(mapping, this->size, MADV_RANDOM);
+}
+
+TrajectoryStoreReader::~TrajectoryStoreReader() {
+	munmap(const_cast<char*>(this->data), this->size);
+}
+
+void TrajectoryStoreReader::Validate(const std::string& path) {
+	const TrajectoryStore::Header& header = *this->header;
+	if(std::memcmp(header.magic, TrajectoryStore::magic, sizeof(header.magic)) != 0)
+		throw(std::runtime_error("TrajectoryStoreReader: " + path + " is not a trajectory store"));
+	if(header.byteOrderMark != TrajectoryStore::byteOrderMark)
+		throw(std::runtime_error("TrajectoryStoreReader: " + path + " was written with another byte order"));
+	if(header.version != TrajectoryStore::version)
+		throw(std::runtime_error("TrajectoryStoreReader: unsupported version in " + path));
+	if(std::memcmp(this->trailer->magic, TrajectoryStore::magic, sizeof(header.magic)) != 0)
+		throw(std::runtime_error("TrajectoryStoreReader: " + path + " was not closed"));
+	if(header.framesPerChunk == 0 || header.solidsPerChunk == 0)
+		throw(std::runtime_error("TrajectoryStoreReader: corrupted header in " + path));
+	
+	std::uint64_t frameCount = this->trailer->frameCount;
+	std::uint64_t frameBlocks = (frameCount + header.framesPerChunk - 1)/header.framesPerChunk;
+	this->solidBlocks = (header.solidCount + header.solidsPerChunk - 1)/header.solidsPerChunk;
+	std::uint64_t tileCount = frameBlocks*this->solidBlocks*TrajectoryStore::ColumnCount;
+	std::uint64_t footerOffset = this->trailer->footerOffset;
+	if(footerOffset + frameCount*sizeof(TrajectoryStore::FrameEntry) + tileCount*sizeof(std::uint64_t) + sizeof(TrajectoryStore::Trailer) != this->size)
+		throw(std::runtime_error("TrajectoryStoreReader: corrupted footer in " + path));
+	this->frames = reinterpret_cast<const TrajectoryStore::FrameEntry*>(this->data + footerOffset);
+	this->offsets = reinterpret_cast<const std::uint64_t*>(this->data + footerOffset + frameCount*sizeof(TrajectoryStore::FrameEntry));
+	
+	for(std::uint64_t frameBlock = 0 ; frameBlock < frameBlocks ; ++frameBlock){
+		std::uint64_t frames = std::min<std::uint64_t>(header.framesPerChunk, frameCount - frameBlock*header.framesPerChunk);
+		for(std::uint64_t solidBlock = 0 ; solidBlock < this->solidBlocks ; ++solidBlock){
+			std::uint64_t solids = std::min<std::uint64_t>(header.solidsPerChunk, header.solidCount - solidBlock*header.solidsPerChunk);
+			for(int c = 0 ; c < TrajectoryStore::ColumnCount ; ++c){
+				TrajectoryStore::Column column = static_cast<TrajectoryStore::Column>(c);
+				std::uint64_t offset = this->offsets[(frameBlock*this->solidBlocks + solidBlock)*TrajectoryStore::ColumnCount + c];
+				if(!this->HasColumn(column) && offset == 0)
+					continue;
+				if(!this->HasColumn(column) || offset % TrajectoryStore::alignment != 0
+				   || offset + frames*solids*TrajectoryStore::ComponentCount(column)*sizeof(double) > footerOffset)
+					throw(std::runtime_error("TrajectoryStoreReader: corrupted tile index in " + path));
+			}
+		}
+	}
+}
+
+const double* TrajectoryStoreReader::Tile(TrajectoryStore::Column column, std::size_t frameBlock, std::size_t solidBlock) const {
+	if(!this->HasColumn(column))
+		throw(std::runtime_error("TrajectoryStoreReader: column not stored"));
+	std::uint64_t offset = this->offsets[(frameBlock*this->solidBlocks + solidBlock)*TrajectoryStore::ColumnCount + column];
+	return reinterpret_cast<const double*>(this->data + offset);
+}
+
+const double* TrajectoryStoreReader::Value(TrajectoryStore::Column column, std::size_t frame, std::size_t solid) const {
+	if(frame >= this->FrameCount() || solid >= this->SolidCount())
+		throw(std::runtime_error("TrajectoryStoreReader: frame or solid out of range"));
+	std::size_t framesPerChunk = this->header->framesPerChunk, solidsPerChunk = this->header->solidsPerChunk;
+	std::size_t frameBlock = frame/framesPerChunk, solidBlock = solid/solidsPerChunk;
+	std::size_t frames = std::min(framesPerChunk, this->FrameCount() - frameBlock*framesPerChunk);
+	return this->Tile(column, frameBlock, solidBlock) + ((solid - solidBlock*solidsPerChunk)*frames + frame - frameBlock*framesPerChunk)*TrajectoryStore::ComponentCount(column);
+}
+
+void TrajectoryStoreReader::Series(TrajectoryStore::Column column, std::size_t solid, std::size_t first, std::size_t count, double* values) const {
+	if(count == 0)
+		return;
+	if(first + count > this->FrameCount())
+		throw(std::runtime_error("TrajectoryStoreReader: frame out of range"));
+	std::size_t components = TrajectoryStore::ComponentCount(column);
+	std::size_t framesPerChunk = this->header->framesPerChunk;
+	for(std::size_t frame = first ; frame < first + count ; ){
+		// The frames of one solid are contiguous within a tile.
+		std::size_t blockEnd = std::min((frame/framesPerChunk + 1)*framesPerChunk, first + count);
+		std::size_t length = (blockEnd - frame)*components;
+		std::memcpy(values, this->Value(column, frame, solid), length*sizeof(double));
+		values += length;
+		frame = blockEnd;
+	}
+}
+
+void TrajectoryStoreReader::Read(std::size_t frame, TrajectoryFrame& out) const {
+	if(frame >= this->FrameCount())
+		throw(std::runtime_error("TrajectoryStoreReader: frame out of range"));
+	out.step = this->Step(frame);
+	out.time = this->Time(frame);
+	std::size_t solidsPerChunk = this->header->solidsPerChunk;
+	std::size_t framesPerChunk = this->header->framesPerChunk;
+	std::size_t frameBlock = frame/framesPerChunk;
+	std::size_t frames = std::min(framesPerChunk, this->FrameCount() - frameBlock*framesPerChunk);
+	for(int c = 0 ; c < TrajectoryStore::ColumnCount ; ++c){
+		TrajectoryStore::Column column = static_cast<TrajectoryStore::Column>(c);
+		std::vector<double>& values = TrajectoryStore::Values(out, column);
+		if(!this->HasColumn(column)){
+			values.clear();
+			continue;
+		}
+		std::size_t components = TrajectoryStore::ComponentCount(column);
+		values.resize(this->SolidCount()*components);
+		for(std::size_t solidBlock = 0 ; solidBlock < this->solidBlocks ; ++solidBlock){
+			const double* tile = this->Tile(column, frameBlock, solidBlock) + (frame - frameBlock*framesPerChunk)*components;
+			std::size_t firstSolid = solidBlock*solidsPerChunk;
+			std::size_t lastSolid = std::min(firstSolid + solidsPerChunk, this->SolidCount());
+			for(std::size_t solid = firstSolid ; solid < lastSolid ; ++solid)
+				std::memcpy(&values[solid*components], tile + (solid - firstSolid)*frames*components, components*sizeof(double));
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "../../Include/Trajectory/TrajectoryStoreWriter.h"
+
+using namespace GeometricalSolid;
+
+TrajectoryStoreWriter::TrajectoryStoreWriter(const std::string& path, std::size_t solidCount, const TrajectoryStoreOptions& options):path(path), solidCount(solidCount), options(options) {
+	if(options.framesPerChunk == 0 || options.solidsPerChunk == 0)
+		throw(std::runtime_error("TrajectoryStoreWriter: chunks must hold at least one frame and one solid"));
+	this->out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+	if(!this->out)
+		throw(std::runtime_error("TrajectoryStoreWriter: cannot open " + path));
+	
+	TrajectoryStore::Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, TrajectoryStore::magic, sizeof(header.magic));
+	header.version = TrajectoryStore::version;
+	header.byteOrderMark = TrajectoryStore::byteOrderMark;
+	header.solidCount = solidCount;
+	header.framesPerChunk = options.framesPerChunk;
+	header.solidsPerChunk = options.solidsPerChunk;
+	header.columnMask = options.columnMask & ((1 << TrajectoryStore::ColumnCount) - 1);
+	this->options.columnMask = header.columnMask;
+	this->out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	this->position = sizeof(header);
+	this->Pad();
+}
+
+TrajectoryStoreWriter::~TrajectoryStoreWriter() {
+	try{
+		this->Close();
+	}
+	catch(...){
+	}
+}
+
+void TrajectoryStoreWriter::Append(const TrajectoryFrame& frame) {
+	if(this->closed)
+		throw(std::runtime_error("TrajectoryStoreWriter: " + this->path + " is closed"));
+	for(int c = 0 ; c < TrajectoryStore::ColumnCount ; ++c){
+		TrajectoryStore::Column column = static_cast<TrajectoryStore::Column>(c);
+		if(this->Stored(column) && TrajectoryStore::Values(frame, column).size() != this->solidCount*TrajectoryStore::ComponentCount(column))
+			throw(std::runtime_error("TrajectoryStoreWriter: frame does not hold the solids of " + this->path));
+	}
+	
+	this->frames.push_back(TrajectoryStore::FrameEntry{frame.step, frame.time});
+	for(int c = 0 ; c < TrajectoryStore::ColumnCount ; ++c){
+		TrajectoryStore::Column column = static_cast<TrajectoryStore::Column>(c);
+		if(this->Stored(column)){
+			const std::vector<double>& values = TrajectoryStore::Values(frame, column);
+			this->block[c].insert(this->block[c].end(), values.begin(), values.end());
+		}
+	}
+	if(++this->blockFrames == this->options.framesPerChunk)
+		this->WriteBlock();
+}
+
+void TrajectoryStoreWriter::Append(const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	this->captured.Capture(solids, step, time);
+	this->Append(this->captured);
+}
+
+void TrajectoryStoreWriter::WriteBlock() {
+	if(this->blockFrames == 0)
+		return;
+	std::size_t frameCount = this->blockFrames;
+	for(std::size_t first = 0 ; first < this->solidCount ; first += this->options.solidsPerChunk){
+		std::size_t last = std::min(first + this->options.solidsPerChunk, this->solidCount);
+		for(int c = 0 ; c < TrajectoryStore::ColumnCount ; ++c){
+			TrajectoryStore::Column column = static_cast<TrajectoryStore::Column>(c);
+			if(!this->Stored(column)){
+				this->offsets.push_back(0);
+				continue;
+			}
+			// Frame-major block to solid-major tile.
+			std::size_t components = TrajectoryStore::ComponentCount(column);
+			this->tile.resize((last - first)*frameCount*components);
+			const double* source = this->block[c].data();
+			for(std::size_t solid = first ; solid < last ; ++solid)
+				for(std::size_t frame = 0 ; frame < frameCount ; ++frame)
+					std::memcpy(&this->tile[((solid - first)*frameCount + frame)*components], &source[(frame*this->solidCount + solid)*components], components*sizeof(double));
+			this->offsets.push_back(this->position);
+			std::size_t bytes = this->tile.size()*sizeof(double);
+			this->out.write(reinterpret_cast<const char*>(this->tile.data()), bytes);
+			this->position += bytes;
+			this->Pad();
+		}
+	}
+	for(auto& column : this->block)
+		column.clear();
+	this->blockFrames = 0;
+	if(!this->out)
+		throw(std::runtime_error("TrajectoryStoreWriter: cannot write " + this->path));
+}
+
+void TrajectoryStoreWriter::Pad() {
+	static const char zeros[TrajectoryStore::alignment] = {};
+	std::uint64_t aligned = TrajectoryStore::Align(this->position);
+	this->out.write(zeros, aligned - this->position);
+	this->position = aligned;
+}
+
+void TrajectoryStoreWriter::Close() {
+	if(this->closed)
+		return;
+	this->closed = true;
+	this->WriteBlock();
+	
+	TrajectoryStore::Trailer trailer;
+	std::memset(&trailer, 0, sizeof(trailer));
+	trailer.footerOffset = this->position;
+	trailer.frameCount = this->frames.size();
+	std::memcpy(trailer.magic, TrajectoryStore::magic, sizeof(trailer.magic));
+	this->out.write(reinterpret_cast<const char*>(this->frames.data()), this->frames.size()*sizeof(TrajectoryStore::FrameEntry));
+	this->out.write(reinterpret_cast<const char*>(this->offsets.data()), this->offsets.size()*sizeof(std::uint64_t));
+	this->out.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+	this->out.close();
+	if(!this->out)
+		throw(std::runtime_error("TrajectoryStoreWriter: cannot write " + this->path));
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <stdexcept>
+#include "../../Include/Trajectory/TrajectoryWriter.h"
+
+using namespace GeometricalSolid;
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path, std::unique_ptr<FrameEncoder> encoder, const TrajectoryWriterOptions& options):
+file(new std::ofstream(path.c_str(), std::ios::binary | std::ios::trunc)), out(*this->file), encoder(std::move(encoder)), options(options) {
+	if(!*this->file)
+		throw(std::runtime_error("TrajectoryWriter: cannot open " + path));
+	this->Start();
+}
+
+TrajectoryWriter::TrajectoryWriter(std::ostream& out, std::unique_ptr<FrameEncoder> encoder, const TrajectoryWriterOptions& options):
+out(out), encoder(std::move(encoder)), options(options) {
+	this->Start();
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->frameQueued.notify_one();
+	this->writer.join();
+	this->out.flush();
+}
+
+void TrajectoryWriter::Start() {
+	if(this->options.buffers == 0)
+		throw(std::runtime_error("TrajectoryWriter: at least one buffer is needed"));
+	this->frames.resize(this->options.buffers);
+	this->queue.resize(this->options.buffers);
+	for(std::size_t frame = this->options.buffers ; frame > 0 ; --frame)
+		this->freeFrames.push_back(frame - 1);
+	this->writer = std::thread(&TrajectoryWriter::WriterLoop, this);
+}
+
+bool TrajectoryWriter::Capture(const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	std::size_t frame;
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->RethrowError();
+		if(this->freeFrames.empty()){
+			if(this->options.backpressure == TrajectoryWriterOptions::Backpressure::Drop){
+				++this->dropped;
+				return false;
+			}
+			auto start = std::chrono::steady_clock::now();
+			this->frameReleased.wait(lock, [this]{ return !this->freeFrames.empty() || this->error; });
+			this->stallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			this->RethrowError();
+		}
+		frame = this->freeFrames.back();
+		this->freeFrames.pop_back();
+	}
+	
+	// The frame belongs to this thread until it is queued.
+	this->frames[frame].Capture(solids, step, time);
+	
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->queue[(this->queueHead + this->queueSize) % this->queue.size()] = frame;
+		++this->queueSize;
+		++this->captured;
+	}
+	this->frameQueued.notify_one();
+	return true;
+}
+
+void TrajectoryWriter::Flush() {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->frameReleased.wait(lock, [this]{ return (this->queueSize == 0 && !this->writing) || this->error; });
+	this->RethrowError();
+	this->out.flush();
+	if(!this->out)
+		throw(std::runtime_error("TrajectoryWriter: write failed"));
+}
+
+TrajectoryWriterStatistics TrajectoryWriter::Statistics() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return TrajectoryWriterStatistics{this->captured, this->written, this->dropped, this->bytes, this->stallSeconds};
+}
+
+void TrajectoryWriter::RethrowError() {
+	if(this->error)
+		std::rethrow_exception(this->error);
+}
+
+void TrajectoryWriter::WriterLoop() {
+	std::string encoded;
+	while(true){
+		std::size_t frame;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->frameQueued.wait(lock, [this]{ return this->queueSize > 0 || this->stopping; });
+			if(this->queueSize == 0)
+				return;
+			frame = this->queue[this->queueHead];
+			this->queueHead = (this->queueHead + 1) % this->queue.size();
+			--this->queueSize;
+			this->writing = true;
+		}
+		
+		std::size_t size = 0;
+		std::exception_ptr failure;
+		try{
+			encoded.clear();
+			this->encoder->Encode(this->frames[frame], encoded);
+			this->out.write(encoded.data(), encoded.size());
+			if(!this->out)
+				throw(std::runtime_error("TrajectoryWriter: write failed"));
+			size = encoded.size();
+		}
+		catch(...){
+			failure = std::current_exception();
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if(failure && !this->error)
+				this->error = failure;
+			if(!failure){
+				++this->written;
+				this->bytes += size;
+			}
+			this->freeFrames.push_back(frame);
+			this->writing = false;
+		}
+		this->frameReleased.notify_all();
+	}
+}
@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include "../../Include/Trajectory/VtkWriter.h"
+
+using namespace GeometricalSolid;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	bool LittleEndianHost() {
+		const std::uint16_t probe = 1;
+		char first;
+		std::memcpy(&first, &probe, 1);
+		return first == 1;
+	}
+
+	template<class T>
+	void SwapBytes(T& value) {
+		char* bytes = reinterpret_cast<char*>(&value);
+		std::reverse(bytes, bytes + sizeof(T));
+	}
+
+	void Put(double* target, const Vector<double>& v) {
+		target[0] = v.ComponantX();
+		target[1] = v.ComponantY();
+		target[2] = v.ComponantZ();
+	}
+
+	std::string Number(double value) {
+		char text[32];
+		std::snprintf(text, sizeof(text), "%.17g", value);
+		return text;
+	}
+
+	// Reads the columns straight from the solids.
+	class SolidSource{
+	public:
+		SolidSource(const std::vector<Solid>& solids, VtkShapeTable& shapes, std::uint64_t step, double time):
+		solids(solids), shapes(shapes), step(step), time(time) {}
+
+		std::size_t Count() const { return this->solids.size(); }
+		std::uint64_t Step() const { return this->step; }
+		double Time() const { return this->time; }
+
+		void Origin(std::size_t i, double* values) const {
+			const Point<double> origin = this->solids[i].Basis().Origin();
+			values[0] = origin.CoordinateX();
+			values[1] = origin.CoordinateY();
+			values[2] = origin.CoordinateZ();
+		}
+		void Orientation(std::size_t i, double* values) const {
+			const Quaternion<double> q = this->solids[i].Basis().Orientation();
+			values[0] = q.ComponantReal();
+			values[1] = q.ComponantI();
+			values[2] = q.ComponantJ();
+			values[3] = q.ComponantK();
+		}
+		void Velocity(std::size_t i, double* values) const { Put(values, this->solids[i].Velocity()); }
+		void AngularVelocity(std::size_t i, double* values) const { Put(values, this->solids[i].AngularVelocity()); }
+		double Radius(std::size_t i) const {
+			const GeometricalSolid::Shape* shape = this->solids[i].Shape();
+			return shape == nullptr ? 0 : shape->BoundingRadius();
+		}
+		std::int32_t ShapeId(std::size_t i) const { return this->shapes.Id(this->solids[i].Shape()); }
+
+	private:
+		const std::vector<Solid>& solids;
+		VtkShapeTable& shapes;
+		std::uint64_t step;
+		double time;
+	};
+
+	class FrameSource{
+	public:
+		FrameSource(const VtkFrame& frame):frame(frame) {}
+
+		std::size_t Count() const { return this->frame.state.SolidCount(); }
+		std::uint64_t Step() const { return this->frame.state.step; }
+		double Time() const { return this->frame.state.time; }
+
+		void Origin(std::size_t i, double* values) const { std::memcpy(values, &this->frame.state.origins[3*i], 3*sizeof(double)); }
+		void Orientation(std::size_t i, double* values) const { std::memcpy(values, &this->frame.state.orientations[4*i], 4*sizeof(double)); }
+		void Velocity(std::size_t i, double* values) const { std::memcpy(values, &this->frame.state.velocities[3*i], 3*sizeof(double)); }
+		void AngularVelocity(std::size_t i, double* values) const { std::memcpy(values, &this->frame.state.angularVelocities[3*i], 3*sizeof(double)); }
+		double Radius(std::size_t i) const { return this->frame.radii[i]; }
+		std::int32_t ShapeId(std::size_t i) const { return this->frame.shapeIds[i]; }
+
+	private:
+		const VtkFrame& frame;
+	};
+}
+
+std::int32_t VtkShapeTable::Id(const GeometricalSolid::Shape* shape) {
+	if(shape == nullptr)
+		return -1;
+	Key key{static_cast<int>(shape->Form()), static_cast<int>(shape->Nature()), shape->BoundingRadius(), shape->Mass()};
+	auto same = [&key](const Key& other){
+		return key.form == other.form && key.nature == other.nature && key.boundingRadius == other.boundingRadius && key.mass == other.mass;
+	};
+	// Solids sharing a shape usually come in runs, so the last match is tried first.
+	if(this->last < this->keys.size() && same(this->keys[this->last]))
+		return static_cast<std::int32_t>(this->last);
+	for(this->last = 0 ; this->last < this->keys.size() ; ++this->last)
+		if(same(this->keys[this->last]))
+			return static_cast<std::int32_t>(this->last);
+	this->keys.push_back(key);
+	return static_cast<std::int32_t>(this->last);
+}
+
+void VtkFrame::Capture(const std::vector<Solid>& solids, VtkShapeTable& shapes, std::uint64_t step, double time) {
+	this->state.Capture(solids, step, time);
+	this->shapeIds.resize(solids.size());
+	this->radii.resize(solids.size());
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		const GeometricalSolid::Shape* shape = solids[i].Shape();
+		this->shapeIds[i] = shapes.Id(shape);
+		this->radii[i] = shape == nullptr ? 0 : shape->BoundingRadius();
+	}
+}
+
+VtkWriter::VtkWriter(const VtkWriterOptions& options):options(options) {
+	if(this->options.bufferSize < 64)
+		throw(std::runtime_error("VtkWriter: the buffer must hold at least 64 bytes"));
+}
+
+const char* VtkWriter::Extension() const {
+	return this->options.format == VtkWriterOptions::Format::Xml ? ".vtp" : ".vtk";
+}
+
+void VtkWriter::Write(const std::string& path, const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	this->WriteFile(path, SolidSource(solids, this->shapes, step, time));
+}
+
+void VtkWriter::Write(std::ostream& out, const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	SolidSource source(solids, this->shapes, step, time);
+	if(this->options.format == VtkWriterOptions::Format::Xml)
+		this->WriteXml(out, source);
+	else
+		this->WriteLegacy(out, source);
+}
+
+void VtkWriter::Write(const std::string& path, const VtkFrame& frame) {
+	this->WriteFile(path, FrameSource(frame));
+}
+
+void VtkWriter::Write(std::ostream& out, const VtkFrame& frame) {
+	if(this->options.format == VtkWriterOptions::Format::Xml)
+		this->WriteXml(out, FrameSource(frame));
+	else
+		this->WriteLegacy(out, FrameSource(frame));
+}
+
+template<class Source>
+void VtkWriter::WriteFile(const std::string& path, const Source& source) {
+	std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+	if(!out)
+		throw(std::runtime_error("VtkWriter: cannot open " + path));
+	if(this->options.format == VtkWriterOptions::Format::Xml)
+		this->WriteXml(out, source);
+	else
+		this->WriteLegacy(out, source);
+	out.close();
+	if(!out)
+		throw(std::runtime_error("VtkWriter: cannot write " + path));
+}
+
+template<class T, class Fill>
+void VtkWriter::WriteArray(std::ostream& out, std::size_t count, int components, bool bigEndian, const Fill& fill) {
+	const bool swap = bigEndian == LittleEndianHost();
+	const std::size_t tupleSize = components*sizeof(T);
+	const std::size_t perBuffer = this->options.bufferSize/tupleSize;
+	this->buffer.resize(perBuffer*tupleSize);
+	for(std::size_t begin = 0 ; begin < count ; begin += perBuffer){
+		std::size_t end = std::min(begin + perBuffer, count);
+		char* target = this->buffer.data();
+		for(std::size_t i = begin ; i < end ; ++i, target += tupleSize){
+			T values[4];
+			fill(i, values);
+			if(swap)
+				for(int k = 0 ; k < components ; ++k)
+					SwapBytes(values[k]);
+			std::memcpy(target, values, tupleSize);
+		}
+		out.write(this->buffer.data(), (end - begin)*tupleSize);
+	}
+}
+
+template<class Source>
+void VtkWriter::WriteXml(std::ostream& out, const Source& source) {
+	struct Array{
+		const char* type;
+		const char* name;
+		int components;
+		std::size_t size;
+	};
+	// In the order of the appended blocks.
+	static const Array arrays[] = {
+		{"Float64", "Orientation", 4, 8},
+		{"Float64", "Velocity", 3, 8},
+		{"Float64", "AngularVelocity", 3, 8},
+		{"Float64", "Radius", 1, 8},
+		{"Int32", "ShapeId", 1, 4},
+		{"Float64", "Points", 3, 8},
+		{"Int64", "connectivity", 1, 8},
+		{"Int64", "offsets", 1, 8}
+	};
+	const std::size_t count = source.Count();
+	std::uint64_t offsets[8];
+	std::uint64_t offset = 0;
+	for(int k = 0 ; k < 8 ; ++k){
+		offsets[k] = offset;
+		offset += sizeof(std::uint64_t) + count*arrays[k].components*arrays[k].size;
+	}
+	auto dataArray = [&](int k){
+		return "        <DataArray type=\"" + std::string(arrays[k].type) + "\" Name=\"" + arrays[k].name
+			+ "\" NumberOfComponents=\"" + std::to_string(arrays[k].components)
+			+ "\" format=\"appended\" offset=\"" + std::to_string(offsets[k]) + "\"/>\n";
+	};
+
+	std::string header = "<?xml version=\"1.0\"?>\n";
+	header += "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"";
+	header += LittleEndianHost() ? "LittleEndian" : "BigEndian";
+	header += "\" header_type=\"UInt64\">\n  <PolyData>\n    <FieldData>\n";
+	header += "      <DataArray type=\"Float64\" Name=\"TimeValue\" NumberOfTuples=\"1\" format=\"ascii\">" + Number(source.Time()) + "</DataArray>\n";
+	header += "      <DataArray type=\"UInt64\" Name=\"Step\" NumberOfTuples=\"1\" format=\"ascii\">" + std::to_string(source.Step()) + "</DataArray>\n";
+	header += "    </FieldData>\n";
+	header += "    <Piece NumberOfPoints=\"" + std::to_string(count) + "\" NumberOfVerts=\"" + std::to_string(count)
+		+ "\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
+	header += "      <PointData Scalars=\"ShapeId\" Vectors=\"Velocity\">\n";
+	for(int k = 0 ; k < 5 ; ++k)
+		header += "  " + dataArray(k);
+	header += "      </PointData>\n      <Points>\n  " + dataArray(5) + "      </Points>\n";
+	header += "      <Verts>\n  " + dataArray(6) + "  " + dataArray(7) + "      </Verts>\n";
+	header += "    </Piece>\n  </PolyData>\n  <AppendedData encoding=\"raw\">\n   _";
+	out.write(header.data(), header.size());
+
+	for(int k = 0 ; k < 8 ; ++k){
+		std::uint64_t bytes = count*arrays[k].components*arrays[k].size;
+		out.write(reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+		switch(k){
+			case 0: this->WriteArray<double>(out, count, 4, false, [&source](std::size_t i, double* v){ source.Orientation(i, v); }); break;
+			case 1: this->WriteArray<double>(out, count, 3, false, [&source](std::size_t i, double* v){ source.Velocity(i, v); }); break;
+			case 2: this->WriteArray<double>(out, count, 3, false, [&source](std::size_t i, double* v){ source.AngularVelocity(i, v); }); break;
+			case 3: this->WriteArray<double>(out, count, 1, false, [&source](std::size_t i, double* v){ v[0] = source.Radius(i); }); break;
+			case 4: this->WriteArray<std::int32_t>(out, count, 1, false, [&source](std::size_t i, std::int32_t* v){ v[0] = source.ShapeId(i); }); break;
+			case 5: this->WriteArray<double>(out, count, 3, false, [&source](std::size_t i, double* v){ source.Origin(i, v); }); break;
+			case 6: this->WriteArray<std::int64_t>(out, count, 1, false, [](std::size_t i, std::int64_t* v){ v[0] = i; }); break;
+			case 7: this->WriteArray<std::int64_t>(out, count, 1, false, [](std::size_t i, std::int64_t* v){ v[0] = i + 1; }); break;
+		}
+	}
+	static const char footer[] = "\n  </AppendedData>\n</VTKFile>\n";
+	out.write(footer, sizeof(footer) - 1);
+}
+
+template<class Source>
+void VtkWriter::WriteLegacy(std::ostream& out, const Source& source) {
+	const std::size_t count = source.Count();
+	// Version 3.0 cells are 32 bit: a size and an index per vertex.
+	if(count > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()/2))
+		throw(std::runtime_error("VtkWriter: too many solids for a legacy file"));
+	const std::string n = std::to_string(count);
+	auto text = [&out](const std::string& line){ out.write(line.data(), line.size()); };
+
+	text("# vtk DataFile Version 3.0\nLuGa step " + std::to_string(source.Step()) + " time " + Number(source.Time())
+		 + "\nBINARY\nDATASET POLYDATA\nPOINTS " + n + " double\n");
+	this->WriteArray<double>(out, count, 3, true, [&source](std::size_t i, double* v){ source.Origin(i, v); });
+	text("\nVERTICES " + n + " " + std::to_string(2*count) + "\n");
+	this->WriteArray<std::int32_t>(out, count, 2, true, [](std::size_t i, std::int32_t* v){ v[0] = 1; v[1] = static_cast<std::int32_t>(i); });
+	text("\nPOINT_DATA " + n + "\nSCALARS ShapeId int 1\nLOOKUP_TABLE default\n");
+	this->WriteArray<std::int32_t>(out, count, 1, true, [&source](std::size_t i, std::int32_t* v){ v[0] = source.ShapeId(i); });
+	text("\nVECTORS Velocity double\n");
+	this->WriteArray<double>(out, count, 3, true, [&source](std::size_t i, double* v){ source.Velocity(i, v); });
+	text("\nFIELD FieldData 3\nOrientation 4 " + n + " double\n");
+	this->WriteArray<double>(out, count, 4, true, [&source](std::size_t i, double* v){ source.Orientation(i, v); });
+	text("\nAngularVelocity 3 " + n + " double\n");
+	this->WriteArray<double>(out, count, 3, true, [&source](std::size_t i, double* v){ source.AngularVelocity(i, v); });
+	text("\nRadius 1 " + n + " double\n");
+	this->WriteArray<double>(out, count, 1, true, [&source](std::size_t i, double* v){ v[0] = source.Radius(i); });
+	text("\n");
+}
+
+VtkSeriesWriter::VtkSeriesWriter(const std::string& prefix, const VtkSeriesOptions& options):prefix(prefix), options(options) {
+	if(this->options.threads == 0 || this->options.buffers == 0)
+		throw(std::runtime_error("VtkSeriesWriter: at least one thread and one buffer are needed"));
+	// Checks the writer options before any thread starts.
+	VtkWriter check(this->options.vtk);
+	this->frames.resize(this->options.buffers);
+	this->queue.reserve(this->options.buffers);
+	for(std::size_t frame = this->options.buffers ; frame > 0 ; --frame)
+		this->freeFrames.push_back(frame - 1);
+	for(std::size_t thread = 0 ; thread < this->options.threads ; ++thread)
+		this->writers.push_back(std::thread(&VtkSeriesWriter::WriterLoop, this));
+}
+
+VtkSeriesWriter::~VtkSeriesWriter() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->frameQueued.notify_all();
+	for(auto& writer : this->writers)
+		writer.join();
+	try{
+		if(!this->error)
+			this->WriteCollection();
+	}
+	catch(...){
+	}
+}
+
+std::string VtkSeriesWriter::FileName(std::uint64_t step) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "_%08llu", static_cast<unsigned long long>(step));
+	return this->prefix + name + (this->options.vtk.format == VtkWriterOptions::Format::Xml ? ".vtp" : ".vtk");
+}
+
+void VtkSeriesWriter::Capture(const std::vector<Solid>& solids, std::uint64_t step, double time) {
+	std::size_t frame;
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->RethrowError();
+		this->frameReleased.wait(lock, [this]{ return !this->freeFrames.empty() || this->error; });
+		this->RethrowError();
+		frame = this->freeFrames.back();
+		this->freeFrames.pop_back();
+	}
+
+	// The frame and the shape table belong to this thread until the frame is queued.
+	this->frames[frame].Capture(solids, this->shapes, step, time);
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->queue.push_back(frame);
+	}
+	this->frameQueued.notify_one();
+}
+
+void VtkSeriesWriter::Flush() {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->frameReleased.wait(lock, [this]{ return (this->queue.empty() && this->writing == 0) || this->error; });
+	this->RethrowError();
+	this->WriteCollection();
+}
+
+std::size_t VtkSeriesWriter::Written() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->entries.size();
+}
+
+void VtkSeriesWriter::RethrowError() {
+	if(this->error)
+		std::rethrow_exception(this->error);
+}
+
+void VtkSeriesWriter::WriterLoop() {
+	VtkWriter writer(this->options.vtk);
+	while(true){
+		std::size_t frame;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->frameQueued.wait(lock, [this]{ return !this->queue.empty() || this->stopping; });
+			if(this->queue.empty())
+				return;
+			frame = this->queue.front();
+			this->queue.erase(this->queue.begin());
+			++this->writing;
+		}
+
+		const TrajectoryFrame& state = this->frames[frame].state;
+		Entry entry{state.step, state.time, this->FileName(state.step)};
+		std::exception_ptr failure;
+		try{
+			writer.Write(entry.file, this->frames[frame]);
+		}
+		catch(...){
+			failure = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if(failure && !this->error)
+				this->error = failure;
+			if(!failure)
+				this->entries.push_back(entry);
+			this->freeFrames.push_back(frame);
+			--this->writing;
+		}
+		this->frameReleased.notify_all();
+	}
+}
+
+void VtkSeriesWriter::WriteCollection() {
+	// Frames finish out of order on several threads.
+	std::vector<Entry> sorted(this->entries);
+	std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b){ return a.step < b.step; });
+	std::string text = "<?xml version=\"1.0\"?>\n<VTKFile type=\"Collection\" version=\"0.1\">\n  <Collection>\n";
+	for(const Entry& entry : sorted){
+		std::size_t slash = entry.file.find_last_of('/');
+		text += "    <DataSet timestep=\"" + Number(entry.time) + "\" file=\""
+			+ (slash == std::string::npos ? entry.file : entry.file.substr(slash + 1)) + "\"/>\n";
+	}
+	text += "  </Collection>\n</VTKFile>\n";
+	std::string path = this->prefix + ".pvd";
+	std::ofstream out(path.c_str(), std::ios::trunc);
+	out << text;
+	out.close();
+	if(!out)
+		throw(std::runtime_error("VtkSeriesWriter: cannot write " + path));
+}
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <mpreal.h>
+#include <Trace.h>
+#include "AllocationTracker.h"
+
+using namespace GeometricalSolid;
+
+namespace {
+	std::atomic<std::uint64_t> allocations[AllocationCounts::entries];
+	std::atomic<std::uint64_t> bytes[AllocationCounts::entries];
+	
+	void Count(std::size_t size) {
+		int phase = static_cast<int>(Trace::Current());
+		allocations[phase].fetch_add(1, std::memory_order_relaxed);
+		bytes[phase].fetch_add(size, std::memory_order_relaxed);
+	}
+	
+	void* Allocate(std::size_t size) {
+		void* pointer = std::malloc(size > 0 ? size : 1);
+		if(pointer != nullptr)
+			Count(size);
+		return pointer;
+	}
+	
+	void* GmpAllocate(std::size_t size) {
+		void* pointer = Allocate(size);
+		if(pointer == nullptr)
+			std::abort();
+		return pointer;
+	}
+	
+	void* GmpReallocate(void* pointer, std::size_t, std::size_t size) {
+		pointer = std::realloc(pointer, size);
+		if(pointer == nullptr)
+			std::abort();
+		Count(size);
+		return pointer;
+	}
+	
+	void GmpFree(void* pointer, std::size_t) {
+		std::free(pointer);
+	}
+}
+
+void* operator new(std::size_t size) {
+	void* pointer = Allocate(size);
+	if(pointer == nullptr)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+	std::free(pointer);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+#endif
+
+std::uint64_t AllocationCounts::Allocations() const {
+	std::uint64_t total = 0;
+	for(int e = 0 ; e < entries ; ++e)
+		total += this->allocations[e];
+	return total;
+}
+
+std::uint64_t AllocationCounts::Bytes() const {
+	std::uint64_t total = 0;
+	for(int e = 0 ; e < entries ; ++e)
+		total += this->bytes[e];
+	return total;
+}
+
+AllocationCounts AllocationCounts::operator-(const AllocationCounts& earlier) const {
+	AllocationCounts difference;
+	for(int e = 0 ; e < entries ; ++e){
+		difference.allocations[e] = this->allocations[e] - earlier.allocations[e];
+		difference.bytes[e] = this->bytes[e] - earlier.bytes[e];
+	}
+	return difference;
+}
+
+AllocationCounts AllocationTracker::Counts() {
+	AllocationCounts counts;
+	for(int e = 0 ; e < AllocationCounts::entries ; ++e){
+		counts.allocations[e] = allocations[e].load(std::memory_order_relaxed);
+		counts.bytes[e] = bytes[e].load(std::memory_order_relaxed);
+	}
+	return counts;
+}
+
+void AllocationTracker::TrackGmp() {
+	mp_set_memory_functions(GmpAllocate, GmpReallocate, GmpFree);
+}
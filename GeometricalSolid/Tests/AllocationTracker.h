@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <Phase.h>
+
+namespace GeometricalSolid {
+	
+	// Allocations per phase of the allocating thread; the last entry counts those made
+	// outside of any phase.
+	struct AllocationCounts{
+		static const int entries = static_cast<int>(Phase::Count) + 1;
+		
+		std::uint64_t allocations[entries];
+		std::uint64_t bytes[entries];
+		
+		std::uint64_t Allocations() const;
+		std::uint64_t Bytes() const;
+		std::uint64_t Allocations(Phase phase) const { return this->allocations[static_cast<int>(phase)]; }
+		std::uint64_t Bytes(Phase phase) const { return this->bytes[static_cast<int>(phase)]; }
+		
+		AllocationCounts operator-(const AllocationCounts& earlier) const;
+	};
+	
+	// Counts the global operator new of the executables that link AllocationTracker.cpp,
+	// the tests and the benchmarks, which replaces it.
+	class AllocationTracker{
+	public:
+		static AllocationCounts Counts();
+		// Counts the GMP allocations too, those of mpreal among them.
+		static void TrackGmp();
+	};
+	
+}
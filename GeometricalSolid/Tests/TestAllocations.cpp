@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <thread>
+#include "AllocationTracker.h"
+#include <mpreal.h>
+#include <Profiler.h>
+#include <Simulation.h>
+#include <Sphere.h>
+#include <Disk.h>
+#include <Rectangle.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class AllocationsTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {}
+	virtual void TearDown() {}
+	
+	// Dense packing of spheres, disks and plates, so that contacts open and close.
+	static std::unique_ptr<Simulation> Packing(std::size_t threads, std::size_t reorderPeriod) {
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::vector<Solid> solids;
+		for(int i = 0 ; i < 800 ; ++i){
+			std::unique_ptr<Shape> shape;
+			if(i % 4 == 2)
+				shape.reset(new Disk(0.005, 0.002, 2500));
+			else if(i % 4 == 3)
+				shape.reset(new Rectangle(0.01, 0.006, 0.002, 2500));
+			else
+				shape.reset(new Sphere(0.005, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1*unit(generator), 0.1*unit(generator), 0.1*unit(generator)), Quaternion<double>()));
+			solids.back().Velocity(Vector<double>(unit(generator) - 0.5, unit(generator) - 0.5, unit(generator) - 0.5));
+			solids.back().AngularVelocity(Vector<double>(unit(generator) - 0.5, unit(generator) - 0.5, unit(generator) - 0.5));
+		}
+		SimulationOptions options;
+		options.timeStep = 1e-4;
+		options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(0.1, 0.1, 0.1));
+		options.threads = threads;
+		options.reorderPeriod = reorderPeriod;
+		return std::unique_ptr<Simulation>(new Simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options));
+	}
+};
+
+TEST_F(AllocationsTest,CountsNew) {
+	AllocationCounts before = AllocationTracker::Counts();
+	std::unique_ptr<std::vector<double>> values(new std::vector<double>(100));
+	AllocationCounts counts = AllocationTracker::Counts() - before;
+	EXPECT_EQ(2u, counts.Allocations());
+	EXPECT_EQ(sizeof(std::vector<double>) + 100*sizeof(double), counts.Bytes());
+	EXPECT_EQ(2u, counts.Allocations(Phase::Count));
+}
+
+#ifdef GEOMETRICALSOLID_PROFILING
+TEST_F(AllocationsTest,CountsPerPhase) {
+	AllocationCounts before = AllocationTracker::Counts();
+	{
+		PROFILE_PHASE(Output);
+		std::vector<double> values(10);
+		ThreadPool pool(3);
+		pool.ParallelFor(3, [](std::size_t, std::size_t, std::size_t){
+			std::vector<int> chunk(4);
+		});
+	}
+	AllocationCounts counts = AllocationTracker::Counts() - before;
+	// The vector and the chunks of the three threads; starting the workers is counted too.
+	EXPECT_GE(counts.Allocations(Phase::Output), 4u);
+	EXPECT_GE(counts.Bytes(Phase::Output), 10*sizeof(double) + 3*4*sizeof(int));
+	EXPECT_EQ(0u, counts.Allocations(Phase::Contacts));
+}
+#endif
+
+TEST_F(AllocationsTest,SteadyStepDoesNotAllocate) {
+	// With a deadline every step overruns and is recorded, starting in the measured steps.
+	for(double deadline : {0.0, 1e-9})
+		for(std::size_t threads : {1, 3}){
+			std::unique_ptr<Simulation> simulation = Packing(threads, 25);
+			simulation->Run(100);
+			ASSERT_GT(simulation->Engine().ActiveContacts(), 0u);
+			simulation->Latency().Deadline(deadline);
+			AllocationCounts before = AllocationTracker::Counts();
+			simulation->Run(100);
+			AllocationCounts counts = AllocationTracker::Counts() - before;
+			EXPECT_EQ(0u, counts.Allocations()) << threads << " threads, deadline " << deadline;
+			for(int p = 0 ; p < static_cast<int>(Phase::Count) ; ++p)
+				EXPECT_EQ(0u, counts.Allocations(static_cast<Phase>(p))) << PhaseName(static_cast<Phase>(p));
+			EXPECT_EQ(deadline > 0 ? 100u : 0u, simulation->Latency().OverrunCount());
+		}
+}
+
+TEST_F(AllocationsTest,Mpreal) {
+	AllocationTracker::TrackGmp();
+	AllocationCounts before = AllocationTracker::Counts();
+	{
+		mpfr::mpreal a(1.5, 200), b(2.5, 200);
+		a *= b;
+	}
+	EXPECT_GT((AllocationTracker::Counts() - before).Allocations(), 0u);
+}
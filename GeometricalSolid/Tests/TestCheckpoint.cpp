@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <dirent.h>
+#include <unistd.h>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <CheckpointWriter.h>
+#include <CheckpointReader.h>
+#include <SpatialReorder.h>
+#include <Simulation.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class CheckpointTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::string directory;
+	std::mt19937 generator{7};
+	std::uniform_real_distribution<double> value{-1, 1};
+protected:
+	virtual void SetUp() {
+		directory = "CheckpointTest.dir";
+		for(int i = 0 ; i < 1000 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(i % 4 == 0 ? 0.02 : 0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(value(generator), value(generator), value(generator)), Quaternion<double>()));
+		}
+	}
+	virtual void TearDown() {
+		DIR* entries = opendir(directory.c_str());
+		if(!entries)
+			return;
+		while(dirent* entry = readdir(entries))
+			if(entry->d_name[0] != '.')
+				std::remove((directory + "/" + entry->d_name).c_str());
+		closedir(entries);
+		rmdir(directory.c_str());
+	}
+	
+	std::size_t FileCount() const {
+		std::size_t count = 0;
+		DIR* entries = opendir(directory.c_str());
+		while(dirent* entry = readdir(entries))
+			count += entry->d_name[0] != '.';
+		closedir(entries);
+		return count;
+	}
+	
+	void Move(std::size_t count) {
+		for(std::size_t i = 0 ; i < count ; ++i){
+			Solid& solid = solids[(i*37) % solids.size()];
+			solid.Velocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solid.AngularVelocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solid.UpdatePosition(1e-3);
+			solid.LockRotation(i % 2 == 0, false, false);
+		}
+	}
+	
+	static void ExpectEqual(const Vector<double>& a, const Vector<double>& b) {
+		EXPECT_EQ(a.ComponantX(), b.ComponantX());
+		EXPECT_EQ(a.ComponantY(), b.ComponantY());
+		EXPECT_EQ(a.ComponantZ(), b.ComponantZ());
+	}
+	
+	void ExpectRestored() {
+		this->ExpectRestored(solids);
+	}
+	
+	void ExpectRestored(const std::vector<Solid>& expected) {
+		std::vector<Solid> restored;
+		CheckpointReader(directory).Load(restored);
+		ASSERT_EQ(expected.size(), restored.size());
+		for(std::size_t i = 0 ; i < expected.size() ; ++i){
+			EXPECT_FALSE(restored[i].IsDirty());
+			EXPECT_EQ(expected[i].Basis().Origin().CoordinateX(), restored[i].Basis().Origin().CoordinateX());
+			EXPECT_EQ(expected[i].Basis().Origin().CoordinateZ(), restored[i].Basis().Origin().CoordinateZ());
+			EXPECT_EQ(expected[i].Basis().Orientation().ComponantJ(), restored[i].Basis().Orientation().ComponantJ());
+			ExpectEqual(expected[i].Velocity(), restored[i].Velocity());
+			ExpectEqual(expected[i].AngularVelocity(), restored[i].AngularVelocity());
+			EXPECT_EQ(expected[i].IsXRotationLocked(), restored[i].IsXRotationLocked());
+			EXPECT_EQ(static_cast<const Sphere*>(expected[i].Shape())->Radius(), static_cast<const Sphere*>(restored[i].Shape())->Radius());
+			EXPECT_EQ(0, restored[i].Force().Norme());
+		}
+	}
+};
+
+TEST_F(CheckpointTest,DirtyTracking) {
+	Solid& solid = solids[0];
+	EXPECT_TRUE(solid.IsDirty());
+	solid.ClearDirty();
+	EXPECT_FALSE(solid.IsDirty());
+	
+	// A body at rest without load stays clean through a step.
+	solid.ResetForceAndMomemtum();
+	solid.AddForce(Vector<double>(0, 0, 0));
+	solid.UpdateVelocities(1e-3);
+	solid.UpdatePosition(1e-3);
+	EXPECT_FALSE(solid.IsDirty());
+	
+	// Loads are recomputed every step, only what they integrate into counts.
+	solid.AddForce(Vector<double>(0, 0, -1));
+	solid.AddMomentum(Vector<double>(1, 0, 0));
+	EXPECT_FALSE(solid.IsDirty());
+	solid.UpdateVelocities(1e-3);
+	EXPECT_TRUE(solid.IsDirty());
+	solid.ClearDirty();
+	solid.UpdatePosition(1e-3);
+	EXPECT_TRUE(solid.IsDirty());
+	solid.ClearDirty();
+	solid.ResetForceAndMomemtum();
+	solid.Force(Vector<double>(0, 0, -2));
+	EXPECT_FALSE(solid.IsDirty());
+	
+	solid.ClearDirty();
+	solid.LockTranslation(true, false, false);
+	EXPECT_TRUE(solid.IsDirty());
+}
+
+TEST_F(CheckpointTest,DeltaChain) {
+	CheckpointOptions options;
+	options.maximumDeltas = 3;
+	CheckpointWriter writer(directory, options);
+	EXPECT_EQ(solids.size(), writer.Write(solids, 0, 0));
+	EXPECT_FALSE(solids[0].IsDirty());
+	ExpectRestored();
+	
+	Move(10);
+	EXPECT_EQ(10u, writer.Write(solids, 10, 0.01));
+	EXPECT_EQ(0u, writer.Write(solids, 20, 0.02));
+	Move(25);
+	EXPECT_EQ(25u, writer.Write(solids, 30, 0.03));
+	EXPECT_EQ(3u, writer.Manifest().deltas.size());
+	ExpectRestored();
+	EXPECT_EQ(30u, CheckpointReader(directory).Step());
+	EXPECT_EQ(0.03, CheckpointReader(directory).Time());
+	
+	// Compaction replaces the whole chain with a new base.
+	Move(5);
+	EXPECT_EQ(solids.size(), writer.Write(solids, 40, 0.04));
+	EXPECT_EQ(0u, writer.Manifest().deltas.size());
+	EXPECT_EQ(2u, FileCount());
+	ExpectRestored();
+	
+	EXPECT_EQ(2u, writer.Statistics().fullCheckpoints);
+	EXPECT_EQ(3u, writer.Statistics().deltaCheckpoints);
+	EXPECT_EQ(2*solids.size() + 35, writer.Statistics().solidsWritten);
+}
+
+TEST_F(CheckpointTest,FullWhenMostlyDirty) {
+	CheckpointWriter writer(directory);
+	writer.Write(solids, 0, 0);
+	Move(solids.size()*3/4);
+	EXPECT_EQ(solids.size(), writer.Write(solids, 1, 0));
+	EXPECT_TRUE(writer.Manifest().deltas.empty());
+	ExpectRestored();
+}
+
+TEST_F(CheckpointTest,Reorder) {
+	// A delta after a reorder has to rewrite the solids at their new indices.
+	CheckpointOptions options;
+	options.fullFraction = 1;
+	CheckpointWriter writer(directory, options);
+	writer.Write(solids, 0, 0);
+	Move(1);
+	SpatialReorder reorder(1);
+	reorder.Reorder(solids);
+	EXPECT_GT(writer.Write(solids, 1, 0), 1u);
+	EXPECT_EQ(1u, writer.Manifest().deltas.size());
+	ExpectRestored();
+}
+
+TEST_F(CheckpointTest,Simulation) {
+	// Locked bodies under gravity stay clean: only the falling ones go in the deltas.
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		solids[i].Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1*(i % 10), 0.1*(i/10 % 10), 0.1*(i/100)), Quaternion<double>()));
+		bool locked = i % 20 != 0;
+		solids[i].LockTranslation(locked, locked, locked);
+		solids[i].LockRotation(locked, locked, locked);
+	}
+	SimulationOptions options;
+	options.timeStep = 1e-4;
+	options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(1, 1, 1));
+	Simulation simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options);
+	
+	CheckpointWriter writer(directory);
+	EXPECT_EQ(simulation.Solids().size(), writer.Write(simulation.Solids(), 0, 0));
+	for(int checkpoint = 1 ; checkpoint <= 3 ; ++checkpoint){
+		simulation.Run(10);
+		EXPECT_EQ(simulation.Solids().size()/20, writer.Write(simulation.Solids(), simulation.StepCount(), simulation.Time()));
+	}
+	EXPECT_EQ(3u, writer.Manifest().deltas.size());
+	EXPECT_EQ(1u, writer.Statistics().fullCheckpoints);
+	EXPECT_EQ(3u, writer.Statistics().deltaCheckpoints);
+	ExpectRestored(simulation.Solids());
+}
+
+TEST_F(CheckpointTest,SolidWithoutShape) {
+	CheckpointWriter writer(directory);
+	writer.Write(solids, 0, 0);
+	solids.back().Shape(std::unique_ptr<Shape>());
+	bool thrown = false;
+	try{
+		writer.Write(solids, 1, 0);
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
+
+TEST_F(CheckpointTest,Resume) {
+	{
+		CheckpointWriter writer(directory);
+		writer.Write(solids, 0, 0);
+		Move(3);
+		writer.Write(solids, 1, 0);
+	}
+	CheckpointWriter writer(directory);
+	Move(4);
+	EXPECT_EQ(4u, writer.Write(solids, 2, 0));
+	EXPECT_EQ(2u, writer.Manifest().deltas.size());
+	EXPECT_EQ(4u, FileCount());
+	ExpectRestored();
+}
+
+TEST_F(CheckpointTest,Missing) {
+	bool thrown = false;
+	try{
+		CheckpointReader reader(directory);
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+	EXPECT_FALSE(CheckpointReader::Exists(directory));
+}
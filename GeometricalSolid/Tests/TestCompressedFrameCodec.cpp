@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <TrajectoryWriter.h>
+#include <CompressedFrameCodec.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class CompressedFrameCodecTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::vector<TrajectoryFrame> frames;
+	CompressedFrameOptions options;
+	std::string path;
+protected:
+	virtual void SetUp() {
+		path = "CompressedFrameCodecTest.traj";
+		options.domain = PeriodicBox<double>(Point<double>(-1, -1, 0), Point<double>(1, 1, 4));
+		options.positionTolerance = 1e-6;
+		options.velocityTolerance = 1e-5;
+		options.keyframeInterval = 10;
+		
+		std::mt19937 generator(11);
+		std::uniform_real_distribution<double> value(-1, 1);
+		for(int i = 0 ; i < 500 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+			q.Normalize();
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(value(generator), value(generator), 2 + 2*value(generator)), q));
+			solids.back().Velocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().AngularVelocity(Vector<double>(10*value(generator), 10*value(generator), 10*value(generator)));
+		}
+		for(int step = 0 ; step < 100 ; ++step){
+			frames.push_back(TrajectoryFrame());
+			frames.back().Capture(solids, step, 1e-3*step);
+			for(auto& solid : solids)
+				solid.UpdatePosition(1e-3, options.domain);
+		}
+	}
+	virtual void TearDown() {
+		std::remove(path.c_str());
+	}
+	
+	void ExpectClose(const TrajectoryFrame& a, const TrajectoryFrame& b) {
+		ASSERT_EQ(a.SolidCount(), b.SolidCount());
+		EXPECT_EQ(a.step, b.step);
+		EXPECT_EQ(a.time, b.time);
+		for(std::size_t i = 0 ; i < a.SolidCount() ; ++i){
+			// The largest domain length is 4.
+			for(int axis = 0 ; axis < 3 ; ++axis){
+				EXPECT_NEAR(a.origins[3*i + axis], b.origins[3*i + axis], 4*options.positionTolerance*(1 + 1e-9));
+				EXPECT_NEAR(a.velocities[3*i + axis], b.velocities[3*i + axis], options.velocityTolerance*(1 + 1e-9));
+				EXPECT_NEAR(a.angularVelocities[3*i + axis], b.angularVelocities[3*i + axis], options.velocityTolerance*(1 + 1e-6));
+			}
+			// q and -q are the same rotation.
+			double dot = 0;
+			for(int k = 0 ; k < 4 ; ++k)
+				dot += a.orientations[4*i + k]*b.orientations[4*i + k];
+			EXPECT_NEAR(1, fabs(dot), 1e-8);
+		}
+	}
+};
+
+TEST_F(CompressedFrameCodecTest,Lz) {
+	LzCompressor compressor;
+	std::mt19937 generator(3);
+	std::vector<std::string> inputs;
+	inputs.push_back("");
+	inputs.push_back("abc");
+	inputs.push_back(std::string(100000, 'x'));
+	std::string text;
+	for(int i = 0 ; i < 5000 ; ++i)
+		text += "solid " + std::to_string(i % 37) + " ";
+	inputs.push_back(text);
+	std::string noise;
+	for(int i = 0 ; i < 70000 ; ++i)
+		noise.push_back(static_cast<char>(generator()));
+	inputs.push_back(noise);
+	
+	for(const auto& input : inputs){
+		std::string compressed;
+		compressor.Compress(input.data(), input.size(), compressed);
+		std::string output(input.size(), '\0');
+		LzCompressor::Decompress(compressed.data(), compressed.size(), &output[0], output.size());
+		EXPECT_EQ(input, output);
+	}
+	
+	std::string compressed;
+	compressor.Compress(text.data(), text.size(), compressed);
+	EXPECT_LT(compressed.size(), text.size()/5);
+	std::string output(text.size(), '\0');
+	bool thrown = false;
+	try{
+		LzCompressor::Decompress(compressed.data(), compressed.size() - 3, &output[0], output.size());
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
+
+TEST_F(CompressedFrameCodecTest,RoundTrip) {
+	std::string bytes;
+	CompressedFrameEncoder encoder(options);
+	for(const auto& frame : frames)
+		encoder.Encode(frame, bytes);
+	{
+		std::ofstream out(path.c_str(), std::ios::binary);
+		out.write(bytes.data(), bytes.size());
+	}
+	
+	std::string raw;
+	BinaryFrameEncoder binary;
+	for(const auto& frame : frames)
+		binary.Encode(frame, raw);
+	EXPECT_LT(bytes.size(), raw.size()/3);
+	
+	CompressedTrajectoryReader reader(path);
+	ASSERT_EQ(frames.size(), reader.FrameCount());
+	EXPECT_EQ(10u, reader.KeyframeCount());
+	EXPECT_EQ(42u, reader.Step(42));
+	TrajectoryFrame frame;
+	for(std::size_t k = 0 ; k < frames.size() ; ++k){
+		reader.Read(k, frame);
+		ExpectClose(frames[k], frame);
+	}
+	// Random access, backwards and within the same keyframe interval.
+	std::size_t order[] = {57, 3, 99, 55, 55, 0, 61};
+	for(auto k : order){
+		reader.Read(k, frame);
+		ExpectClose(frames[k], frame);
+	}
+}
+
+TEST_F(CompressedFrameCodecTest,ThroughWriter) {
+	{
+		TrajectoryWriter writer(path, std::unique_ptr<FrameEncoder>(new CompressedFrameEncoder(options)));
+		for(int step = 0 ; step < 25 ; ++step){
+			writer.Capture(solids, step, 0);
+			for(auto& solid : solids)
+				solid.UpdatePosition(1e-3, options.domain);
+		}
+	}
+	CompressedTrajectoryReader reader(path);
+	EXPECT_EQ(25u, reader.FrameCount());
+	EXPECT_EQ(3u, reader.KeyframeCount());
+	TrajectoryFrame last, frame;
+	last.Capture(solids, 24, 0);
+	reader.Read(24, frame);
+	// The solids moved once more after the last capture.
+	EXPECT_NEAR(last.origins[0] - 1e-3*last.velocities[0], frame.origins[0], 1e-5);
+}
+
+TEST_F(CompressedFrameCodecTest,DroppedFields) {
+	// Forces and momentums are not encoded, nor velocities without a tolerance.
+	for(auto& solid : solids){
+		solid.Force(Vector<double>(1, 2, 3));
+		solid.Momentum(Vector<double>(4, 5, 6));
+	}
+	TrajectoryFrame captured;
+	captured.Capture(solids, 7, 0);
+	options.velocityTolerance = 0;
+	std::string bytes;
+	CompressedFrameEncoder(options).Encode(captured, bytes);
+	{
+		std::ofstream out(path.c_str(), std::ios::binary);
+		out.write(bytes.data(), bytes.size());
+	}
+	
+	CompressedTrajectoryReader reader(path);
+	TrajectoryFrame frame;
+	reader.Read(0, frame);
+	ASSERT_EQ(captured.SolidCount(), frame.SolidCount());
+	EXPECT_NEAR(captured.origins[0], frame.origins[0], 4*options.positionTolerance*(1 + 1e-9));
+	EXPECT_NE(0, captured.forces[2]);
+	EXPECT_NE(0, captured.velocities[0]);
+	for(std::size_t i = 0 ; i < 3*frame.SolidCount() ; ++i){
+		EXPECT_EQ(0, frame.forces[i]);
+		EXPECT_EQ(0, frame.momentums[i]);
+		EXPECT_EQ(0, frame.velocities[i]);
+		EXPECT_EQ(0, frame.angularVelocities[i]);
+	}
+}
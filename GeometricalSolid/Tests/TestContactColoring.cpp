@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <condition_variable>
+#include <random>
+#include <set>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <ContactColoring.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class ContactColoringTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::vector<ContactPair> pairs;
+protected:
+	virtual void SetUp() {
+		std::mt19937 generator(3);
+		std::uniform_real_distribution<double> position(0, 0.15);
+		for(int i = 0 ; i < 1000 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(position(generator), position(generator), position(generator)), Quaternion<double>()));
+			solids.back().Velocity(Vector<double>(position(generator), 0, -position(generator)));
+		}
+		VerletList list(0);
+		list.Build(solids);
+		for(std::uint32_t i = 0 ; i < list.SolidCount() ; ++i)
+			for(const std::uint32_t* j = list.Begin(i) ; j != list.End(i) ; ++j)
+				pairs.push_back(ContactPair{i, *j});
+	}
+	virtual void TearDown() {}
+	
+	void ExpectValid(const ContactColoring& coloring) {
+		EXPECT_EQ(pairs.size(), coloring.Pairs().size());
+		std::set<std::pair<std::uint32_t, std::uint32_t>> all;
+		for(std::size_t color = 0 ; color < coloring.ColorCount() ; ++color){
+			EXPECT_LT(coloring.BatchBegin(color), coloring.BatchEnd(color));
+			std::set<std::uint32_t> batchSolids;
+			for(std::size_t p = coloring.BatchBegin(color) ; p < coloring.BatchEnd(color) ; ++p){
+				const ContactPair& pair = coloring.Pairs()[p];
+				EXPECT_TRUE(batchSolids.insert(pair.first).second);
+				EXPECT_TRUE(batchSolids.insert(pair.second).second);
+				all.insert(std::make_pair(pair.first, pair.second));
+			}
+		}
+		EXPECT_EQ(pairs.size(), all.size());
+	}
+};
+
+TEST_F(ContactColoringTest,Greedy) {
+	ASSERT_GT(pairs.size(), 1000u);
+	ContactColoring coloring;
+	coloring.Color(pairs, solids.size());
+	ExpectValid(coloring);
+}
+
+TEST_F(ContactColoringTest,JonesPlassmann) {
+	ThreadPool pool(3);
+	ContactColoring coloring;
+	coloring.ColorParallel(pairs, solids.size(), pool);
+	ExpectValid(coloring);
+	EXPECT_GT(coloring.Rounds(), 1u);
+}
+
+TEST_F(ContactColoringTest,ManyColors) {
+	// A star of 200 pairs around one solid needs one color per pair.
+	std::vector<ContactPair> star;
+	for(std::uint32_t i = 1 ; i <= 200 ; ++i)
+		star.push_back(ContactPair{0, i});
+	ContactColoring coloring;
+	coloring.Color(star, 201);
+	EXPECT_EQ(200u, coloring.ColorCount());
+	ThreadPool pool(2);
+	coloring.ColorParallel(star, 201, pool);
+	EXPECT_EQ(200u, coloring.ColorCount());
+}
+
+TEST_F(ContactColoringTest,ParallelApply) {
+	std::unique_ptr<ContactForceModel> model(new HertzMindlinModel(1e7, 0.3, 0.8, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Apply(solids, pairs, 1e-5);
+	std::vector<Vector<double>> forces, momentums;
+	for(auto& solid : solids){
+		forces.push_back(solid.Force());
+		momentums.push_back(solid.Momentum());
+		solid.ResetForceAndMomemtum();
+	}
+	
+	std::unique_ptr<ContactForceModel> model2(new HertzMindlinModel(1e7, 0.3, 0.8, 0.5));
+	ContactForceEngine engine2(std::move(model2));
+	ThreadPool pool(4);
+	ContactColoring coloring;
+	coloring.ColorParallel(pairs, solids.size(), pool);
+	engine2.Apply(solids, coloring, pool, 1e-5);
+	
+	EXPECT_EQ(engine.ActiveContacts(), engine2.ActiveContacts());
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		EXPECT_NEAR(0, (forces[i] - solids[i].Force()).Norme(), 1e-9*(1 + forces[i].Norme()));
+		EXPECT_NEAR(0, (momentums[i] - solids[i].Momentum()).Norme(), 1e-9*(1 + momentums[i].Norme()));
+	}
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <condition_variable>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <Disk.h>
+#include <ContactForceEngine.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class ContactForceEngineTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::vector<ContactPair> pairs{{0, 1}};
+	double dt{1e-6};
+protected:
+	virtual void SetUp() {
+		for(int i = 0 ; i < 2 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+			solids.emplace_back(std::move(shape));
+		}
+		solids[1].Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.019, 0, 0), Quaternion<double>()));
+	}
+	virtual void TearDown() {}
+};
+
+TEST_F(ContactForceEngineTest,LinearNormalForce) {
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 1, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Apply(solids, pairs, dt);
+	
+	EXPECT_NEAR(-1e5*0.001, solids[0].Force().ComponantX(), 1e-9);
+	EXPECT_NEAR(1e5*0.001, solids[1].Force().ComponantX(), 1e-9);
+	EXPECT_MPREAL_EQ(0, solids[0].Force().ComponantY());
+	EXPECT_MPREAL_EQ(0, solids[0].Momentum().Norme());
+	EXPECT_EQ(1u, engine.ActiveContacts());
+}
+
+TEST_F(ContactForceEngineTest,HertzNormalForce) {
+	double young = 1e7, poisson = 0.3;
+	std::unique_ptr<ContactForceModel> model(new HertzMindlinModel(young, poisson, 1, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Apply(solids, pairs, dt);
+	
+	double effectiveYoung = young/(2*(1 - poisson*poisson));
+	double expected = 4./3.*effectiveYoung*sqrt(0.005)*pow(0.001, 1.5);
+	EXPECT_NEAR(-expected, solids[0].Force().ComponantX(), expected*1e-12);
+	EXPECT_NEAR(expected, solids[1].Force().ComponantX(), expected*1e-12);
+}
+
+TEST_F(ContactForceEngineTest,CoulombFriction) {
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 1, 0.5));
+	ContactForceEngine engine(std::move(model));
+	solids[0].Velocity(Vector<double>(0, 1, 0));
+	
+	for(int i = 0 ; i < 100 ; ++i){
+		solids[0].ResetForceAndMomemtum();
+		solids[1].ResetForceAndMomemtum();
+		engine.Apply(solids, pairs, 1e-3);
+	}
+	
+	double normalForce = 1e5*0.001;
+	EXPECT_NEAR(-0.5*normalForce, solids[0].Force().ComponantY(), 1e-9);
+	EXPECT_NEAR(0.5*normalForce, solids[1].Force().ComponantY(), 1e-9);
+	EXPECT_NEAR(-0.01*0.5*normalForce, solids[0].Momentum().ComponantZ(), 1e-9);
+	EXPECT_NEAR(-0.01*0.5*normalForce, solids[1].Momentum().ComponantZ(), 1e-9);
+}
+
+TEST_F(ContactForceEngineTest,TangentialHistory) {
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 1, 0.5));
+	ContactForceEngine engine(std::move(model));
+	solids[0].Velocity(Vector<double>(0, 1e-3, 0));
+	engine.Apply(solids, pairs, 1e-3);
+	engine.Apply(solids, pairs, 1e-3);
+	
+	auto entry = engine.History().Find(ContactHistory::Key(0, 1));
+	ASSERT_TRUE(entry != nullptr);
+	EXPECT_NEAR(2e-6, entry->tangentialDisplacement[1], 1e-15);
+	
+	solids[1].Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.03, 0, 0), Quaternion<double>()));
+	engine.Apply(solids, pairs, 1e-3);
+	EXPECT_EQ(0u, engine.ActiveContacts());
+}
+
+TEST_F(ContactForceEngineTest,BoundingRadius) {
+	// Non-spherical shapes collide through their bounding sphere.
+	for(auto& solid : solids)
+		solid.Shape(std::unique_ptr<Shape>(new Disk(0.01, 0.002, 2500)));
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 1, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Apply(solids, pairs, dt);
+	
+	double overlap = 2*sqrt(0.01*0.01 + 0.001*0.001) - 0.019;
+	EXPECT_NEAR(-1e5*overlap, solids[0].Force().ComponantX(), 1e-9);
+	EXPECT_EQ(1u, engine.ActiveContacts());
+}
+
+TEST_F(ContactForceEngineTest,RestitutionBounds) {
+	ContactCoefficients coefficients;
+	LinearSpringDashpotModel(1e4, 2e3, 1, 0.5).Coefficients(0, 0.005, 0.5, coefficients);
+	EXPECT_EQ(0, coefficients.normalDamping);
+	// A perfectly plastic contact is critically damped.
+	LinearSpringDashpotModel(1e4, 2e3, 0, 0.5).Coefficients(0, 0.005, 0.5, coefficients);
+	EXPECT_DOUBLE_EQ(2*sqrt(0.5*1e4), coefficients.normalDamping);
+	EXPECT_DOUBLE_EQ(2*sqrt(0.5*2e3), coefficients.tangentialDamping);
+	HertzMindlinModel(1e7, 0.3, 0, 0.5).Coefficients(1e-4, 0.005, 0.5, coefficients);
+	EXPECT_TRUE(std::isfinite(coefficients.normalDamping));
+	EXPECT_GT(coefficients.normalDamping, 0);
+	
+	for(double restitution : {-0.1, 1.1, std::nan("")}){
+		bool thrown = false;
+		try{
+			LinearSpringDashpotModel(1e4, 2e3, restitution, 0.5);
+		}
+		catch(const std::runtime_error&){
+			thrown = true;
+		}
+		EXPECT_TRUE(thrown) << restitution;
+	}
+}
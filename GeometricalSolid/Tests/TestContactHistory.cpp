@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "Precision.h"
+#include <ContactHistory.h>
+
+using namespace GeometricalSolid;
+
+TEST(ContactHistoryTest,Key) {
+	EXPECT_EQ(ContactHistory::Key(3, 7), ContactHistory::Key(7, 3));
+	EXPECT_NE(ContactHistory::Key(3, 7), ContactHistory::Key(3, 8));
+}
+
+TEST(ContactHistoryTest,FindOrInsert) {
+	ContactHistory history(4);
+	bool inserted = false;
+	auto entry = history.FindOrInsert(ContactHistory::Key(1, 2), 1, inserted);
+	EXPECT_TRUE(inserted);
+	EXPECT_MPREAL_EQ(0, entry->tangentialDisplacement[0]);
+	entry->tangentialDisplacement[0] = pi;
+	
+	entry = history.FindOrInsert(ContactHistory::Key(2, 1), 2, inserted);
+	EXPECT_FALSE(inserted);
+	EXPECT_MPREAL_EQ(pi, entry->tangentialDisplacement[0]);
+	EXPECT_EQ(2u, entry->lastStep);
+	EXPECT_EQ(1u, history.Size());
+	EXPECT_TRUE(history.Find(ContactHistory::Key(1, 3)) == nullptr);
+}
+
+TEST(ContactHistoryTest,Growth) {
+	ContactHistory history(4);
+	bool inserted = false;
+	for(std::uint32_t i = 0 ; i < 10000 ; ++i)
+		history.FindOrInsert(ContactHistory::Key(i, i + 1), 0, inserted)->tangentialDisplacement[2] = i;
+	
+	EXPECT_EQ(10000u, history.Size());
+	EXPECT_GE(history.Capacity(), 2*history.Size());
+	for(std::uint32_t i = 0 ; i < 10000 ; ++i){
+		auto entry = history.Find(ContactHistory::Key(i + 1, i));
+		ASSERT_TRUE(entry != nullptr);
+		EXPECT_MPREAL_EQ(i, entry->tangentialDisplacement[2]);
+	}
+}
+
+TEST(ContactHistoryTest,EvictStale) {
+	ContactHistory history;
+	bool inserted = false;
+	for(std::uint32_t i = 0 ; i < 100 ; ++i)
+		history.FindOrInsert(ContactHistory::Key(i, 1000), i % 2 == 0 ? 5 : 4, inserted);
+	
+	EXPECT_EQ(0u, history.EvictStale(5, 1));
+	EXPECT_EQ(50u, history.EvictStale(5));
+	EXPECT_EQ(50u, history.Size());
+	for(std::uint32_t i = 0 ; i < 100 ; ++i)
+		EXPECT_EQ(i % 2 == 0, history.Find(ContactHistory::Key(i, 1000)) != nullptr);
+	
+	EXPECT_TRUE(history.Erase(ContactHistory::Key(0, 1000)));
+	EXPECT_FALSE(history.Erase(ContactHistory::Key(0, 1000)));
+	history.FindOrInsert(ContactHistory::Key(0, 1000), 6, inserted);
+	EXPECT_TRUE(inserted);
+	EXPECT_EQ(50u, history.Size());
+}
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "Precision.h"
+#include <memory.h>
+#include "Disk.h"
+#include "Rectangle.h"
+
+using namespace GeometricalSolid;
+
+TEST(DiskTest,Constructor) {
+	Disk d(0.01, 0.002, 2500);
+	EXPECT_MPREAL_EQ(0.01, d.Radius());
+	EXPECT_MPREAL_EQ(0.002, d.Thickness());
+	EXPECT_MPREAL_EQ(2500, d.Density());
+	EXPECT_MPREAL_EQ(M_PI*0.0001*0.002, d.Volume());
+	EXPECT_MPREAL_EQ(2500*M_PI*0.0001*0.002, d.Mass());
+	EXPECT_MPREAL_EQ(sqrt(0.0001 + 0.000001), d.BoundingRadius());
+	EXPECT_NEAR(2/(d.Mass()*0.0001), d.InvertedIntertia().Element(2, 2), 1e-6);
+	EXPECT_TRUE(Shape::Form::Disk == d.Form());
+}
+
+TEST(RectangleTest,Constructor) {
+	Rectangle r(0.01, 0.006, 0.002, 2500);
+	EXPECT_MPREAL_EQ(0.01, r.Lenght());
+	EXPECT_MPREAL_EQ(0.006, r.Width());
+	EXPECT_MPREAL_EQ(0.002, r.Thickness());
+	EXPECT_MPREAL_EQ(1.2e-7, r.Volume());
+	EXPECT_MPREAL_EQ(2500*1.2e-7, r.Mass());
+	EXPECT_MPREAL_EQ(sqrt(0.0001 + 0.000036 + 0.000004)/2, r.BoundingRadius());
+	EXPECT_NEAR(12/(r.Mass()*(0.0001 + 0.000036)), r.InvertedIntertia().Element(2, 2), 1e-6);
+	EXPECT_TRUE(Shape::Form::Rectangle == r.Form());
+}
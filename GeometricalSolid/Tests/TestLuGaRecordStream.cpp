@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "Precision.h"
+#include <LuGaRecordStream.h>
+#include <Sphere.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class LuGaRecordStreamTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::string path;
+protected:
+	virtual void SetUp() {
+		path = "LuGaRecordStreamTest.txt";
+		std::mt19937 generator(13);
+		std::uniform_real_distribution<double> value(-1, 1);
+		for(int i = 0 ; i < 500 ; ++i){
+			solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+			Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+			q.Normalize();
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(value(generator), value(generator), value(generator)), q));
+			solids.back().Velocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().AngularVelocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().Force(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().Momentum(Vector<double>(value(generator), value(generator), value(generator)));
+		}
+	}
+	virtual void TearDown() {
+		std::remove(path.c_str());
+	}
+	
+	void Write(const std::string& text) {
+		std::ofstream out(path.c_str());
+		out << text;
+	}
+	
+	std::string Scene() const {
+		std::stringstream sstr;
+		for(const auto& solid : solids)
+			sstr << solid << "\n";
+		return sstr.str();
+	}
+	
+	static void ExpectEqual(const Vector<double>& a, const Vector<double>& b) {
+		EXPECT_EQ(a.ComponantX(), b.ComponantX());
+		EXPECT_EQ(a.ComponantY(), b.ComponantY());
+		EXPECT_EQ(a.ComponantZ(), b.ComponantZ());
+	}
+	
+	std::string Error(std::size_t bufferSize) {
+		try{
+			for(auto& solid : LuGaSolidStream(path, bufferSize))
+				(void)solid;
+		}
+		catch(const std::runtime_error& error){
+			return error.what();
+		}
+		return "";
+	}
+};
+
+TEST_F(LuGaRecordStreamTest,Solids) {
+	Write(Scene());
+	// Buffers smaller than a record, around its size and much larger.
+	for(std::size_t bufferSize : {std::size_t(7), std::size_t(512), std::size_t(1) << 20}){
+		std::size_t i = 0;
+		for(auto& solid : LuGaSolidStream(path, bufferSize)){
+			ASSERT_LT(i, solids.size());
+			EXPECT_EQ(nullptr, solid.Shape());
+			EXPECT_EQ(solids[i].Basis().Origin().CoordinateY(), solid.Basis().Origin().CoordinateY());
+			EXPECT_EQ(solids[i].Basis().Orientation().ComponantI(), solid.Basis().Orientation().ComponantI());
+			ExpectEqual(solids[i].Basis().AxisZ(), solid.Basis().AxisZ());
+			ExpectEqual(solids[i].Velocity(), solid.Velocity());
+			ExpectEqual(solids[i].AngularVelocity(), solid.AngularVelocity());
+			ExpectEqual(solids[i].Force(), solid.Force());
+			ExpectEqual(solids[i].Momentum(), solid.Momentum());
+			++i;
+		}
+		EXPECT_EQ(solids.size(), i);
+	}
+}
+
+TEST_F(LuGaRecordStreamTest,Bases) {
+	std::stringstream sstr;
+	for(const auto& solid : solids)
+		sstr << solid.Basis() << "\n";
+	std::string text = sstr.str();
+	Write(text.substr(0, text.size() - 1));
+	
+	LuGaBasisStream stream(path, 100);
+	std::size_t i = 0;
+	for(auto it = stream.begin() ; it != stream.end() ; ++it, ++i)
+		EXPECT_EQ(solids[i].Basis().Origin().CoordinateZ(), it->Origin().CoordinateZ());
+	EXPECT_EQ(solids.size(), i);
+	EXPECT_EQ(solids.size(), stream.RecordCount());
+}
+
+TEST_F(LuGaRecordStreamTest,Empty) {
+	Write(" \n\n");
+	std::size_t count = 0;
+	for(auto& solid : LuGaSolidStream(path)){
+		(void)solid;
+		++count;
+	}
+	EXPECT_EQ(0u, count);
+}
+
+TEST_F(LuGaRecordStreamTest,Malformed) {
+	std::string scene = Scene();
+	Write(scene + "1 2 3\n");
+	EXPECT_NE(std::string::npos, Error(64).find("record 500 "));
+	
+	std::string garbled = scene;
+	garbled[garbled.find('\n', 3000) + 1] = 'x';
+	Write(garbled);
+	EXPECT_NE(std::string::npos, Error(64).find("malformed"));
+	EXPECT_NE(std::string::npos, Error(1 << 20).find("malformed"));
+	
+	Write(std::string(10000, '1'));
+	EXPECT_NE(std::string::npos, Error(64).find("record 0 "));
+	
+	std::remove(path.c_str());
+	EXPECT_NE(std::string::npos, Error(64).find("cannot open"));
+}
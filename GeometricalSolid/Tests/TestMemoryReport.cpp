@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <MemoryReport.h>
+#include <Simulation.h>
+#include <Sphere.h>
+#include <Disk.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class MemoryReportTest : public ::testing::Test {
+public:
+	SimulationOptions options;
+protected:
+	virtual void SetUp() {
+		options.timeStep = 1e-4;
+		options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(0.1, 0.1, 0.1));
+	}
+	virtual void TearDown() {}
+	
+	// Spheres of radius 0.004, 1000 of them at a volume fraction of 0.27.
+	static std::vector<Solid> Spheres(std::size_t count) {
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::vector<Solid> solids;
+		solids.reserve(count);
+		for(std::size_t i = 0 ; i < count ; ++i){
+			solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.004, 2500)));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1*unit(generator), 0.1*unit(generator), 0.1*unit(generator)), Quaternion<double>()));
+			solids.back().Velocity(Vector<double>(unit(generator) - 0.5, unit(generator) - 0.5, unit(generator) - 0.5));
+		}
+		return solids;
+	}
+	
+	static std::unique_ptr<ContactForceModel> Model() {
+		return std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3));
+	}
+};
+
+TEST_F(MemoryReportTest,Measured) {
+	std::vector<Solid> solids = Spheres(100);
+	solids.emplace_back(std::unique_ptr<Shape>(new Disk(0.005, 0.002, 2500)));
+	options.threads = 2;
+	Simulation simulation(std::move(solids), Model(), options);
+	simulation.Run(5);
+	
+	MemoryReport report = simulation.Memory();
+	EXPECT_EQ(101u, report.Items(Subsystem::Solids));
+	// The solids outgrew the reserved vector.
+	EXPECT_EQ(simulation.Solids().capacity()*sizeof(Solid), report[Subsystem::Solids]);
+	EXPECT_DOUBLE_EQ(200.*sizeof(Solid)/101, report.PerItem(Subsystem::Solids));
+	EXPECT_EQ(100*sizeof(Sphere) + sizeof(Disk), report[Subsystem::Shapes]);
+	EXPECT_EQ(simulation.Neighbors().PairCount(), report.Items(Subsystem::Neighbors));
+	EXPECT_EQ(simulation.Neighbors().MemoryFootprint(), report[Subsystem::Neighbors]);
+	EXPECT_EQ(simulation.Engine().ActiveContacts(), report.Items(Subsystem::Contacts));
+	EXPECT_EQ(simulation.Engine().History().MemoryFootprint(), report[Subsystem::Contacts]);
+	EXPECT_EQ(simulation.Neighbors().PairCount(), report.Items(Subsystem::Coloring));
+	EXPECT_GT(report[Subsystem::Coloring], 0u);
+	EXPECT_GT(report[Subsystem::Profiling], 0u);
+	EXPECT_EQ(0.0, report.PerItem(Subsystem::Profiling));
+	
+	std::size_t total = 0;
+	for(int s = 0 ; s < static_cast<int>(Subsystem::Count) ; ++s)
+		total += report.bytes[s];
+	EXPECT_EQ(total, report.Total());
+	
+	std::stringstream text;
+	report.WriteText(text);
+	EXPECT_NE(std::string::npos, text.str().find("Neighbors"));
+	EXPECT_NE(std::string::npos, text.str().find("total"));
+}
+
+TEST_F(MemoryReportTest,EstimateMatchesRun) {
+	const std::size_t count = 1000;
+	const double volume = 4./3*M_PI*std::pow(0.004, 3);
+	const double fraction = count*volume/1e-3;
+	options.threads = 2;
+	options.reorderPeriod = 10;
+	MemoryEstimateOptions sizing;
+	sizing.neighborsPerSolid = MemoryReport::NeighborsPerSolid(fraction, 0.004, volume, options.skin);
+	// Overlaps of random positions: pairs closer than two radii.
+	sizing.contactsPerSolid = 0.5*fraction*8;
+	sizing.shapeBytes = sizeof(Sphere);
+	sizing.threads = options.threads;
+	sizing.reorder = true;
+	MemoryReport estimate = MemoryReport::Estimate(count, sizing);
+	
+	Simulation simulation(Spheres(count), Model(), options);
+	simulation.Run(20);
+	MemoryReport measured = simulation.Memory();
+	
+	for(Subsystem subsystem : {Subsystem::Solids, Subsystem::Shapes, Subsystem::Profiling})
+		EXPECT_EQ(measured[subsystem], estimate[subsystem]) << SubsystemName(subsystem);
+	// Overlaps of the random start push the solids apart: counts fall from there.
+	EXPECT_LE(measured.Items(Subsystem::Neighbors), estimate.Items(Subsystem::Neighbors));
+	EXPECT_GE(measured.Items(Subsystem::Neighbors), 0.7*estimate.Items(Subsystem::Neighbors));
+	// Estimates are peaks: buffers may not have grown as far yet.
+	for(Subsystem subsystem : {Subsystem::Neighbors, Subsystem::Contacts, Subsystem::Coloring, Subsystem::Reorder}){
+		EXPECT_LE(measured[subsystem], estimate[subsystem]) << SubsystemName(subsystem);
+		EXPECT_GE(measured[subsystem], 0.4*estimate[subsystem]) << SubsystemName(subsystem);
+	}
+	EXPECT_LE(measured.Total(), estimate.Total());
+	EXPECT_GE(measured.Total(), 0.6*estimate.Total());
+}
+
+TEST_F(MemoryReportTest,EstimateScales) {
+	MemoryReport small = MemoryReport::Estimate(1000);
+	MemoryReport large = MemoryReport::Estimate(100000);
+	EXPECT_EQ(100*small[Subsystem::Solids], large[Subsystem::Solids]);
+	EXPECT_EQ(0u, large[Subsystem::Coloring]);
+	EXPECT_EQ(small[Subsystem::Profiling], large[Subsystem::Profiling]);
+	EXPECT_GT(large.Total(), 50*small.Total());
+	EXPECT_EQ(3*sizeof(std::uint32_t), MemoryReport::Estimate(0)[Subsystem::Neighbors]);
+}
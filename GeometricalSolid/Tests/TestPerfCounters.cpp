@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <PerfCounters.h>
+#include <Profiler.h>
+#include <Simulation.h>
+#include <Sphere.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class PerfCountersTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		PerfCounters::Reset();
+	}
+	virtual void TearDown() {
+		PerfCounters::Stop();
+	}
+	
+	static PerfReport Handmade() {
+		PerfReport report;
+		PerfReport::Entry entry = {};
+		entry.calls = 2;
+		entry.values[static_cast<int>(Counter::Cycles)] = 1000;
+		entry.values[static_cast<int>(Counter::Instructions)] = 2000;
+		entry.values[static_cast<int>(Counter::L1Misses)] = 40;
+		report.threads.push_back(PerfReport::Phases(static_cast<int>(Phase::Count), PerfReport::Entry()));
+		report.threads.push_back(report.threads[0]);
+		report.threads[0][static_cast<int>(Phase::Contacts)] = entry;
+		report.threads[1][static_cast<int>(Phase::Contacts)] = entry;
+		for(int c = 0 ; c < static_cast<int>(Counter::Count) ; ++c)
+			report.available[c] = c != static_cast<int>(Counter::LlcMisses);
+		return report;
+	}
+};
+
+TEST_F(PerfCountersTest,DegradesGracefully) {
+	bool started = PerfCounters::Start();
+	EXPECT_EQ(started, PerfCounters::Counting());
+	bool any = false;
+	for(int c = 0 ; c < static_cast<int>(Counter::Count) ; ++c)
+		any |= PerfCounters::Available(static_cast<Counter>(c));
+	EXPECT_EQ(started, any);
+	if(!PerfCounters::Available(Counter::Cycles)){
+		EXPECT_FALSE(PerfCounters::Status().empty());
+	}
+	
+	// Reading works either way, unavailable counters stay at zero.
+	CounterSample sample;
+	PerfCounters::Read(sample);
+	for(int c = 0 ; c < static_cast<int>(Counter::Count) ; ++c){
+		if(!PerfCounters::Available(static_cast<Counter>(c))){
+			EXPECT_EQ(0u, sample.values[c]);
+		}
+	}
+}
+
+TEST_F(PerfCountersTest,CountsPhases) {
+	if(!PerfCounters::Start() || !PerfCounters::Available(Counter::Instructions)){
+		GTEST_SKIP() << "No instruction counter here: " << PerfCounters::Status();
+	}
+	volatile double sum = 0;
+	{
+		ScopedPhase phase(Phase::Output);
+		for(int i = 0 ; i < 100000 ; ++i)
+			sum = sum + i;
+	}
+	PerfReport report = PerfCounters::Report();
+	PerfReport::Entry total = report.Total(Phase::Output);
+	EXPECT_EQ(1u, total.calls);
+	EXPECT_GT(total[Counter::Instructions], 100000u);
+}
+
+TEST_F(PerfCountersTest,Text) {
+	std::stringstream out;
+	Handmade().WriteText(out, 10);
+	std::string text = out.str();
+	EXPECT_NE(std::string::npos, text.find("Contacts      all"));
+	// Cycles per call, IPC, then L1 misses per body and call.
+	EXPECT_NE(std::string::npos, text.find("500    2.00       2.000         n/a"));
+	EXPECT_NE(std::string::npos, text.find("              1"));
+	EXPECT_EQ(std::string::npos, text.find("Forces"));
+}
+
+TEST_F(PerfCountersTest,Json) {
+	std::stringstream out;
+	Handmade().WriteJson(out, 10);
+	std::string json = out.str();
+	EXPECT_EQ(0u, json.find("{\"bodies\": 10, \"available\": [\"cycles\", \"instructions\", \"l1_misses\", \"branch_misses\"]"));
+	EXPECT_NE(std::string::npos, json.find("{\"thread\": 1, \"calls\": 2, \"cycles\": 1000, \"instructions\": 2000, \"l1_misses\": 40, \"branch_misses\": 0}"));
+	EXPECT_EQ(std::string::npos, json.find("llc_misses"));
+}
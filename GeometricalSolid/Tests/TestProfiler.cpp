@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <Profiler.h>
+#include <Simulation.h>
+#include <Sphere.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class ProfilerTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		Profiler::Reset();
+	}
+	virtual void TearDown() {}
+};
+
+TEST_F(ProfilerTest,SumsThreads) {
+	std::vector<std::thread> threads;
+	for(int t = 0 ; t < 4 ; ++t)
+		threads.emplace_back([]{
+			for(int i = 0 ; i < 1000 ; ++i)
+				Profiler::Record(Phase::Output, 10);
+		});
+	for(auto& thread : threads)
+		thread.join();
+	Profiler::Record(Phase::Checkpoint, 0);
+	
+	ProfileReport report = Profiler::Report();
+	EXPECT_EQ(4000u, report[Phase::Output].calls);
+	EXPECT_NEAR(40000/Profiler::TicksPerSecond(), report[Phase::Output].seconds, 1e-3*report[Phase::Output].seconds);
+	EXPECT_EQ(1u, report[Phase::Checkpoint].calls);
+	EXPECT_EQ(0u, report[Phase::Contacts].calls);
+	EXPECT_GE(report.threads, 5u);
+}
+
+TEST_F(ProfilerTest,Reset) {
+	Profiler::Record(Phase::Output, 10);
+	Profiler::Reset();
+	EXPECT_EQ(0u, Profiler::Report()[Phase::Output].calls);
+	Profiler::Record(Phase::Output, 10);
+	EXPECT_EQ(1u, Profiler::Report()[Phase::Output].calls);
+}
+
+TEST_F(ProfilerTest,ScopedPhase) {
+	{
+		ScopedPhase phase(Phase::Output);
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	ProfileReport report = Profiler::Report();
+	EXPECT_EQ(1u, report[Phase::Output].calls);
+	EXPECT_GT(report[Phase::Output].seconds, 0.004);
+	EXPECT_LT(report[Phase::Output].seconds, 1);
+	EXPECT_GE(report.wallSeconds, report[Phase::Output].seconds);
+}
+
+TEST_F(ProfilerTest,Reports) {
+	Profiler::Record(Phase::Forces, 100);
+	Profiler::Record(Phase::Contacts, 300);
+	ProfileReport report = Profiler::Report();
+	
+	std::stringstream text;
+	report.WriteText(text);
+	EXPECT_NE(std::string::npos, text.str().find("Forces"));
+	EXPECT_NE(std::string::npos, text.str().find("75.0"));
+	EXPECT_EQ(std::string::npos, text.str().find("Positions"));
+	
+	std::stringstream json;
+	report.WriteJson(json);
+	EXPECT_NE(std::string::npos, json.str().find("{\"name\": \"Contacts\", \"calls\": 1, \"seconds\": "));
+	EXPECT_EQ(std::string::npos, json.str().find("Reorder"));
+}
+
+TEST_F(ProfilerTest,SimulationPhases) {
+	std::vector<Solid> solids;
+	solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+	SimulationOptions options;
+	options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(0.1, 0.1, 0.1));
+	Simulation simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options);
+	simulation.Run(10);
+	
+	ProfileReport report = Profiler::Report();
+#ifdef GEOMETRICALSOLID_PROFILING
+	for(Phase phase : {Phase::Reorder, Phase::Forces, Phase::Neighbors, Phase::Contacts, Phase::Velocities, Phase::Positions})
+		EXPECT_EQ(10u, report[phase].calls) << PhaseName(phase);
+#else
+	EXPECT_EQ(0u, report[Phase::Forces].calls);
+#endif
+	EXPECT_EQ(0u, report[Phase::Output].calls);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <SceneLoader.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class SceneLoaderTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::string path;
+protected:
+	virtual void SetUp() {
+		path = "SceneLoaderTest.txt";
+		std::mt19937 generator(11);
+		std::uniform_real_distribution<double> value(-1, 1);
+		for(int i = 0 ; i < 2000 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+			q.Normalize();
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(value(generator), value(generator), value(generator)), q));
+			solids.back().Velocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().AngularVelocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().Force(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().Momentum(Vector<double>(value(generator), value(generator), value(generator)));
+		}
+	}
+	virtual void TearDown() {
+		std::remove(path.c_str());
+	}
+	
+	void Write(const std::string& text) {
+		std::ofstream out(path.c_str());
+		out << text;
+	}
+	
+	std::string Scene() const {
+		std::stringstream sstr;
+		for(const auto& solid : solids)
+			sstr << solid << "\n";
+		return sstr.str();
+	}
+	
+	static void ExpectEqual(const Vector<double>& a, const Vector<double>& b) {
+		EXPECT_EQ(a.ComponantX(), b.ComponantX());
+		EXPECT_EQ(a.ComponantY(), b.ComponantY());
+		EXPECT_EQ(a.ComponantZ(), b.ComponantZ());
+	}
+	
+	void ExpectLoaded(const std::vector<Solid>& loaded) {
+		ASSERT_EQ(solids.size(), loaded.size());
+		for(std::size_t i = 0 ; i < solids.size() ; ++i){
+			EXPECT_EQ(solids[i].Basis().Origin().CoordinateX(), loaded[i].Basis().Origin().CoordinateX());
+			EXPECT_EQ(solids[i].Basis().Origin().CoordinateZ(), loaded[i].Basis().Origin().CoordinateZ());
+			EXPECT_EQ(solids[i].Basis().Orientation().ComponantReal(), loaded[i].Basis().Orientation().ComponantReal());
+			EXPECT_EQ(solids[i].Basis().Orientation().ComponantK(), loaded[i].Basis().Orientation().ComponantK());
+			ExpectEqual(solids[i].Basis().AxisX(), loaded[i].Basis().AxisX());
+			ExpectEqual(solids[i].Velocity(), loaded[i].Velocity());
+			ExpectEqual(solids[i].AngularVelocity(), loaded[i].AngularVelocity());
+			ExpectEqual(solids[i].Force(), loaded[i].Force());
+			ExpectEqual(solids[i].Momentum(), loaded[i].Momentum());
+		}
+	}
+	
+	static std::string Error(const std::string& path, std::size_t count) {
+		ThreadPool pool(2);
+		try{
+			SceneLoader loader(path, 100);
+			std::vector<Solid> loaded;
+			for(std::size_t i = 0 ; i < count ; ++i)
+				loaded.emplace_back(std::unique_ptr<Shape>());
+			loader.Load(loaded.data(), loaded.size(), pool);
+		}
+		catch(const std::runtime_error& error){
+			return error.what();
+		}
+		return "";
+	}
+};
+
+TEST_F(SceneLoaderTest,MatchesIstream) {
+	Write(Scene());
+	
+	std::vector<Solid> expected;
+	std::ifstream in(path.c_str());
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		expected.emplace_back(std::unique_ptr<Shape>());
+		in >> expected.back();
+	}
+	solids.swap(expected);
+	
+	ThreadPool pool(3);
+	for(std::size_t chunkSize : {std::size_t(1), std::size_t(97), std::size_t(4096), std::size_t(1) << 22}){
+		SceneLoader loader(path, chunkSize);
+		EXPECT_EQ(solids.size(), loader.RecordCount(pool));
+		std::vector<Solid> loaded;
+		loader.Load(loaded, pool);
+		ExpectLoaded(loaded);
+	}
+}
+
+TEST_F(SceneLoaderTest,KeepsShapes) {
+	Write(Scene());
+	ThreadPool pool(2);
+	SceneLoader loader(path);
+	std::vector<Solid> loaded;
+	loaded.emplace_back(std::unique_ptr<Shape>(new Sphere(0.5, 1000)));
+	loader.Load(loaded, pool);
+	ASSERT_EQ(solids.size(), loaded.size());
+	EXPECT_DOUBLE_EQ(0.5, static_cast<const Sphere*>(loaded[0].Shape())->Radius());
+	EXPECT_EQ(nullptr, loaded[1].Shape());
+}
+
+TEST_F(SceneLoaderTest,BlankLines) {
+	std::string text = "\n\n";
+	for(const auto& solid : solids){
+		std::stringstream sstr;
+		sstr << solid;
+		text += sstr.str() + "\r\n  \n";
+	}
+	Write(text);
+	ThreadPool pool(2);
+	SceneLoader loader(path, 64);
+	std::vector<Solid> loaded;
+	loader.Load(loaded, pool);
+	ExpectLoaded(loaded);
+}
+
+TEST_F(SceneLoaderTest,EmptyFile) {
+	Write("");
+	ThreadPool pool(2);
+	SceneLoader loader(path);
+	std::vector<Solid> loaded;
+	loader.Load(loaded, pool);
+	EXPECT_EQ(0u, loaded.size());
+}
+
+TEST_F(SceneLoaderTest,VerifiesRecords) {
+	solids.erase(solids.begin() + 10, solids.end());
+	std::string scene = Scene();
+	Write(scene);
+	EXPECT_EQ("", Error(path, 10));
+	EXPECT_NE(std::string::npos, Error(path, 9).find("holds 10 solids"));
+	
+	Write(scene + "1 2 3\n");
+	EXPECT_NE(std::string::npos, Error(path, 10).find("incomplete record"));
+	
+	std::string shifted = scene;
+	shifted.insert(shifted.find('\n'), "\t4");
+	Write(shifted);
+	EXPECT_NE(std::string::npos, Error(path, 10).find("record 0 "));
+	
+	// A short line does not take its missing number from the next one.
+	std::string shortened = scene;
+	std::size_t eol = shortened.find('\n');
+	std::size_t last = shortened.find_last_of(" \t", eol - 1);
+	std::string number = shortened.substr(last + 1, eol - last - 1);
+	shortened.erase(last, eol - last);
+	shortened.insert(shortened.find('\n') + 1, number + "\t");
+	Write(shortened);
+	EXPECT_NE(std::string::npos, Error(path, 10).find("record 0 "));
+	
+	std::string garbled = scene;
+	garbled[garbled.rfind('e')] = 'x';
+	Write(garbled);
+	EXPECT_NE(std::string::npos, Error(path, 10).find("record 9 "));
+	
+	EXPECT_NE(std::string::npos, Error("SceneLoaderTest.missing", 0).find("cannot open"));
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "Precision.h"
+#include <Simulation.h>
+#include <Solid.h>
+#include <Sphere.h>
+#include <Disk.h>
+#include <Rectangle.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class SimulationTest : public ::testing::Test {
+public:
+	SimulationOptions options;
+protected:
+	virtual void SetUp() {
+		options.timeStep = 1e-4;
+		options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(0.1, 0.1, 0.1));
+	}
+	virtual void TearDown() {}
+	
+	// Dense packing of spheres, disks and plates with random velocities.
+	static std::vector<Solid> Packing() {
+		std::mt19937 generator(3);
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::vector<Solid> solids;
+		for(int i = 0 ; i < 600 ; ++i){
+			std::unique_ptr<Shape> shape;
+			if(i % 4 == 2)
+				shape.reset(new Disk(0.005, 0.002, 2500));
+			else if(i % 4 == 3)
+				shape.reset(new Rectangle(0.01, 0.006, 0.002, 2500));
+			else
+				shape.reset(new Sphere(0.005, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1*unit(generator), 0.1*unit(generator), 0.1*unit(generator)), Quaternion<double>()));
+			solids.back().Velocity(Vector<double>(unit(generator) - 0.5, unit(generator) - 0.5, unit(generator) - 0.5));
+		}
+		return solids;
+	}
+	
+	static std::unique_ptr<ContactForceModel> Model() {
+		return std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3));
+	}
+};
+
+TEST_F(SimulationTest,FreeFall) {
+	std::vector<Solid> solids;
+	solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+	solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.05, 0.05, 0.05), Quaternion<double>()));
+	Simulation simulation(std::move(solids), Model(), options);
+	simulation.Run(100);
+	
+	EXPECT_EQ(100u, simulation.StepCount());
+	EXPECT_NEAR(0.01, simulation.Time(), 1e-15);
+	const Solid& solid = simulation.Solids()[0];
+	EXPECT_NEAR(-9.81*0.01, solid.Velocity().ComponantZ(), 1e-12);
+	EXPECT_EQ(0, solid.Velocity().ComponantX());
+	// Semi-implicit Euler: the position uses the updated velocity.
+	double z = 0.05 - 9.81*1e-4*1e-4*100*101/2;
+	EXPECT_NEAR(z, solid.Basis().Origin().CoordinateZ(), 1e-12);
+}
+
+TEST_F(SimulationTest,ThreadsMatchSequential) {
+	Simulation sequential(Packing(), Model(), options);
+	options.threads = 3;
+	Simulation parallel(Packing(), Model(), options);
+	sequential.Run(50);
+	parallel.Run(50);
+	EXPECT_GT(sequential.Engine().ActiveContacts(), 0u);
+	
+	// Only the summation order of the contact forces differs.
+	for(std::size_t i = 0 ; i < sequential.Solids().size() ; ++i){
+		const Solid& a = sequential.Solids()[i];
+		const Solid& b = parallel.Solids()[i];
+		EXPECT_NEAR(a.Velocity().ComponantX(), b.Velocity().ComponantX(), 1e-9);
+		EXPECT_NEAR(a.Velocity().ComponantZ(), b.Velocity().ComponantZ(), 1e-9);
+		EXPECT_NEAR(a.Basis().Origin().CoordinateY(), b.Basis().Origin().CoordinateY(), 1e-12);
+	}
+}
+
+TEST_F(SimulationTest,ReorderKeepsTrajectories) {
+	Simulation plain(Packing(), Model(), options);
+	options.reorderPeriod = 10;
+	Simulation reordered(Packing(), Model(), options);
+	plain.Run(35);
+	reordered.Run(35);
+	EXPECT_EQ(4u, reordered.Reorder().Reorders());
+	
+	for(std::uint32_t id = 0 ; id < plain.Solids().size() ; ++id){
+		const Solid& a = plain.Solids()[id];
+		const Solid& b = reordered.Solids()[reordered.Reorder().IndexOf(id)];
+		EXPECT_EQ(a.Shape()->Form(), b.Shape()->Form());
+		EXPECT_NEAR(a.Velocity().ComponantY(), b.Velocity().ComponantY(), 1e-9);
+		EXPECT_NEAR(a.Basis().Origin().CoordinateX(), b.Basis().Origin().CoordinateX(), 1e-12);
+	}
+}
+
+TEST_F(SimulationTest,Output) {
+	Simulation simulation(Packing(), Model(), options);
+	std::vector<std::uint64_t> frames;
+	simulation.Output([&frames](const Simulation& s){ frames.push_back(s.StepCount()); }, 4);
+	simulation.Run(10);
+	EXPECT_EQ(std::vector<std::uint64_t>({4, 8}), frames);
+	simulation.Output(nullptr, 4);
+	simulation.Run(10);
+	EXPECT_EQ(2u, frames.size());
+}
+
+TEST_F(SimulationTest,BudgetDefersWork) {
+	options.reorderPeriod = 5;
+	options.budget = 1e-9;
+	Simulation simulation(Packing(), Model(), options);
+	std::vector<std::uint64_t> frames;
+	simulation.Output([&frames](const Simulation& s){ frames.push_back(s.StepCount()); }, 4);
+	simulation.Run(20);
+	
+	// The first of each is measured, later ones wait as long as they may before being forced.
+	EXPECT_EQ(std::vector<std::uint64_t>({4, 11, 15, 19}), frames);
+	EXPECT_EQ(2u, simulation.Reorder().Reorders());
+	BudgetReport report = simulation.Budget().Report();
+	EXPECT_EQ(20u, report.steps);
+	EXPECT_EQ(20u, report.overruns);
+	EXPECT_EQ(10u, report[Degradation::DeferReorder]);
+	EXPECT_EQ(10u, report[Degradation::DeferOutput]);
+	EXPECT_TRUE(simulation.Budget().Applied(Degradation::DeferReorder));
+	// The frame due at step 20 is still waiting.
+	EXPECT_TRUE(simulation.Budget().Applied(Degradation::DeferOutput));
+	
+	// Deferring does not change the trajectories, only the order of the solids.
+	options.budget = 0;
+	Simulation plain(Packing(), Model(), options);
+	plain.Run(20);
+	for(std::uint32_t id = 0 ; id < plain.Solids().size() ; ++id){
+		const Solid& a = plain.Solids()[plain.Reorder().IndexOf(id)];
+		const Solid& b = simulation.Solids()[simulation.Reorder().IndexOf(id)];
+		EXPECT_NEAR(a.Basis().Origin().CoordinateX(), b.Basis().Origin().CoordinateX(), 1e-12);
+	}
+	EXPECT_EQ(0u, plain.Budget().Report().steps);
+}
+
+TEST_F(SimulationTest,BudgetKeepsFrames) {
+	// Over budget at every step, every frame still comes out before the next one is due.
+	options.budget = 1e-9;
+	Simulation simulation(Packing(), Model(), options);
+	std::vector<std::uint64_t> frames;
+	simulation.Output([&frames](const Simulation& s){ frames.push_back(s.StepCount()); }, 4);
+	simulation.Run(43);
+	ASSERT_EQ(10u, frames.size());
+	for(std::size_t i = 0 ; i < frames.size() ; ++i){
+		EXPECT_GE(frames[i], 4*(i + 1));
+		EXPECT_LT(frames[i], 4*(i + 2));
+	}
+	EXPECT_EQ(9*3u, simulation.Budget().Report()[Degradation::DeferOutput]);
+}
+
+TEST_F(SimulationTest,LargeBudget) {
+	options.reorderPeriod = 5;
+	options.budget = 10;
+	Simulation simulation(Packing(), Model(), options);
+	simulation.Run(20);
+	BudgetReport report = simulation.Budget().Report();
+	EXPECT_EQ(20u, report.steps);
+	EXPECT_EQ(0u, report.degraded);
+	EXPECT_EQ(0u, report.overruns);
+	EXPECT_EQ(4u, simulation.Reorder().Reorders());
+	std::stringstream text;
+	report.WriteText(text);
+	EXPECT_EQ(0u, text.str().find("budget 10000000.0 us: 20 steps, 0 degraded, 0 over budget\n"));
+}
+
+TEST_F(SimulationTest,SolidWithoutShape) {
+	std::vector<Solid> solids;
+	solids.emplace_back(std::unique_ptr<Shape>());
+	bool thrown = false;
+	try{
+		Simulation simulation(std::move(solids), Model(), options);
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
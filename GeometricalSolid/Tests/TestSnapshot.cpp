@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <Disk.h>
+#include <Rectangle.h>
+#include <SnapshotWriter.h>
+#include <SnapshotReader.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class SnapshotTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::string path;
+protected:
+	virtual void SetUp() {
+		path = "SnapshotTest.snap";
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<double> value(-1, 1);
+		for(int i = 0 ; i < 3000 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(i % 3 == 0 ? 0.02 : 0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+			q.Normalize();
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(value(generator), value(generator), value(generator)), q));
+			solids.back().Velocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().AngularVelocity(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().Force(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().Momentum(Vector<double>(value(generator), value(generator), value(generator)));
+			solids.back().LockTranslation(i % 2 == 0, false, i % 5 == 0);
+			solids.back().LockRotation(false, i % 7 == 0, false);
+		}
+	}
+	virtual void TearDown() {
+		std::remove(path.c_str());
+	}
+	
+	static void ExpectEqual(const Vector<double>& a, const Vector<double>& b) {
+		EXPECT_EQ(a.ComponantX(), b.ComponantX());
+		EXPECT_EQ(a.ComponantY(), b.ComponantY());
+		EXPECT_EQ(a.ComponantZ(), b.ComponantZ());
+	}
+	
+	static bool Rejected(const std::string& path) {
+		try{
+			SnapshotReader reader(path);
+		}
+		catch(const std::runtime_error&){
+			return true;
+		}
+		return false;
+	}
+};
+
+TEST_F(SnapshotTest,RoundTrip) {
+	SnapshotWriter writer;
+	writer.Write(path, solids, 42, 0.5);
+	
+	SnapshotReader reader(path);
+	EXPECT_EQ(solids.size(), reader.SolidCount());
+	EXPECT_EQ(2u, reader.ShapeCount());
+	EXPECT_EQ(42u, reader.Step());
+	EXPECT_EQ(0.5, reader.Time());
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(reader.Origins()) % Snapshot::alignment);
+	EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(reader.Momentums()) % Snapshot::alignment);
+	EXPECT_EQ(solids[7].Basis().Origin().CoordinateY(), reader.Origins()[3*7 + 1]);
+	EXPECT_EQ(solids[7].Basis().Orientation().ComponantK(), reader.Orientations()[4*7 + 3]);
+	
+	std::vector<Solid> loaded;
+	reader.Load(loaded);
+	ASSERT_EQ(solids.size(), loaded.size());
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		const Solid& a = solids[i];
+		const Solid& b = loaded[i];
+		EXPECT_EQ(static_cast<const Sphere*>(a.Shape())->Radius(), static_cast<const Sphere*>(b.Shape())->Radius());
+		EXPECT_EQ(a.Shape()->Mass(), b.Shape()->Mass());
+		EXPECT_EQ(a.Basis().Origin().CoordinateX(), b.Basis().Origin().CoordinateX());
+		EXPECT_EQ(a.Basis().Orientation().ComponantReal(), b.Basis().Orientation().ComponantReal());
+		ExpectEqual(a.Basis().AxisZ(), b.Basis().AxisZ());
+		ExpectEqual(a.Velocity(), b.Velocity());
+		ExpectEqual(a.AngularVelocity(), b.AngularVelocity());
+		ExpectEqual(a.Force(), b.Force());
+		ExpectEqual(a.Momentum(), b.Momentum());
+		EXPECT_EQ(a.IsXTranslationLocked(), b.IsXTranslationLocked());
+		EXPECT_EQ(a.IsZTranslationLocked(), b.IsZTranslationLocked());
+		EXPECT_EQ(a.IsYRotationLocked(), b.IsYRotationLocked());
+	}
+}
+
+TEST_F(SnapshotTest,Empty) {
+	std::vector<Solid> none;
+	SnapshotWriter writer;
+	writer.Write(path, none);
+	SnapshotReader reader(path);
+	EXPECT_EQ(0u, reader.SolidCount());
+	EXPECT_EQ(0u, reader.ShapeCount());
+	std::vector<Solid> loaded;
+	reader.Load(loaded);
+	EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(SnapshotTest,Invalid) {
+	EXPECT_TRUE(Rejected("SnapshotTest.missing"));
+	
+	{
+		std::ofstream out(path.c_str(), std::ios::binary);
+		out << std::string(512, 'x');
+	}
+	EXPECT_TRUE(Rejected(path));
+	
+	SnapshotWriter writer;
+	writer.Write(path, solids);
+	EXPECT_FALSE(Rejected(path));
+	{
+		// Truncated file.
+		std::ifstream in(path.c_str(), std::ios::binary);
+		std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+		out.write(content.data(), content.size() - 8);
+	}
+	EXPECT_TRUE(Rejected(path));
+}
+
+TEST_F(SnapshotTest,DisksAndRectangles) {
+	solids[1].Shape(std::unique_ptr<Shape>(new Disk(0.01, 0.002, 2400)));
+	solids[2].Shape(std::unique_ptr<Shape>(new Rectangle(0.01, 0.006, 0.002, 2600)));
+	SnapshotWriter().Write(path, solids);
+	
+	SnapshotReader reader(path);
+	EXPECT_EQ(4u, reader.ShapeCount());
+	std::unique_ptr<Shape> disk = reader.MakeShape(reader.ShapeIndices()[1]);
+	ASSERT_TRUE(Shape::Form::Disk == disk->Form());
+	EXPECT_EQ(0.002, static_cast<const Disk&>(*disk).Thickness());
+	EXPECT_EQ(2400, static_cast<const Disk&>(*disk).Density());
+	std::unique_ptr<Shape> rectangle = reader.MakeShape(reader.ShapeIndices()[2]);
+	ASSERT_TRUE(Shape::Form::Rectangle == rectangle->Form());
+	EXPECT_EQ(0.006, static_cast<const Rectangle&>(*rectangle).Width());
+	EXPECT_EQ(solids[2].Shape()->Mass(), rectangle->Mass());
+}
+
+TEST_F(SnapshotTest,Polydisperse) {
+	// Every other solid gets its own radius, shared ones are spread over the vector.
+	for(std::size_t i = 0 ; i < solids.size() ; i += 2)
+		solids[i].Shape(std::unique_ptr<Shape>(new Sphere(0.03 + 1e-6*i, 2500)));
+	SnapshotWriter writer;
+	writer.Write(path, solids);
+	writer.Write(path, solids);
+	
+	SnapshotReader reader(path);
+	EXPECT_EQ(solids.size()/2 + 2, reader.ShapeCount());
+	for(std::size_t i = 0 ; i < solids.size() ; ++i){
+		std::unique_ptr<Shape> shape = reader.MakeShape(reader.ShapeIndices()[i]);
+		EXPECT_EQ(static_cast<const Sphere*>(solids[i].Shape())->Radius(), static_cast<const Sphere&>(*shape).Radius());
+	}
+}
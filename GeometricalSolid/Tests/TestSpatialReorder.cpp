@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <condition_variable>
+#include <random>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <SpatialReorder.h>
+#include <ContactForceEngine.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class SpatialReorderTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+protected:
+	virtual void SetUp() {
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<double> position(-1, 1);
+		for(int i = 0 ; i < 1000 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(position(generator), position(generator), position(generator)), Quaternion<double>()));
+			// The velocity tags each solid with its original index.
+			solids.back().Velocity(Vector<double>(i, 0, 0));
+		}
+	}
+	virtual void TearDown() {}
+};
+
+TEST_F(SpatialReorderTest,MortonKey) {
+	EXPECT_EQ(0u, SpatialReorder::MortonKey(0, 0, 0));
+	EXPECT_EQ(1u, SpatialReorder::MortonKey(1, 0, 0));
+	EXPECT_EQ(2u, SpatialReorder::MortonKey(0, 1, 0));
+	EXPECT_EQ(4u, SpatialReorder::MortonKey(0, 0, 1));
+	EXPECT_EQ(7u*8u, SpatialReorder::MortonKey(2, 2, 2));
+	EXPECT_EQ(0x7fffffffffffffffULL, SpatialReorder::MortonKey(0x1fffff, 0x1fffff, 0x1fffff));
+}
+
+TEST_F(SpatialReorderTest,Reorder) {
+	SpatialReorder reorder(10);
+	EXPECT_FALSE(reorder.Update(solids, 3));
+	EXPECT_TRUE(reorder.Update(solids, 10));
+	EXPECT_EQ(1u, reorder.Reorders());
+	
+	double neighborDistance = 0;
+	for(std::uint32_t i = 0 ; i < solids.size() ; ++i){
+		std::uint32_t id = static_cast<std::uint32_t>(solids[i].Velocity().ComponantX());
+		EXPECT_EQ(id, reorder.IdOf(i));
+		EXPECT_EQ(i, reorder.IndexOf(id));
+		if(i > 0)
+			neighborDistance += (solids[i].Basis().Origin() - solids[i - 1].Basis().Origin()).Norme();
+	}
+	// Consecutive solids of a random cloud are about one unit apart before sorting.
+	EXPECT_LT(neighborDistance/solids.size(), 0.3);
+	
+	reorder.Reorder(solids);
+	for(std::uint32_t i = 0 ; i < solids.size() ; ++i){
+		EXPECT_EQ(i, reorder.Permutation()[i]);
+		EXPECT_EQ(static_cast<std::uint32_t>(solids[i].Velocity().ComponantX()), reorder.IdOf(i));
+	}
+}
+
+TEST_F(SpatialReorderTest,ContactHistorySurvivesReorder) {
+	solids[1].Basis(GeometricalSpaceObjects::Basis<double>(solids[0].Basis().Origin() + Vector<double>(0.019, 0, 0), Quaternion<double>()));
+	SpatialReorder reorder(1);
+	reorder.Update(solids, 1);
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 0.9, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Ids(&reorder.Ids());
+	
+	std::vector<ContactPair> pairs{{reorder.IndexOf(0), reorder.IndexOf(1)}};
+	engine.Apply(solids, pairs, 1e-5);
+	engine.History().Find(ContactHistory::Key(0, 1))->tangentialDisplacement[1] = 1e-9;
+	
+	solids[reorder.IndexOf(0)].Basis(solids[reorder.IndexOf(0)].Basis() + Vector<double>(5, 5, 5));
+	solids[reorder.IndexOf(1)].Basis(solids[reorder.IndexOf(1)].Basis() + Vector<double>(5, 5, 5));
+	reorder.Update(solids, 2);
+	pairs[0] = ContactPair{reorder.IndexOf(0), reorder.IndexOf(1)};
+	engine.Apply(solids, pairs, 0);
+	
+	ASSERT_EQ(1u, engine.ActiveContacts());
+	EXPECT_NEAR(1e-9, engine.History().Find(ContactHistory::Key(0, 1))->tangentialDisplacement[1], 1e-20);
+}
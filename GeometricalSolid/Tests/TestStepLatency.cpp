@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <StepLatency.h>
+#include <Simulation.h>
+#include <Sphere.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+TEST(LatencyHistogramTest,Buckets) {
+	for(std::uint64_t value : {0ull, 1ull, 127ull, 128ull, 1000ull, 123456789ull, 1ull << 40, ~0ull}){
+		std::uint64_t bucketValue = LatencyHistogram::Value(LatencyHistogram::Bucket(value));
+		EXPECT_NEAR(static_cast<double>(value), static_cast<double>(bucketValue), value/64.) << value;
+	}
+	EXPECT_EQ(LatencyHistogram::Bucket(1000) + 1, LatencyHistogram::Bucket(1008));
+}
+
+TEST(LatencyHistogramTest,Percentiles) {
+	LatencyHistogram histogram;
+	EXPECT_EQ(0u, histogram.Percentile(0.5));
+	for(std::uint64_t value = 1 ; value <= 10000 ; ++value)
+		histogram.Record(value);
+	EXPECT_EQ(10000u, histogram.Count());
+	EXPECT_EQ(10000u, histogram.Max());
+	EXPECT_DOUBLE_EQ(5000.5, histogram.Mean());
+	EXPECT_NEAR(5000, histogram.Percentile(0.5), 5000/64.);
+	EXPECT_NEAR(9900, histogram.Percentile(0.99), 9900/64.);
+	EXPECT_NEAR(9990, histogram.Percentile(0.999), 9990/64.);
+	EXPECT_EQ(10000u, histogram.Percentile(1));
+	
+	histogram.Reset();
+	EXPECT_EQ(0u, histogram.Count());
+	EXPECT_EQ(0u, histogram.Max());
+}
+
+TEST(StepLatencyTest,BlamesSlowPhase) {
+	StepLatency latency(0.01, 2);
+	for(std::uint64_t step = 0 ; step < 5 ; ++step){
+		latency.Begin();
+		latency.Mark(Phase::Forces);
+		if(step % 2 == 1)
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		latency.Mark(Phase::Contacts);
+		latency.Mark(Phase::Positions);
+		latency.End(step);
+	}
+	LatencySummary summary = latency.Summary();
+	EXPECT_EQ(5u, summary.steps);
+	EXPECT_EQ(2u, summary.overruns);
+	EXPECT_GE(summary.max, 0.02*0.98);
+	EXPECT_LT(summary.p50, 0.01);
+	EXPECT_EQ(5u, latency.Histogram(Phase::Contacts).Count());
+	
+	std::vector<StepOverrun> overruns = latency.Overruns();
+	ASSERT_EQ(2u, overruns.size());
+	EXPECT_EQ(1u, overruns[0].step);
+	EXPECT_EQ(3u, overruns[1].step);
+	for(const auto& overrun : overruns){
+		EXPECT_EQ(Phase::Contacts, overrun.phase);
+		EXPECT_GE(overrun.phaseSeconds, 0.02*0.98);
+		EXPECT_GE(overrun.seconds, overrun.phaseSeconds);
+	}
+	
+	std::stringstream text;
+	latency.WriteText(text);
+	EXPECT_NE(std::string::npos, text.str().find("2 of 5 steps over the 10000.0 us deadline"));
+	EXPECT_NE(std::string::npos, text.str().find("step 3: "));
+	
+	latency.Reset();
+	EXPECT_EQ(0u, latency.Summary().steps);
+	EXPECT_TRUE(latency.Overruns().empty());
+}
+
+TEST(StepLatencyTest,Simulation) {
+	std::vector<Solid> solids;
+	for(int i = 0 ; i < 8 ; ++i){
+		solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+		solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.012*i, 0.05, 0.05), Quaternion<double>(1, 0, 0, 0)));
+	}
+	SimulationOptions options;
+	options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(0.1, 0.1, 0.1));
+	options.deadline = 1e-9;
+	Simulation simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options);
+	
+	// Queried while the steps run.
+	std::atomic<bool> done(false);
+	std::uint64_t seen = 0;
+	std::thread reader([&]{
+		while(!done.load()){
+			LatencySummary summary = simulation.Latency().Summary();
+			EXPECT_GE(summary.steps, seen);
+			seen = summary.steps;
+			EXPECT_LE(summary.p50, summary.max);
+		}
+	});
+	simulation.Run(200);
+	done.store(true);
+	reader.join();
+	
+	LatencySummary summary = simulation.Latency().Summary();
+	EXPECT_EQ(200u, summary.steps);
+	EXPECT_EQ(200u, summary.overruns);
+	EXPECT_GT(summary.p50, 0);
+	EXPECT_LE(summary.p50, summary.p99);
+	EXPECT_LE(summary.p99, summary.p999);
+	EXPECT_LE(summary.p999, summary.max);
+	EXPECT_EQ(200u, simulation.Latency().Histogram(Phase::Contacts).Count());
+	EXPECT_EQ(64u, simulation.Latency().Overruns().size());
+	EXPECT_EQ(199u, simulation.Latency().Overruns().back().step);
+	
+	simulation.Latency().Deadline(0);
+	simulation.Run(10);
+	EXPECT_EQ(200u, simulation.Latency().OverrunCount());
+}
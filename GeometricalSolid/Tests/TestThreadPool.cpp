@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <ThreadPool.h>
+
+using namespace GeometricalSolid;
+
+TEST(ThreadPoolTest,ParallelFor) {
+	for(std::size_t threads = 1 ; threads <= 4 ; ++threads){
+		ThreadPool pool(threads);
+		EXPECT_EQ(threads, pool.Size());
+		for(std::size_t count : {0, 1, 3, 1000}){
+			std::vector<int> visits(count, 0);
+			std::atomic<std::size_t> maxThread(0);
+			pool.ParallelFor(count, [&](std::size_t begin, std::size_t end, std::size_t thread){
+				for(std::size_t i = begin ; i < end ; ++i)
+					++visits[i];
+				std::size_t seen = maxThread.load();
+				while(thread > seen && !maxThread.compare_exchange_weak(seen, thread));
+			});
+			for(auto visit : visits)
+				EXPECT_EQ(1, visit);
+			EXPECT_LT(maxThread.load(), threads);
+		}
+	}
+}
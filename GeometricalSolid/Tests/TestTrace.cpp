@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <Trace.h>
+#include <Profiler.h>
+#include <Simulation.h>
+#include <Sphere.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class TraceTest : public ::testing::Test {
+public:
+	std::string path;
+protected:
+	virtual void SetUp() {
+		path = "TraceTest.json";
+	}
+	virtual void TearDown() {
+		Trace::Stop();
+		std::remove(path.c_str());
+	}
+	
+	static std::unique_ptr<Simulation> Spheres(std::size_t threads) {
+		std::vector<Solid> solids;
+		for(int i = 0 ; i < 64 ; ++i){
+			solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.025*(i%4), 0.025*(i/4%4), 0.025*(i/16)), Quaternion<double>()));
+		}
+		SimulationOptions options;
+		options.domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(0.1, 0.1, 0.1));
+		options.threads = threads;
+		return std::unique_ptr<Simulation>(new Simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options));
+	}
+	
+	static std::size_t Count(const std::string& text, const std::string& pattern) {
+		std::size_t count = 0;
+		for(std::size_t at = text.find(pattern) ; at != std::string::npos ; at = text.find(pattern, at + 1))
+			++count;
+		return count;
+	}
+};
+
+#ifdef GEOMETRICALSOLID_PROFILING
+
+TEST_F(TraceTest,StepWindow) {
+	TraceOptions options;
+	options.firstStep = 3;
+	options.steps = 2;
+	Trace::Start(options);
+	std::unique_ptr<Simulation> simulation = Spheres(3);
+	simulation->Run(10);
+	EXPECT_FALSE(Trace::Capturing());
+	EXPECT_EQ(0u, Trace::Overwritten());
+	
+	std::stringstream out;
+	Trace::WriteChromeTrace(out);
+	std::string trace = out.str();
+	EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": ["));
+	// Six phases per step on the calling thread.
+	EXPECT_EQ(12u, Count(trace, "\"cat\": \"phase\""));
+	EXPECT_EQ(6u, Count(trace, "\"step\": 3}"));
+	EXPECT_EQ(6u, Count(trace, "\"step\": 4}"));
+	EXPECT_EQ(0u, Count(trace, "\"step\": 5"));
+	// Forces, velocities and positions run as one chunk on each of the three threads.
+	EXPECT_EQ(6u, Count(trace, "\"name\": \"Forces\", \"cat\": \"chunk\""));
+	EXPECT_EQ(6u, Count(trace, "\"name\": \"Velocities\", \"cat\": \"chunk\""));
+	EXPECT_GE(Count(trace, "\"chunk\": 2}"), 6u);
+	EXPECT_EQ(Count(trace, "\"ph\": \"X\""), Trace::Events());
+}
+
+TEST_F(TraceTest,RingOverwrites) {
+	TraceOptions options;
+	options.steps = 100;
+	options.capacity = 8;
+	Trace::Start(options);
+	std::unique_ptr<Simulation> simulation = Spheres(1);
+	simulation->Run(10);
+	EXPECT_EQ(8u, Trace::Events());
+	EXPECT_EQ(60u - 8u, Trace::Overwritten());
+	
+	std::stringstream out;
+	Trace::WriteChromeTrace(out);
+	// The newest events are kept.
+	EXPECT_EQ(2u, Count(out.str(), "\"step\": 8}"));
+	EXPECT_EQ(6u, Count(out.str(), "\"step\": 9}"));
+}
+
+TEST_F(TraceTest,File) {
+	Trace::Start();
+	Spheres(1)->Run(2);
+	Trace::WriteChromeTrace(path);
+	std::ifstream in(path.c_str());
+	std::string first;
+	std::getline(in, first);
+	EXPECT_EQ("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", first);
+	
+	bool thrown = false;
+	try{
+		Trace::WriteChromeTrace("missing-directory/trace.json");
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
+
+#endif
+
+TEST_F(TraceTest,NotStarted) {
+	Spheres(1)->Run(2);
+	EXPECT_FALSE(Trace::Capturing());
+}
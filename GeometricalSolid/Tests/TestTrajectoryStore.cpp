@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <TrajectoryStoreWriter.h>
+#include <TrajectoryStoreReader.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class TrajectoryStoreTest : public ::testing::Test {
+public:
+	std::string path;
+	std::vector<TrajectoryFrame> frames;
+	const std::size_t solidCount = 30;
+protected:
+	virtual void SetUp() {
+		path = "TrajectoryStoreTest.traj";
+		for(std::size_t f = 0 ; f < 23 ; ++f){
+			TrajectoryFrame frame;
+			frame.step = 10*f;
+			frame.time = 0.5*f;
+			for(int c = 0 ; c < TrajectoryStore::ColumnCount ; ++c){
+				TrajectoryStore::Column column = static_cast<TrajectoryStore::Column>(c);
+				std::vector<double>& values = TrajectoryStore::Values(frame, column);
+				for(std::size_t i = 0 ; i < solidCount*TrajectoryStore::ComponentCount(column) ; ++i)
+					values.push_back(Encoded(f, c, i));
+			}
+			frames.push_back(frame);
+		}
+	}
+	virtual void TearDown() {
+		std::remove(path.c_str());
+	}
+	
+	static double Encoded(std::size_t frame, int column, std::size_t index) {
+		return 1e6*frame + 1e4*column + index;
+	}
+	
+	void Write(const TrajectoryStoreOptions& options) {
+		TrajectoryStoreWriter writer(path, solidCount, options);
+		for(const auto& frame : frames)
+			writer.Append(frame);
+	}
+	
+	static bool Rejected(const std::string& path) {
+		try{
+			TrajectoryStoreReader reader(path);
+		}
+		catch(const std::runtime_error&){
+			return true;
+		}
+		return false;
+	}
+};
+
+TEST_F(TrajectoryStoreTest,RandomAccess) {
+	TrajectoryStoreOptions options;
+	options.framesPerChunk = 4;
+	options.solidsPerChunk = 7;
+	Write(options);
+	
+	TrajectoryStoreReader reader(path);
+	ASSERT_EQ(frames.size(), reader.FrameCount());
+	EXPECT_EQ(solidCount, reader.SolidCount());
+	EXPECT_EQ(220u, reader.Step(22));
+	EXPECT_EQ(11., reader.Time(22));
+	
+	for(std::size_t f = 0 ; f < frames.size() ; ++f)
+		for(std::size_t s = 0 ; s < solidCount ; ++s){
+			const double* orientation = reader.Value(TrajectoryStore::Orientation, f, s);
+			for(std::size_t k = 0 ; k < 4 ; ++k)
+				ASSERT_EQ(Encoded(f, TrajectoryStore::Orientation, 4*s + k), orientation[k]);
+			ASSERT_EQ(Encoded(f, TrajectoryStore::Momentum, 3*s + 2), reader.Value(TrajectoryStore::Momentum, f, s)[2]);
+		}
+	
+	std::vector<double> series(3*18);
+	reader.Series(TrajectoryStore::Origin, 29, 3, 18, series.data());
+	for(std::size_t f = 0 ; f < 18 ; ++f)
+		for(std::size_t k = 0 ; k < 3 ; ++k)
+			EXPECT_EQ(Encoded(f + 3, TrajectoryStore::Origin, 3*29 + k), series[3*f + k]);
+	
+	TrajectoryFrame frame;
+	reader.Read(21, frame);
+	EXPECT_EQ(frames[21].step, frame.step);
+	EXPECT_EQ(frames[21].origins, frame.origins);
+	EXPECT_EQ(frames[21].orientations, frame.orientations);
+	EXPECT_EQ(frames[21].angularVelocities, frame.angularVelocities);
+	EXPECT_EQ(frames[21].momentums, frame.momentums);
+}
+
+TEST_F(TrajectoryStoreTest,ColumnMask) {
+	TrajectoryStoreOptions options;
+	options.columnMask = 1 << TrajectoryStore::Origin | 1 << TrajectoryStore::Orientation;
+	Write(options);
+	
+	TrajectoryStoreReader reader(path);
+	EXPECT_TRUE(reader.HasColumn(TrajectoryStore::Origin));
+	EXPECT_FALSE(reader.HasColumn(TrajectoryStore::Velocity));
+	TrajectoryFrame frame;
+	reader.Read(5, frame);
+	EXPECT_EQ(frames[5].origins, frame.origins);
+	EXPECT_TRUE(frame.velocities.empty());
+	
+	bool thrown = false;
+	try{
+		reader.Value(TrajectoryStore::Force, 0, 0);
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
+
+TEST_F(TrajectoryStoreTest,CapturesSolids) {
+	std::vector<Solid> solids;
+	for(int i = 0 ; i < 5 ; ++i){
+		solids.emplace_back(std::unique_ptr<Shape>(new Sphere(0.01, 2500)));
+		solids.back().Velocity(Vector<double>(i, 0, 0));
+	}
+	{
+		TrajectoryStoreWriter writer(path, solids.size());
+		for(int step = 0 ; step < 3 ; ++step){
+			writer.Append(solids, step, step*0.1);
+			for(auto& solid : solids)
+				solid.UpdatePosition(1);
+		}
+	}
+	TrajectoryStoreReader reader(path);
+	EXPECT_EQ(3u, reader.FrameCount());
+	EXPECT_EQ(8., reader.Value(TrajectoryStore::Origin, 2, 4)[0]);
+	EXPECT_EQ(4., reader.Value(TrajectoryStore::Velocity, 2, 4)[0]);
+}
+
+TEST_F(TrajectoryStoreTest,Rejects) {
+	{
+		TrajectoryStoreWriter writer(path, solidCount + 1);
+		bool thrown = false;
+		try{
+			writer.Append(frames[0]);
+		}
+		catch(const std::runtime_error&){
+			thrown = true;
+		}
+		EXPECT_TRUE(thrown);
+	}
+	
+	Write(TrajectoryStoreOptions());
+	std::FILE* file = std::fopen(path.c_str(), "r+b");
+	std::fseek(file, -1, SEEK_END);
+	std::fputc('x', file);
+	std::fclose(file);
+	EXPECT_TRUE(Rejected(path));
+	EXPECT_TRUE(Rejected("TrajectoryStoreTest.missing"));
+}
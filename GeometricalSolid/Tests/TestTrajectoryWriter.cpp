@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <SolidFormatter.h>
+#include <TrajectoryWriter.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+namespace {
+	// Holds the writer thread inside Encode until released.
+	class GatedEncoder: public FrameEncoder{
+	public:
+		GatedEncoder(std::atomic<bool>& open, std::atomic<int>& entered):open(open), entered(entered) {}
+		virtual void Encode(const TrajectoryFrame& frame, std::string& bytes) {
+			++this->entered;
+			while(!this->open)
+				std::this_thread::yield();
+			bytes.append(std::to_string(frame.step) + "\n");
+		}
+	private:
+		std::atomic<bool>& open;
+		std::atomic<int>& entered;
+	};
+	
+	class FailingEncoder: public FrameEncoder{
+	public:
+		virtual void Encode(const TrajectoryFrame&, std::string&) {
+			throw(std::runtime_error("encoder failure"));
+		}
+	};
+}
+
+class TrajectoryWriterTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+protected:
+	virtual void SetUp() {
+		for(int i = 0 ; i < 50 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1*i, -0.2*i, 1./(i + 1)), Quaternion<double>()));
+			solids.back().Velocity(Vector<double>(i, 0, 0));
+			solids.back().Force(Vector<double>(0, 0, -9.81*i));
+			solids.back().Momentum(Vector<double>(1e-7*i, 0, 3));
+		}
+	}
+	virtual void TearDown() {}
+};
+
+TEST_F(TrajectoryWriterTest,LuGaEncoder) {
+	LuGaSolidFormatter formatter;
+	std::string expected;
+	for(const auto& solid : solids)
+		expected += formatter.Format(solid) + "\n";
+	
+	TrajectoryFrame frame;
+	frame.Capture(solids, 0, 0);
+	std::string encoded;
+	LuGaFrameEncoder().Encode(frame, encoded);
+	EXPECT_EQ(expected, encoded);
+}
+
+TEST_F(TrajectoryWriterTest,FormatAll) {
+	LuGaSolidFormatter formatter;
+	std::string expected = "header\n";
+	for(const auto& solid : solids)
+		expected += formatter.Format(solid) + "\n";
+	
+	std::string text = "header\n";
+	formatter.FormatAll(solids.data(), solids.size(), text);
+	EXPECT_EQ(expected, text);
+	
+	// Shortest digits read back to the same values.
+	text.clear();
+	LuGaSolidFormatter(NumberFormatter::shortest).FormatAll(solids.data(), solids.size(), text);
+	EXPECT_LT(text.size(), expected.size());
+	std::stringstream sstr(text);
+	for(const auto& solid : solids){
+		double x, y, z;
+		sstr >> x >> y >> z;
+		EXPECT_EQ(solid.Basis().Origin().CoordinateX(), x);
+		EXPECT_EQ(solid.Basis().Origin().CoordinateY(), y);
+		EXPECT_EQ(solid.Basis().Origin().CoordinateZ(), z);
+		for(int k = 0 ; k < 4 + 3 ; ++k)
+			sstr >> x;
+		sstr >> x >> y >> z;
+		EXPECT_EQ(solid.Momentum().ComponantX(), x);
+		EXPECT_EQ(solid.Momentum().ComponantZ(), z);
+	}
+}
+
+TEST_F(TrajectoryWriterTest,WritesInOrder) {
+	std::stringstream out;
+	{
+		TrajectoryWriterOptions options;
+		options.buffers = 3;
+		TrajectoryWriter writer(out, std::unique_ptr<FrameEncoder>(new BinaryFrameEncoder()), options);
+		for(std::uint64_t step = 0 ; step < 20 ; ++step){
+			solids[3].Velocity(Vector<double>(step, 0, 0));
+			EXPECT_TRUE(writer.Capture(solids, step, 0.1*step));
+		}
+		writer.Flush();
+		TrajectoryWriterStatistics statistics = writer.Statistics();
+		EXPECT_EQ(20u, statistics.captured);
+		EXPECT_EQ(20u, statistics.written);
+		EXPECT_EQ(0u, statistics.dropped);
+		EXPECT_EQ(out.str().size(), statistics.bytes);
+	}
+	
+	std::string bytes = out.str();
+	std::size_t frameSize = 3*sizeof(std::uint64_t) + 19*sizeof(double)*solids.size();
+	ASSERT_EQ(20*frameSize, bytes.size());
+	for(std::uint64_t step = 0 ; step < 20 ; ++step){
+		const char* frame = bytes.data() + step*frameSize;
+		std::uint64_t storedStep, count;
+		double time, velocity;
+		std::memcpy(&storedStep, frame, sizeof(storedStep));
+		std::memcpy(&time, frame + 8, sizeof(time));
+		std::memcpy(&count, frame + 16, sizeof(count));
+		// Velocities follow the origins and orientations.
+		std::memcpy(&velocity, frame + 24 + 7*sizeof(double)*solids.size() + 3*3*sizeof(double), sizeof(velocity));
+		EXPECT_EQ(step, storedStep);
+		EXPECT_EQ(0.1*step, time);
+		EXPECT_EQ(solids.size(), count);
+		EXPECT_EQ(step, velocity);
+	}
+}
+
+TEST_F(TrajectoryWriterTest,DropBackpressure) {
+	std::stringstream out;
+	std::atomic<bool> open(false);
+	std::atomic<int> entered(0);
+	TrajectoryWriterOptions options;
+	options.buffers = 1;
+	options.backpressure = TrajectoryWriterOptions::Backpressure::Drop;
+	TrajectoryWriter writer(out, std::unique_ptr<FrameEncoder>(new GatedEncoder(open, entered)), options);
+	
+	EXPECT_TRUE(writer.Capture(solids, 1, 0));
+	while(entered == 0)
+		std::this_thread::yield();
+	EXPECT_FALSE(writer.Capture(solids, 2, 0));
+	open = true;
+	writer.Flush();
+	EXPECT_TRUE(writer.Capture(solids, 3, 0));
+	writer.Flush();
+	
+	EXPECT_EQ("1\n3\n", out.str());
+	EXPECT_EQ(2u, writer.Statistics().written);
+	EXPECT_EQ(1u, writer.Statistics().dropped);
+}
+
+TEST_F(TrajectoryWriterTest,BlockBackpressure) {
+	std::stringstream out;
+	std::atomic<bool> open(false);
+	std::atomic<int> entered(0);
+	TrajectoryWriterOptions options;
+	options.buffers = 1;
+	TrajectoryWriter writer(out, std::unique_ptr<FrameEncoder>(new GatedEncoder(open, entered)), options);
+	
+	EXPECT_TRUE(writer.Capture(solids, 1, 0));
+	while(entered == 0)
+		std::this_thread::yield();
+	std::thread release([&open]{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		open = true;
+	});
+	EXPECT_TRUE(writer.Capture(solids, 2, 0));
+	release.join();
+	writer.Flush();
+	
+	EXPECT_EQ("1\n2\n", out.str());
+	EXPECT_GT(writer.Statistics().stallSeconds, 0.);
+}
+
+TEST_F(TrajectoryWriterTest,EncoderError) {
+	std::stringstream out;
+	TrajectoryWriter writer(out, std::unique_ptr<FrameEncoder>(new FailingEncoder()));
+	writer.Capture(solids, 1, 0);
+	bool thrown = false;
+	try{
+		writer.Flush();
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <condition_variable>
+#include <random>
+#include <set>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <VerletList.h>
+#include <ContactForceEngine.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class VerletListTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	double radius{0.01};
+	double skin{0.004};
+protected:
+	virtual void SetUp() {
+		std::mt19937 generator(42);
+		std::uniform_real_distribution<double> position(0, 0.2);
+		for(int i = 0 ; i < 500 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(radius, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(position(generator), position(generator), position(generator)), Quaternion<double>()));
+		}
+	}
+	virtual void TearDown() {}
+	
+	std::set<std::pair<std::uint32_t, std::uint32_t>> BruteForce(double cutoff) {
+		std::set<std::pair<std::uint32_t, std::uint32_t>> pairs;
+		for(std::uint32_t i = 0 ; i < solids.size() ; ++i)
+			for(std::uint32_t j = i + 1 ; j < solids.size() ; ++j)
+				if((solids[j].Basis().Origin() - solids[i].Basis().Origin()).Norme() < cutoff)
+					pairs.insert(std::make_pair(i, j));
+		return pairs;
+	}
+};
+
+TEST_F(VerletListTest,Build) {
+	VerletList list(skin);
+	list.Build(solids);
+	
+	std::set<std::pair<std::uint32_t, std::uint32_t>> pairs;
+	for(std::uint32_t i = 0 ; i < list.SolidCount() ; ++i){
+		for(const std::uint32_t* j = list.Begin(i) ; j != list.End(i) ; ++j){
+			EXPECT_GT(*j, i);
+			pairs.insert(std::make_pair(i, *j));
+		}
+	}
+	EXPECT_EQ(list.PairCount(), pairs.size());
+	EXPECT_TRUE(BruteForce(2*radius + skin) == pairs);
+}
+
+TEST_F(VerletListTest,DisplacementTriggeredRebuild) {
+	VerletList list(skin);
+	EXPECT_TRUE(list.Update(solids));
+	EXPECT_FALSE(list.Update(solids));
+	
+	solids[3].Basis(solids[3].Basis() + Vector<double>(0.4*skin, 0, 0));
+	EXPECT_FALSE(list.Update(solids));
+	EXPECT_NEAR(0.4*skin, list.Statistics().maxDisplacement, 1e-15);
+	
+	solids[7].Basis(solids[7].Basis() + Vector<double>(0, 0.7*skin, 0));
+	EXPECT_TRUE(list.Update(solids));
+	
+	auto statistics = list.Statistics();
+	EXPECT_EQ(4u, statistics.updates);
+	EXPECT_EQ(2u, statistics.builds);
+	EXPECT_MPREAL_EQ(2., statistics.stepsPerBuild);
+}
+
+TEST_F(VerletListTest,ContactEngine) {
+	VerletList list(skin);
+	list.Build(solids);
+	std::vector<ContactPair> pairs;
+	for(auto& pair : BruteForce(2*radius))
+		pairs.push_back(ContactPair{pair.first, pair.second});
+	
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 0.9, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Apply(solids, pairs, 1e-5);
+	std::vector<Vector<double>> expected;
+	for(auto& solid : solids){
+		expected.push_back(solid.Force());
+		solid.ResetForceAndMomemtum();
+	}
+	
+	std::unique_ptr<ContactForceModel> model2(new LinearSpringDashpotModel(1e5, 2e4, 0.9, 0.5));
+	ContactForceEngine engine2(std::move(model2));
+	engine2.Apply(solids, list, 1e-5);
+	EXPECT_EQ(pairs.size(), engine2.ActiveContacts());
+	for(std::size_t i = 0 ; i < solids.size() ; ++i)
+		EXPECT_TRUE(expected[i] == solids[i].Force());
+}
+
+TEST_F(VerletListTest,PeriodicDomain) {
+	PeriodicBox<double> domain(Point<double>(0, 0, 0), Point<double>(0.2, 0.2, 0.2), true, true, false);
+	for(auto& solid : solids)
+		solid.Basis(GeometricalSpaceObjects::Basis<double>(domain.Wrapped(solid.Basis().Origin()), Quaternion<double>()));
+	
+	VerletList list(skin);
+	list.Domain(domain);
+	list.Build(solids);
+	
+	std::set<std::pair<std::uint32_t, std::uint32_t>> pairs, expected;
+	for(std::uint32_t i = 0 ; i < list.SolidCount() ; ++i)
+		for(const std::uint32_t* j = list.Begin(i) ; j != list.End(i) ; ++j)
+			pairs.insert(std::make_pair(i, *j));
+	for(std::uint32_t i = 0 ; i < solids.size() ; ++i)
+		for(std::uint32_t j = i + 1 ; j < solids.size() ; ++j)
+			if(domain.Displacement(solids[j].Basis().Origin(), solids[i].Basis().Origin()).Norme() < 2*radius + skin)
+				expected.insert(std::make_pair(i, j));
+	EXPECT_EQ(list.PairCount(), pairs.size());
+	EXPECT_TRUE(expected == pairs);
+	EXPECT_GT(pairs.size(), BruteForce(2*radius + skin).size());
+	
+	// Crossing the boundary is a small displacement, not a jump across the box.
+	solids[0].Velocity(Vector<double>(1, 0, 0));
+	solids[0].Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1999, 0.1, 0.1), Quaternion<double>()));
+	list.Build(solids);
+	solids[0].UpdatePosition(0.0002, domain);
+	EXPECT_NEAR(0.0001, solids[0].Basis().Origin().CoordinateX(), 1e-12);
+	EXPECT_FALSE(list.Update(solids));
+	EXPECT_NEAR(0.0002, list.Statistics().maxDisplacement, 1e-12);
+}
+
+TEST_F(VerletListTest,PeriodicContact) {
+	PeriodicBox<double> domain(Point<double>(0, 0, 0), Point<double>(1, 1, 1));
+	std::vector<Solid> pair;
+	for(int i = 0 ; i < 2 ; ++i){
+		std::unique_ptr<Shape> shape(new Sphere(radius, 2500));
+		pair.emplace_back(std::move(shape));
+	}
+	pair[0].Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.005, 0.5, 0.5), Quaternion<double>()));
+	pair[1].Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.986, 0.5, 0.5), Quaternion<double>()));
+	
+	VerletList list(skin);
+	list.Domain(domain);
+	list.Build(pair);
+	ASSERT_EQ(1u, list.PairCount());
+	
+	std::unique_ptr<ContactForceModel> model(new LinearSpringDashpotModel(1e5, 2e4, 1, 0.5));
+	ContactForceEngine engine(std::move(model));
+	engine.Domain(domain);
+	engine.Apply(pair, list, 1e-5);
+	EXPECT_NEAR(1e5*0.001, pair[0].Force().ComponantX(), 1e-6);
+	EXPECT_NEAR(-1e5*0.001, pair[1].Force().ComponantX(), 1e-6);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "Precision.h"
+#include <Solid.h>
+#include <Sphere.h>
+#include <VtkWriter.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+class VtkWriterTest : public ::testing::Test {
+public:
+	std::vector<Solid> solids;
+	std::string prefix;
+protected:
+	virtual void SetUp() {
+		prefix = "VtkWriterTest";
+		for(int i = 0 ; i < 40 ; ++i){
+			std::unique_ptr<Shape> shape(new Sphere(i%3 == 2 ? 0.02 : 0.01, 2500));
+			solids.emplace_back(std::move(shape));
+			solids.back().Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(0.1*i, -0.2*i, 1./(i + 1)), Quaternion<double>(0.5, 0.5, 0.5, 0.5)));
+			solids.back().Velocity(Vector<double>(i, 0, -1));
+			solids.back().AngularVelocity(Vector<double>(0, 2*i, 0));
+		}
+		solids.emplace_back(std::unique_ptr<Shape>());
+	}
+	virtual void TearDown() {
+		for(std::uint64_t step = 0 ; step < 10 ; ++step)
+			std::remove(File(step).c_str());
+		std::remove((prefix + ".pvd").c_str());
+	}
+
+	std::string File(std::uint64_t step) const {
+		char name[32];
+		std::snprintf(name, sizeof(name), "_%08llu.vtp", static_cast<unsigned long long>(step));
+		return prefix + name;
+	}
+
+	static std::string Read(const std::string& path) {
+		std::ifstream in(path.c_str(), std::ios::binary);
+		std::stringstream sstr;
+		sstr << in.rdbuf();
+		return sstr.str();
+	}
+
+	// Start of the appended block of the named array, past its byte count.
+	static const char* Appended(const std::string& file, const std::string& name, std::uint64_t& bytes) {
+		std::size_t at = file.find("Name=\"" + name + "\"");
+		std::size_t offset = std::stoull(file.substr(file.find("offset=\"", at) + 8));
+		const char* block = file.data() + file.find("encoding=\"raw\">") + std::strlen("encoding=\"raw\">\n   _") + offset;
+		std::memcpy(&bytes, block, sizeof(bytes));
+		return block + sizeof(bytes);
+	}
+
+	template<class T>
+	static T BigEndian(const char* bytes) {
+		char copy[sizeof(T)];
+		std::reverse_copy(bytes, bytes + sizeof(T), copy);
+		T value;
+		std::memcpy(&value, copy, sizeof(T));
+		return value;
+	}
+};
+
+TEST_F(VtkWriterTest,XmlAppended) {
+	std::stringstream out;
+	VtkWriter().Write(out, solids, 12, 0.25);
+	std::string file = out.str();
+	EXPECT_NE(std::string::npos, file.find("NumberOfPoints=\"41\" NumberOfVerts=\"41\""));
+	EXPECT_NE(std::string::npos, file.find(">0.25</DataArray>"));
+	EXPECT_EQ("</VTKFile>\n", file.substr(file.size() - 11));
+
+	std::uint64_t bytes;
+	const char* points = Appended(file, "Points", bytes);
+	ASSERT_EQ(3*41*sizeof(double), bytes);
+	for(std::size_t i = 0 ; i < 40 ; ++i){
+		double origin[3];
+		std::memcpy(origin, points + 3*sizeof(double)*i, sizeof(origin));
+		EXPECT_EQ(solids[i].Basis().Origin().CoordinateX(), origin[0]);
+		EXPECT_EQ(solids[i].Basis().Origin().CoordinateY(), origin[1]);
+		EXPECT_EQ(solids[i].Basis().Origin().CoordinateZ(), origin[2]);
+	}
+
+	const char* orientations = Appended(file, "Orientation", bytes);
+	ASSERT_EQ(4*41*sizeof(double), bytes);
+	double q[4];
+	std::memcpy(q, orientations + 4*sizeof(double)*7, sizeof(q));
+	EXPECT_EQ(solids[7].Basis().Orientation().ComponantJ(), q[2]);
+
+	const char* ids = Appended(file, "ShapeId", bytes);
+	ASSERT_EQ(41*sizeof(std::int32_t), bytes);
+	std::int32_t id[6];
+	std::memcpy(id, ids, sizeof(id));
+	EXPECT_EQ(0, id[0]);
+	EXPECT_EQ(0, id[1]);
+	EXPECT_EQ(1, id[2]);
+	EXPECT_EQ(0, id[3]);
+	std::memcpy(id, ids + 40*sizeof(std::int32_t), sizeof(std::int32_t));
+	EXPECT_EQ(-1, id[0]);
+
+	const char* offsets = Appended(file, "offsets", bytes);
+	std::int64_t last;
+	std::memcpy(&last, offsets + 40*sizeof(std::int64_t), sizeof(last));
+	EXPECT_EQ(41, last);
+}
+
+TEST_F(VtkWriterTest,SmallBuffer) {
+	// Arrays go through the buffer in many pieces.
+	std::stringstream large, small;
+	VtkWriter().Write(large, solids);
+	VtkWriterOptions options;
+	options.bufferSize = 100;
+	VtkWriter(options).Write(small, solids);
+	EXPECT_EQ(large.str(), small.str());
+}
+
+TEST_F(VtkWriterTest,Legacy) {
+	VtkWriterOptions options;
+	options.format = VtkWriterOptions::Format::Legacy;
+	std::stringstream out;
+	VtkWriter(options).Write(out, solids, 3, 1.5);
+	std::string file = out.str();
+	EXPECT_EQ(0u, file.find("# vtk DataFile Version 3.0\nLuGa step 3 time 1.5\nBINARY\nDATASET POLYDATA\nPOINTS 41 double\n"));
+
+	const char* points = file.data() + file.find("double\n") + 7;
+	EXPECT_EQ(solids[5].Basis().Origin().CoordinateY(), BigEndian<double>(points + (3*5 + 1)*sizeof(double)));
+
+	std::size_t vertices = file.find("VERTICES 41 82\n");
+	ASSERT_NE(std::string::npos, vertices);
+	const char* cells = file.data() + vertices + 15;
+	EXPECT_EQ(1, BigEndian<std::int32_t>(cells + 8*9));
+	EXPECT_EQ(9, BigEndian<std::int32_t>(cells + 8*9 + 4));
+
+	const char* velocities = file.data() + file.find("VECTORS Velocity double\n") + 24;
+	EXPECT_EQ(6, BigEndian<double>(velocities + 3*6*sizeof(double)));
+
+	const char* radii = file.data() + file.find("Radius 1 41 double\n") + 19;
+	EXPECT_EQ(0.02, BigEndian<double>(radii + 2*sizeof(double)));
+	EXPECT_EQ(0, BigEndian<double>(radii + 40*sizeof(double)));
+}
+
+TEST_F(VtkWriterTest,FrameMatchesSolids) {
+	VtkShapeTable shapes;
+	VtkFrame frame;
+	frame.Capture(solids, shapes, 4, 0.5);
+	EXPECT_EQ(2u, shapes.Size());
+
+	for(auto format : {VtkWriterOptions::Format::Xml, VtkWriterOptions::Format::Legacy}){
+		VtkWriterOptions options;
+		options.format = format;
+		std::stringstream direct, captured;
+		VtkWriter(options).Write(direct, solids, 4, 0.5);
+		VtkWriter(options).Write(captured, frame);
+		EXPECT_EQ(direct.str(), captured.str());
+	}
+}
+
+TEST_F(VtkWriterTest,Series) {
+	VtkSeriesOptions options;
+	options.threads = 3;
+	options.buffers = 2;
+	{
+		VtkSeriesWriter writer(prefix, options);
+		for(std::uint64_t step = 0 ; step < 10 ; ++step){
+			solids[0].Velocity(Vector<double>(step, 0, 0));
+			writer.Capture(solids, step, 0.1*step);
+		}
+		writer.Flush();
+		EXPECT_EQ(10u, writer.Written());
+	}
+
+	std::string collection = Read(prefix + ".pvd");
+	std::size_t previous = 0;
+	for(std::uint64_t step = 0 ; step < 10 ; ++step){
+		std::size_t at = collection.find("file=\"" + File(step) + "\"");
+		ASSERT_NE(std::string::npos, at);
+		EXPECT_GT(at, previous);
+		previous = at;
+
+		std::uint64_t bytes;
+		std::string file = Read(File(step));
+		double velocity;
+		std::memcpy(&velocity, Appended(file, "Velocity", bytes), sizeof(velocity));
+		EXPECT_EQ(step, velocity);
+	}
+	solids[0].Velocity(Vector<double>(9, 0, 0));
+	std::stringstream direct;
+	VtkWriter().Write(direct, solids, 9, 0.1*9);
+	EXPECT_EQ(direct.str(), Read(File(9)));
+}
+
+TEST_F(VtkWriterTest,SeriesError) {
+	VtkSeriesWriter writer("missing-directory/frame");
+	writer.Capture(solids, 1, 0);
+	bool thrown = false;
+	try{
+		writer.Flush();
+	}
+	catch(const std::runtime_error&){
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+}
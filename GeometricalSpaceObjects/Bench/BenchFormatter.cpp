@@ -0,0 +1,88 @@
+#include <Benchmark.h>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <Vector.h>
+#include <Formatter/NumberFormatter.h>
+
+using namespace GeometricalSpaceObjects;
+
+namespace {
+
+	const std::size_t vectorCount = 100000;
+
+	const std::vector<Vector<double>>& SharedVectors() {
+		static std::vector<Vector<double>> vectors;
+		if(vectors.empty()){
+			std::mt19937 generator(1);
+			std::uniform_real_distribution<double> value(-100, 100);
+			for(std::size_t i = 0 ; i < vectorCount ; ++i)
+				vectors.push_back(Vector<double>(value(generator), value(generator), value(generator)));
+		}
+		return vectors;
+	}
+
+}
+
+// What every LuGa formatter did before: one stringstream per record.
+BENCHMARK(Formatter, VectorStream) {
+	const auto& vectors = SharedVectors();
+	std::size_t bytes = 0;
+	while(state.KeepRunning()){
+		bytes = 0;
+		for(const auto& vector : vectors){
+			std::stringstream sstr;
+			sstr.precision(15);
+			sstr << std::scientific << vector.ComponantX() << "\t" << vector.ComponantY() << "\t" << vector.ComponantZ();
+			bytes += sstr.str().size() + 1;
+		}
+	}
+	state.SetItemsProcessed(vectorCount);
+	state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(Formatter, VectorBuffer) {
+	const auto& vectors = SharedVectors();
+	LuGaVectorFormatter<double> formatter;
+	std::string text;
+	while(state.KeepRunning()){
+		text.clear();
+		for(const auto& vector : vectors){
+			formatter.Format(vector, text);
+			text += '\n';
+		}
+	}
+	state.SetItemsProcessed(vectorCount);
+	state.SetBytesProcessed(text.size());
+}
+
+BENCHMARK(Formatter, VectorShortest) {
+	const auto& vectors = SharedVectors();
+	LuGaVectorFormatter<double> formatter(NumberFormatter::shortest);
+	std::string text;
+	while(state.KeepRunning()){
+		text.clear();
+		for(const auto& vector : vectors){
+			formatter.Format(vector, text);
+			text += '\n';
+		}
+	}
+	state.SetItemsProcessed(vectorCount);
+	state.SetBytesProcessed(text.size());
+}
+
+// The usual way to get round-trip text with printf.
+BENCHMARK(Formatter, VectorPrintf17) {
+	const auto& vectors = SharedVectors();
+	std::string text;
+	char line[96];
+	while(state.KeepRunning()){
+		text.clear();
+		for(const auto& vector : vectors){
+			int length = std::snprintf(line, sizeof(line), "%.17g\t%.17g\t%.17g\n", vector.ComponantX(), vector.ComponantY(), vector.ComponantZ());
+			text.append(line, length);
+		}
+	}
+	state.SetItemsProcessed(vectorCount);
+	state.SetBytesProcessed(text.size());
+}
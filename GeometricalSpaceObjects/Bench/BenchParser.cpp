@@ -0,0 +1,154 @@
+#include <Benchmark.h>
+#include <random>
+#include <sstream>
+#include <Basis.h>
+#include <Vector.h>
+
+using namespace GeometricalSpaceObjects;
+
+namespace {
+
+	const std::size_t recordCount = 100000;
+
+	// LuGa text of random vectors, one per line, and of random bases, two lines each.
+	struct Texts{
+		std::vector<std::string> vectorLines;
+		std::string vectors;
+		std::vector<std::string> basisRecords;
+		std::string bases;
+
+		Texts() {
+			std::mt19937 generator(1);
+			std::uniform_real_distribution<double> value(-100, 100);
+			LuGaVectorFormatter<double> vectorFormatter;
+			LuGaBasisFormatter<double> basisFormatter;
+			for(std::size_t i = 0 ; i < recordCount ; ++i){
+				vectorLines.push_back(vectorFormatter.Format(Vector<double>(value(generator), value(generator), value(generator))));
+				vectors += vectorLines.back() + "\n";
+				Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+				q.Normalize();
+				basisRecords.push_back(basisFormatter.Format(Basis<double>(Point<double>(value(generator), value(generator), value(generator)), q)));
+				bases += basisRecords.back() + "\n";
+			}
+		}
+	};
+
+	const Texts& SharedTexts() {
+		static Texts texts;
+		return texts;
+	}
+
+}
+
+// What every LuGa parser did before: one stringstream per record.
+BENCHMARK(Parser, VectorStream) {
+	const Texts& texts = SharedTexts();
+	double sum = 0;
+	while(state.KeepRunning()){
+		for(const auto& line : texts.vectorLines){
+			std::stringstream sstr(line);
+			double x = 0, y = 0, z = 0;
+			sstr >> x >> y >> z;
+			sum += x + y + z;
+		}
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(recordCount);
+	state.SetBytesProcessed(texts.vectors.size());
+}
+
+BENCHMARK(Parser, VectorString) {
+	const Texts& texts = SharedTexts();
+	LuGaVectorParser<double> parser;
+	double sum = 0;
+	while(state.KeepRunning()){
+		for(const auto& line : texts.vectorLines)
+			sum += parser.Parse(line).ComponantX();
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(recordCount);
+	state.SetBytesProcessed(texts.vectors.size());
+}
+
+BENCHMARK(Parser, VectorBuffer) {
+	const Texts& texts = SharedTexts();
+	LuGaVectorParser<double> parser;
+	Vector<double> vector;
+	double sum = 0;
+	while(state.KeepRunning()){
+		const char* first = texts.vectors.data();
+		const char* last = first + texts.vectors.size();
+		while(parser.Parse(first, last, vector))
+			sum += vector.ComponantX();
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(recordCount);
+	state.SetBytesProcessed(texts.vectors.size());
+}
+
+BENCHMARK(Parser, BasisStream) {
+	const Texts& texts = SharedTexts();
+	double sum = 0;
+	while(state.KeepRunning()){
+		for(const auto& record : texts.basisRecords){
+			std::stringstream sstr(record);
+			double x = 0, y = 0, z = 0, real = 0, i = 0, j = 0, k = 0;
+			sstr >> x >> y >> z >> real >> i >> j >> k;
+			Basis<double> basis(Point<double>(x, y, z), Quaternion<double>(real, i, j, k));
+			sum += basis.AxisX().ComponantY();
+		}
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(recordCount);
+	state.SetBytesProcessed(texts.bases.size());
+}
+
+BENCHMARK(Parser, BasisBuffer) {
+	const Texts& texts = SharedTexts();
+	LuGaBasisParser<double> parser;
+	Basis<double> basis;
+	double sum = 0;
+	while(state.KeepRunning()){
+		const char* first = texts.bases.data();
+		const char* last = first + texts.bases.size();
+		while(parser.Parse(first, last, basis))
+			sum += basis.AxisX().ComponantY();
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(recordCount);
+	state.SetBytesProcessed(texts.bases.size());
+}
+
+BENCHMARK(Parser, Strtod) {
+	const Texts& texts = SharedTexts();
+	double sum = 0;
+	while(state.KeepRunning()){
+		const char* first = texts.vectors.c_str();
+		char* end;
+		while(true){
+			double value = std::strtod(first, &end);
+			if(end == first)
+				break;
+			sum += value;
+			first = end;
+		}
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(3*recordCount);
+	state.SetBytesProcessed(texts.vectors.size());
+}
+
+BENCHMARK(Parser, NumberParser) {
+	const Texts& texts = SharedTexts();
+	double sum = 0;
+	while(state.KeepRunning()){
+		const char* first = texts.vectors.data();
+		const char* last = first + texts.vectors.size();
+		double value;
+		while(NumberParser<double>::Parse(first, last, value))
+			sum += value;
+	}
+	Benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(3*recordCount);
+	state.SetBytesProcessed(texts.vectors.size());
+}
@@ -0,0 +1,222 @@
+#include <Benchmark.h>
+#include <random>
+#include <Basis.h>
+#include <Matrix.h>
+#include <Vector.h>
+#include <VectorsQuaternionConverter.h>
+
+using namespace GeometricalSpaceObjects;
+
+namespace {
+
+	const std::size_t inputCount = 1024;
+
+	// Only mpreal has a precision to set: 50 digits, as in the tests.
+	template<class T>
+	void SetPrecision() {}
+
+	template<>
+	void SetPrecision<mpfr::mpreal>() {
+		mpfr::mpreal::set_default_prec(mpfr::digits2bits(50));
+	}
+
+	// The same random operands for every type. Rotations are unit quaternions and
+	// matrices diagonally dominant, as inertia matrices are.
+	template<class T>
+	struct Inputs{
+		std::vector<Vector<T>> vectors;
+		std::vector<Quaternion<T>> rotations;
+		std::vector<Matrix<T>> matrices;
+		std::vector<Basis<T>> bases;
+		std::vector<Vector<T>> axes;
+
+		Inputs() {
+			SetPrecision<T>();
+			std::mt19937 generator(1);
+			std::uniform_real_distribution<double> value(-1, 1);
+			auto random = [&]{ return T(value(generator)); };
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				vectors.push_back(Vector<T>(random(), random(), random()));
+				Quaternion<T> q(random(), random(), random(), random());
+				q.Normalize();
+				rotations.push_back(q);
+				matrices.push_back(Matrix<T>(T(4) + random(), random(), random(),
+											 random(), T(4) + random(), random(),
+											 random(), random(), T(4) + random()));
+				bases.push_back(Basis<T>(Point<T>(random(), random(), random()), q));
+				axes.push_back(bases.back().AxisX());
+				axes.push_back(bases.back().AxisY());
+				axes.push_back(bases.back().AxisZ());
+			}
+		}
+	};
+
+	template<class T>
+	const Inputs<T>& SharedInputs() {
+		static Inputs<T> inputs;
+		return inputs;
+	}
+
+	template<class T>
+	void VectorDot(Benchmark::State& state) {
+		const auto& vectors = SharedInputs<T>().vectors;
+		T sum = 0;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i)
+				sum += vectors[i]*vectors[inputCount - 1 - i];
+		Benchmark::DoNotOptimize(sum);
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void VectorCross(Benchmark::State& state) {
+		const auto& vectors = SharedInputs<T>().vectors;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Vector<T> c = vectors[i]^vectors[inputCount - 1 - i];
+				Benchmark::DoNotOptimize(c);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void VectorNormalize(Benchmark::State& state) {
+		const auto& vectors = SharedInputs<T>().vectors;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Vector<T> v = vectors[i];
+				v.Normalize();
+				Benchmark::DoNotOptimize(v);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void QuaternionProduct(Benchmark::State& state) {
+		const auto& rotations = SharedInputs<T>().rotations;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Quaternion<T> q = rotations[i]*rotations[inputCount - 1 - i];
+				Benchmark::DoNotOptimize(q);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	// From a rotation vector, as in the integration of angular velocities.
+	template<class T>
+	void QuaternionConstruction(Benchmark::State& state) {
+		const auto& vectors = SharedInputs<T>().vectors;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Quaternion<T> q(vectors[i]);
+				Benchmark::DoNotOptimize(q);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void MatrixInverse(Benchmark::State& state) {
+		const auto& matrices = SharedInputs<T>().matrices;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Matrix<T> inverse = matrices[i].MatrixInverse();
+				Benchmark::DoNotOptimize(inverse);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void MatrixVectorProduct(Benchmark::State& state) {
+		const Inputs<T>& inputs = SharedInputs<T>();
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Vector<T> v = inputs.matrices[i]*inputs.vectors[i];
+				Benchmark::DoNotOptimize(v);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void BasisRotate(Benchmark::State& state) {
+		const Inputs<T>& inputs = SharedInputs<T>();
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Basis<T> basis = inputs.bases[i];
+				basis.Rotate(inputs.rotations[inputCount - 1 - i]);
+				Benchmark::DoNotOptimize(basis);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void BasisLocal(Benchmark::State& state) {
+		const Inputs<T>& inputs = SharedInputs<T>();
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Vector<T> v = inputs.vectors[i];
+				inputs.bases[inputCount - 1 - i].Local(v);
+				Benchmark::DoNotOptimize(v);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void BasisGlobal(Benchmark::State& state) {
+		const Inputs<T>& inputs = SharedInputs<T>();
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				Vector<T> v = inputs.vectors[i];
+				inputs.bases[inputCount - 1 - i].Global(v);
+				Benchmark::DoNotOptimize(v);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void VectorsIntoQuaternion(Benchmark::State& state) {
+		const auto& axes = SharedInputs<T>().axes;
+		VectorsQuaternionConverter<T> converter;
+		Quaternion<T> q;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				converter.ConvertVectorsIntoQuaternion(axes[3*i], axes[3*i + 1], axes[3*i + 2], q);
+				Benchmark::DoNotOptimize(q);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+	template<class T>
+	void QuaternionIntoVectors(Benchmark::State& state) {
+		const auto& rotations = SharedInputs<T>().rotations;
+		VectorsQuaternionConverter<T> converter;
+		Vector<T> e1, e2, e3;
+		while(state.KeepRunning())
+			for(std::size_t i = 0 ; i < inputCount ; ++i){
+				converter.ConvertQuaternionIntoVectors(rotations[i], e1, e2, e3);
+				Benchmark::DoNotOptimize(e3);
+			}
+		state.SetItemsProcessed(inputCount);
+	}
+
+}
+
+// Registers every primitive for one scalar type, named like Vector.Dot<double>.
+#define PRIMITIVE_BENCHMARKS(T, label) \
+	static Benchmark::Registrar label##_Registrars[] = { \
+		{"Vector.Dot<" #label ">", VectorDot<T>}, \
+		{"Vector.Cross<" #label ">", VectorCross<T>}, \
+		{"Vector.Normalize<" #label ">", VectorNormalize<T>}, \
+		{"Quaternion.Product<" #label ">", QuaternionProduct<T>}, \
+		{"Quaternion.Construction<" #label ">", QuaternionConstruction<T>}, \
+		{"Matrix.Inverse<" #label ">", MatrixInverse<T>}, \
+		{"Matrix.VectorProduct<" #label ">", MatrixVectorProduct<T>}, \
+		{"Basis.Rotate<" #label ">", BasisRotate<T>}, \
+		{"Basis.Local<" #label ">", BasisLocal<T>}, \
+		{"Basis.Global<" #label ">", BasisGlobal<T>}, \
+		{"Converter.VectorsIntoQuaternion<" #label ">", VectorsIntoQuaternion<T>}, \
+		{"Converter.QuaternionIntoVectors<" #label ">", QuaternionIntoVectors<T>} \
+	}
+
+PRIMITIVE_BENCHMARKS(double, double);
+PRIMITIVE_BENCHMARKS(float, float);
+PRIMITIVE_BENCHMARKS(mpfr::mpreal, mpreal);
@@ -0,0 +1,5 @@
+#include <Benchmark.h>
+
+int main(int argc, char *argv[]){
+	return Benchmark::Registry::Instance().Run(argc, argv);
+}
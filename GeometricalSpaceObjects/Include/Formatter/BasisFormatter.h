@@ -21,14 +21,24 @@ namespace GeometricalSpaceObjects {
 	template<class T>
 	class LuGaBasisFormatter: public BasisFormatter<T>{
 	public:
-		LuGaBasisFormatter(){}
+		LuGaBasisFormatter(int precision = 15):pointFormatter(precision), quaternionFormatter(precision){}
 		~LuGaBasisFormatter(){}
 		
 		virtual std::string Format(const Basis<T>& basis) {
-			auto origin = LuGaPointFormatter<T>().Format(basis.Origin());
-			auto orientation = LuGaQuaternionFormatter<T>().Format(basis.Orientation());
-			return origin + "\n" + orientation;
+			std::string text;
+			this->Format(basis, text);
+			return text;
 		}
+		
+		void Format(const Basis<T>& basis, std::string& out) const {
+			this->pointFormatter.Format(basis.Origin(), out);
+			out += '\n';
+			this->quaternionFormatter.Format(basis.Orientation(), out);
+		}
+		
+	private:
+		LuGaPointFormatter<T> pointFormatter;
+		LuGaQuaternionFormatter<T> quaternionFormatter;
 	};
 	
 }
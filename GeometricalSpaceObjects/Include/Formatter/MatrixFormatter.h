@@ -1,5 +1,9 @@
 #pragma once
 
+#include <string>
+
+#include "NumberFormatter.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -16,17 +20,29 @@ namespace GeometricalSpaceObjects {
 	template<class T>
 	class LuGaMatrixFormatter: public MatrixFormatter<T>{
 	public:
-		LuGaMatrixFormatter(){}
+		LuGaMatrixFormatter(int precision = 15):precision(precision){}
 		~LuGaMatrixFormatter(){}
 		
-		virtual std::string Format(const Matrix<T>& matrix) {;
-			std::stringstream sstr;
-			sstr.precision(15);
-			sstr << std::scientific  << matrix.Element(0, 0) << "\t" << matrix.Element(0, 1) << "\t" << matrix.Element(0, 2) << "\n"
-			<< matrix.Element(1, 0) << "\t" << matrix.Element(1, 1) << "\t" << matrix.Element(1, 2) << "\n"
-			<< matrix.Element(2, 0) << "\t" << matrix.Element(2, 1) << "\t" << matrix.Element(2, 2);
-			return sstr.str();
+		virtual std::string Format(const Matrix<T>& matrix) {
+			std::string text;
+			this->Format(matrix, text);
+			return text;
 		}
+		
+		void Format(const Matrix<T>& matrix, std::string& out) const {
+			for(int i = 0 ; i < 3 ; ++i){
+				if(i != 0)
+					out += '\n';
+				for(int j = 0 ; j < 3 ; ++j){
+					if(j != 0)
+						out += '\t';
+					NumberFormatter::Append(matrix.Element(i, j), this->precision, out);
+				}
+			}
+		}
+		
+	private:
+		int precision;
 	};
 
 }
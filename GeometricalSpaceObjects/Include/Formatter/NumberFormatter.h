@@ -0,0 +1,253 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace GeometricalSpaceObjects {
+	
+	// Appends numbers as text to a caller-owned buffer, without streams. Shortest gives
+	// the fewest digits that read back to the same double (Grisu2, which is shortest in
+	// all but rare cases and always round-trips); Scientific gives the exact text of
+	// printf("%.*e").
+	class NumberFormatter{
+	public:
+		static const int shortest = -1;
+		
+		static void Scientific(double value, int precision, std::string& out) {
+			char buffer[512];
+			int length = std::snprintf(buffer, sizeof(buffer), "%.*e", precision, value);
+			out.append(buffer, length < static_cast<int>(sizeof(buffer)) ? length : sizeof(buffer) - 1);
+		}
+		
+		// Scientific notation with at least two exponent digits, like %e.
+		static void Shortest(double value, std::string& out) {
+			char buffer[32];
+			out.append(buffer, Shortest(value, buffer));
+		}
+		
+		static int Shortest(double value, char* buffer) {
+			char* p = buffer;
+			if(std::signbit(value))
+				*p++ = '-';
+			if(std::isnan(value))
+				return static_cast<int>(p - buffer) + Copy(p, "nan");
+			if(std::isinf(value))
+				return static_cast<int>(p - buffer) + Copy(p, "inf");
+			if(value == 0)
+				return static_cast<int>(p - buffer) + Copy(p, "0e+00");
+			
+			char digits[20];
+			int length, exponent;
+			Grisu2(std::fabs(value), digits, length, exponent);
+			exponent += length - 1;
+			*p++ = digits[0];
+			if(length > 1){
+				*p++ = '.';
+				std::memcpy(p, digits + 1, length - 1);
+				p += length - 1;
+			}
+			*p++ = 'e';
+			*p++ = exponent < 0 ? '-' : '+';
+			unsigned magnitude = exponent < 0 ? -exponent : exponent;
+			if(magnitude >= 100)
+				*p++ = static_cast<char>('0' + magnitude/100);
+			*p++ = static_cast<char>('0' + magnitude/10 % 10);
+			*p++ = static_cast<char>('0' + magnitude % 10);
+			return static_cast<int>(p - buffer);
+		}
+		
+		// Floating point values go through Shortest or Scientific, anything else through
+		// a stream with the same settings.
+		template<class T>
+		static void Append(const T& value, int precision, std::string& out) {
+			Append(value, precision, out, std::is_floating_point<T>());
+		}
+		
+	private:
+		template<class T>
+		static void Append(const T& value, int precision, std::string& out, std::true_type) {
+			if(precision == shortest)
+				Shortest(static_cast<double>(value), out);
+			else
+				Scientific(static_cast<double>(value), precision, out);
+		}
+		
+		template<class T>
+		static void Append(const T& value, int precision, std::string& out, std::false_type) {
+			std::stringstream sstr;
+			sstr.precision(precision == shortest ? 17 : precision);
+			sstr << std::scientific << value;
+			out += sstr.str();
+		}
+		
+		static int Copy(char* p, const char* text) {
+			int length = static_cast<int>(std::strlen(text));
+			std::memcpy(p, text, length);
+			return length;
+		}
+		
+		// Do-it-yourself floating point: f*2^e with a 64 bit significand.
+		struct DiyFp{
+			std::uint64_t f;
+			int e;
+			
+			DiyFp(std::uint64_t f, int e):f(f), e(e) {}
+			
+			explicit DiyFp(double value) {
+				std::uint64_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				int biased = static_cast<int>((bits >> 52) & 0x7ff);
+				std::uint64_t significand = bits & ((std::uint64_t(1) << 52) - 1);
+				if(biased != 0){
+					this->f = significand + (std::uint64_t(1) << 52);
+					this->e = biased - 1075;
+				}
+				else{
+					this->f = significand;
+					this->e = -1074;
+				}
+			}
+			
+			DiyFp operator-(const DiyFp& other) const { return DiyFp(this->f - other.f, this->e); }
+			
+			// Upper 64 bits of the 128 bit product, rounded.
+			DiyFp operator*(const DiyFp& other) const {
+				const std::uint64_t mask = 0xffffffff;
+				std::uint64_t a = this->f >> 32, b = this->f & mask, c = other.f >> 32, d = other.f & mask;
+				std::uint64_t ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+				std::uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (std::uint64_t(1) << 31);
+				return DiyFp(ac + (ad >> 32) + (bc >> 32) + (middle >> 32), this->e + other.e + 64);
+			}
+			
+			DiyFp Normalize() const {
+				int shift = __builtin_clzll(this->f);
+				return DiyFp(this->f << shift, this->e - shift);
+			}
+		};
+		
+		// 10^k as a normalized DiyFp, for k = -348 + 8*i.
+		static DiyFp CachedPower(int e, int& k) {
+			static const std::uint64_t significands[] = {
+				0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+				0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+				0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+				0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+				0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+				0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+				0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+				0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+				0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+				0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+				0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+				0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+				0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+				0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+				0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+				0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+				0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+				0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+				0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+				0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+				0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+				0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+			};
+			static const std::int16_t exponents[] = {
+				-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+				-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+				-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+				-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+				56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+				375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+				694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+				1013, 1039, 1066
+			};
+			double dk = (-61 - e)*0.30102999566398114 + 347;
+			int ceiling = static_cast<int>(dk);
+			if(dk - ceiling > 0)
+				++ceiling;
+			unsigned index = static_cast<unsigned>((ceiling >> 3) + 1);
+			k = -(-348 + static_cast<int>(index << 3));
+			return DiyFp(significands[index], exponents[index]);
+		}
+		
+		static void Round(char* digits, int length, std::uint64_t delta, std::uint64_t rest, std::uint64_t tenKappa, std::uint64_t distance) {
+			while(rest < distance && delta - rest >= tenKappa && (rest + tenKappa < distance || distance - rest > rest + tenKappa - distance)){
+				--digits[length - 1];
+				rest += tenKappa;
+			}
+		}
+		
+		static int DecimalDigits(std::uint32_t n) {
+			int count = 1;
+			while(n >= 10){
+				n /= 10;
+				++count;
+			}
+			return count;
+		}
+		
+		static void GenerateDigits(const DiyFp& w, const DiyFp& upper, std::uint64_t delta, char* digits, int& length, int& k) {
+			static const std::uint64_t powers[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+				1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+				1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL};
+			const DiyFp one(std::uint64_t(1) << -upper.e, upper.e);
+			const DiyFp distance = upper - w;
+			std::uint32_t integral = static_cast<std::uint32_t>(upper.f >> -one.e);
+			std::uint64_t fractional = upper.f & (one.f - 1);
+			int kappa = DecimalDigits(integral);
+			length = 0;
+			while(kappa > 0){
+				std::uint32_t power = static_cast<std::uint32_t>(powers[kappa - 1]);
+				std::uint32_t digit = integral/power;
+				integral %= power;
+				if(digit != 0 || length != 0)
+					digits[length++] = static_cast<char>('0' + digit);
+				--kappa;
+				std::uint64_t rest = (static_cast<std::uint64_t>(integral) << -one.e) + fractional;
+				if(rest <= delta){
+					k += kappa;
+					Round(digits, length, delta, rest, powers[kappa] << -one.e, distance.f);
+					return;
+				}
+			}
+			while(true){
+				fractional *= 10;
+				delta *= 10;
+				char digit = static_cast<char>(fractional >> -one.e);
+				if(digit != 0 || length != 0)
+					digits[length++] = static_cast<char>('0' + digit);
+				fractional &= one.f - 1;
+				--kappa;
+				if(fractional < delta){
+					k += kappa;
+					Round(digits, length, delta, fractional, one.f, -kappa < 20 ? distance.f*powers[-kappa] : 0);
+					return;
+				}
+			}
+		}
+		
+		// Digits and decimal exponent of a positive finite value: value ~ digits*10^k.
+		static void Grisu2(double value, char* digits, int& length, int& k) {
+			const DiyFp v(value);
+			// Boundaries halfway to the neighboring doubles, on the exponent of the upper one.
+			DiyFp upper = DiyFp((v.f << 1) + 1, v.e - 1).Normalize();
+			DiyFp lower = v.f == (std::uint64_t(1) << 52) ? DiyFp((v.f << 2) - 1, v.e - 2) : DiyFp((v.f << 1) - 1, v.e - 1);
+			lower.f <<= lower.e - upper.e;
+			lower.e = upper.e;
+			
+			const DiyFp power = CachedPower(upper.e, k);
+			const DiyFp w = v.Normalize()*power;
+			DiyFp scaledUpper = upper*power;
+			DiyFp scaledLower = lower*power;
+			++scaledLower.f;
+			--scaledUpper.f;
+			GenerateDigits(w, scaledUpper, scaledUpper.f - scaledLower.f, digits, length, k);
+		}
+	};
+	
+}
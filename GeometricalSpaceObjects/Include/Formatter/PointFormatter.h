@@ -1,5 +1,9 @@
 #pragma once
 
+#include <string>
+
+#include "NumberFormatter.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -16,15 +20,25 @@ namespace GeometricalSpaceObjects {
 	template<class T>
 	class LuGaPointFormatter: public PointFormatter<T>{
 	public:
-		LuGaPointFormatter(){}
+		LuGaPointFormatter(int precision = 15):precision(precision){}
 		~LuGaPointFormatter(){}
 		
 		virtual std::string Format(const Point<T>& point) {
-			std::stringstream sstr;
-			sstr.precision(15);
-			sstr << std::scientific  << point.CoordinateX() << "\t" << point.CoordinateY() << "\t" << point.CoordinateZ();
-			return sstr.str();
+			std::string text;
+			this->Format(point, text);
+			return text;
 		}
+		
+		void Format(const Point<T>& point, std::string& out) const {
+			NumberFormatter::Append(point.CoordinateX(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(point.CoordinateY(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(point.CoordinateZ(), this->precision, out);
+		}
+		
+	private:
+		int precision;
 	};
 	
 }
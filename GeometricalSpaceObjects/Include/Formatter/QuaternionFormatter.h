@@ -3,6 +3,8 @@
 #include <string>
 #include <sstream>
 
+#include "NumberFormatter.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -19,15 +21,27 @@ namespace GeometricalSpaceObjects {
 	template<class T>
 	class LuGaQuaternionFormatter: public QuaternionFormatter<T>{
 	public:
-		LuGaQuaternionFormatter(){}
+		LuGaQuaternionFormatter(int precision = 15):precision(precision){}
 		~LuGaQuaternionFormatter(){}
 		
 		virtual std::string Format(const Quaternion<T>& quaternion) {
-			std::stringstream sstr;
-		  sstr.precision(15);
-			sstr << std::scientific  << quaternion.ComponantReal() << "\t" << quaternion.ComponantI() << "\t" << quaternion.ComponantJ() << "\t" << quaternion.ComponantK();
-			return sstr.str();
+			std::string text;
+			this->Format(quaternion, text);
+			return text;
+		}
+		
+		void Format(const Quaternion<T>& quaternion, std::string& out) const {
+			NumberFormatter::Append(quaternion.ComponantReal(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(quaternion.ComponantI(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(quaternion.ComponantJ(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(quaternion.ComponantK(), this->precision, out);
 		}
+		
+	private:
+		int precision;
 	};
 
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <sstream>
+#include <string>
+
+#include "NumberFormatter.h"
 
 namespace GeometricalSpaceObjects {
 	
@@ -18,15 +21,26 @@ namespace GeometricalSpaceObjects {
 	template<class T>
 	class LuGaVectorFormatter: public VectorFormatter<T>{
 	public:
-		LuGaVectorFormatter(){}
+		LuGaVectorFormatter(int precision = 15):precision(precision){}
 		~LuGaVectorFormatter(){}
 		
 		virtual std::string Format(const Vector<T>& vector) {
-			std::stringstream sstr;
-			sstr.precision(15);
-			sstr << std::scientific  << vector.ComponantX() << "\t" << vector.ComponantY() << "\t" << vector.ComponantZ();
-			return sstr.str();
+			std::string text;
+			this->Format(vector, text);
+			return text;
+		}
+		
+		// Appends to out; a negative precision writes the shortest round-trip digits.
+		void Format(const Vector<T>& vector, std::string& out) const {
+			NumberFormatter::Append(vector.ComponantX(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(vector.ComponantY(), this->precision, out);
+			out += '\t';
+			NumberFormatter::Append(vector.ComponantZ(), this->precision, out);
 		}
+		
+	private:
+		int precision;
 	};
 
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "NumberParser.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -20,15 +22,19 @@ namespace GeometricalSpaceObjects {
 		~LuGaBasisParser(){}
 		
 		virtual Basis<T> Parse(const std::string& str) {
-			std::stringstream sstr(str);
+			const char* first = str.data();
 			Basis<T> basis;
-			T x = 0,y = 0,z = 0;
-			sstr >> x >> y >> z;
-			basis.Origin(Point<T>(x, y, z));
-			T real = 0, i = 0, j = 0, k = 0;
-			sstr >> real >> i >> i >> k;
-			basis.Orientation(Quaternion<T>(real, i, j, k));
-			return std::move(basis);
+			this->Parse(first, first + str.size(), basis);
+			return basis;
+		}
+		
+		bool Parse(const char*& first, const char* last, Basis<T>& basis) {
+			Point<T> origin;
+			Quaternion<T> orientation;
+			bool parsed = LuGaPointParser<T>().Parse(first, last, origin) && LuGaQuaternionParser<T>().Parse(first, last, orientation);
+			basis.Origin(origin);
+			basis.Orientation(orientation);
+			return parsed;
 		}
 	};
 	
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "NumberParser.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -20,16 +22,22 @@ namespace GeometricalSpaceObjects {
 		~LuGaMatrixParser(){}
 		
 		virtual Matrix<T> Parse(const std::string& str) {
-			std::stringstream sstr(str);
-			T element;
+			const char* first = str.data();
 			Matrix<T> matrix;
+			this->Parse(first, first + str.size(), matrix);
+			return matrix;
+		}
+		
+		bool Parse(const char*& first, const char* last, Matrix<T>& matrix) {
 			for(int i = 0 ; i < 3 ; ++i) {
 				for(int j = 0 ; j < 3 ; ++j) {
-					sstr >> element;
+					T element = 0;
+					if(!NumberParser<T>::Parse(first, last, element))
+						return false;
 					matrix.Element(i, j, element);
 				}
 			}
-			return std::move(matrix);
+			return true;
 		}
 	};
 
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace GeometricalSpaceObjects {
+
+	// Reads one number from [first, last) after optional blanks, with the syntax of
+	// strtod. On success first is moved past the number; otherwise it is left unchanged
+	// and false is returned. Doubles are read without allocating: short decimal
+	// mantissas take an exact floating point path and the rest falls back to strtod
+	// on a copy held on the stack.
+	template<class T>
+	class NumberParser{
+	public:
+		static bool Parse(const char*& first, const char* last, T& value) {
+			return Parse(first, last, value, std::is_floating_point<T>());
+		}
+
+	private:
+		static bool Parse(const char*& first, const char* last, T& value, std::true_type) {
+			double number;
+			if(!ParseDouble(first, last, number))
+				return false;
+			value = static_cast<T>(number);
+			return true;
+		}
+
+		// Arbitrary precision types are built from the text of the number.
+		static bool Parse(const char*& first, const char* last, T& value, std::false_type) {
+			const char* start = SkipBlanks(first, last);
+			const char* end = start;
+			double ignored;
+			if(!ParseDouble(end, last, ignored))
+				return false;
+			char buffer[512];
+			std::size_t length = end - start;
+			if(length >= sizeof(buffer))
+				return false;
+			std::memcpy(buffer, start, length);
+			buffer[length] = '\0';
+			value = T(buffer);
+			first = end;
+			return true;
+		}
+
+		static const char* SkipBlanks(const char* p, const char* last) {
+			while(p != last && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+				++p;
+			return p;
+		}
+
+		static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+		static bool ParseDouble(const char*& first, const char* last, double& value) {
+			static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+			const char* start = SkipBlanks(first, last);
+			const char* p = start;
+			bool negative = false;
+			if(p != last && (*p == '-' || *p == '+'))
+				negative = *p++ == '-';
+
+			if(last - p > 1 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')){
+				std::size_t length = last - start;
+				return Fallback(first, start, start + (length < 64 ? length : 64), value);
+			}
+			
+			// Up to 19 significant digits fit in the mantissa.
+			std::uint64_t mantissa = 0;
+			int digits = 0;
+			int exponent = 0;
+			bool any = false;
+			bool truncated = false;
+			for(; p != last && IsDigit(*p) ; ++p){
+				any = true;
+				if(digits < 19){
+					mantissa = 10*mantissa + (*p - '0');
+					digits += mantissa != 0;
+				}
+				else{
+					++exponent;
+					truncated |= *p != '0';
+				}
+			}
+			if(p != last && *p == '.'){
+				for(++p ; p != last && IsDigit(*p) ; ++p){
+					any = true;
+					if(digits < 19){
+						mantissa = 10*mantissa + (*p - '0');
+						digits += mantissa != 0;
+						--exponent;
+					}
+					else
+						truncated |= *p != '0';
+				}
+			}
+			if(!any){
+				// Only inf and nan remain, both short like hexadecimal numbers.
+				std::size_t length = last - start;
+				return Fallback(first, start, start + (length < 32 ? length : 32), value);
+			}
+			if(p != last && (*p == 'e' || *p == 'E')){
+				const char* q = p + 1;
+				bool negativeExponent = false;
+				if(q != last && (*q == '-' || *q == '+'))
+					negativeExponent = *q++ == '-';
+				if(q != last && IsDigit(*q)){
+					int written = 0;
+					for(; q != last && IsDigit(*q) ; ++q)
+						if(written < 100000)
+							written = 10*written + (*q - '0');
+					exponent += negativeExponent ? -written : written;
+					p = q;
+				}
+			}
+
+			if(mantissa == 0 && !truncated){
+				value = negative ? -0.0 : 0.0;
+				first = p;
+				return true;
+			}
+			if(!truncated && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22){
+				// Clinger: both operands are exact, so the single rounding is correct.
+				double result = static_cast<double>(mantissa);
+				result = exponent < 0 ? result/powers[-exponent] : result*powers[exponent];
+				value = negative ? -result : result;
+				first = p;
+				return true;
+			}
+#if LDBL_MANT_DIG >= 64
+			if(!truncated && exponent >= -27 && exponent <= 27){
+				// With a 64 bit mantissa the product or quotient is rounded once; rounding
+				// it again to double is exact unless it lies next to a midpoint.
+				long double power = 1;
+				for(int k = 0 ; k < (exponent < 0 ? -exponent : exponent) ; ++k)
+					power *= 10;
+				long double result = exponent < 0 ? mantissa/power : mantissa*power;
+				int binaryExponent;
+				std::uint64_t bits = static_cast<std::uint64_t>(std::ldexp(std::frexp(result, &binaryExponent), 64));
+				std::uint64_t dropped = bits & 0x7ff;
+				if(dropped < 0x3ff || dropped > 0x401){
+					value = static_cast<double>(negative ? -result : result);
+					first = p;
+					return true;
+				}
+			}
+#endif
+			return Fallback(first, start, p, value);
+		}
+
+		static bool Fallback(const char*& first, const char* start, const char* end, double& value) {
+			char buffer[512];
+			std::size_t length = end - start;
+			if(length == 0 || length >= sizeof(buffer))
+				return false;
+			std::memcpy(buffer, start, length);
+			buffer[length] = '\0';
+			char* parsed;
+			double result = std::strtod(buffer, &parsed);
+			if(parsed == buffer)
+				return false;
+			value = result;
+			first = start + (parsed - buffer);
+			return true;
+		}
+	};
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "NumberParser.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -20,10 +22,17 @@ namespace GeometricalSpaceObjects {
 		~LuGaPointParser(){}
 		
 		virtual Point<T> Parse(const std::string& str) {
-			std::stringstream sstr(str);
+			const char* first = str.data();
+			Point<T> point;
+			this->Parse(first, first + str.size(), point);
+			return point;
+		}
+		
+		bool Parse(const char*& first, const char* last, Point<T>& point) {
 			T x = 0,y = 0,z = 0;
-			sstr >> x >> y >> z;
-			return Point<T>(x, y, z);
+			bool parsed = NumberParser<T>::Parse(first, last, x) && NumberParser<T>::Parse(first, last, y) && NumberParser<T>::Parse(first, last, z);
+			point = Point<T>(x, y, z);
+			return parsed;
 		}
 	};
 
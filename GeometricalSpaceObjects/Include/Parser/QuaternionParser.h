@@ -1,5 +1,7 @@
 #pragma once
 
+#include "NumberParser.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -20,10 +22,18 @@ namespace GeometricalSpaceObjects {
 		~LuGaQuaternionParser(){}
 		
 		virtual Quaternion<T> Parse(const std::string& str) {
-			std::stringstream sstr(str);
+			const char* first = str.data();
+			Quaternion<T> quaternion;
+			this->Parse(first, first + str.size(), quaternion);
+			return quaternion;
+		}
+		
+		bool Parse(const char*& first, const char* last, Quaternion<T>& quaternion) {
 			T real = 0, i = 0, j = 0, k = 0;
-			sstr >> real >> i >> i >> k;
-			return Quaternion<T>(real, i, j, k);
+			bool parsed = NumberParser<T>::Parse(first, last, real) && NumberParser<T>::Parse(first, last, i)
+			&& NumberParser<T>::Parse(first, last, j) && NumberParser<T>::Parse(first, last, k);
+			quaternion = Quaternion<T>(real, i, j, k);
+			return parsed;
 		}
 	};
 
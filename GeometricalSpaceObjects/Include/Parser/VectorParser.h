@@ -1,5 +1,7 @@
 #pragma once
 
+#include "NumberParser.h"
+
 namespace GeometricalSpaceObjects {
 	
 	template<class T>
@@ -20,10 +22,19 @@ namespace GeometricalSpaceObjects {
 		~LuGaVectorParser(){}
 		
 		virtual Vector<T> Parse(const std::string& str) {
-			std::stringstream sstr(str);
+			const char* first = str.data();
+			Vector<T> vector;
+			this->Parse(first, first + str.size(), vector);
+			return vector;
+		}
+		
+		// Reads three components from [first, last) and moves first past them. The
+		// components read before a failure are kept.
+		bool Parse(const char*& first, const char* last, Vector<T>& vector) {
 			T x = 0,y = 0,z = 0;
-			sstr >> x >> y >> z;
-			return Vector<T>(x, y, z);
+			bool parsed = NumberParser<T>::Parse(first, last, x) && NumberParser<T>::Parse(first, last, y) && NumberParser<T>::Parse(first, last, z);
+			vector = Vector<T>(x, y, z);
+			return parsed;
 		}
 	};
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include "Point.h"
+#include "Vector.h"
+
+namespace GeometricalSpaceObjects {
+	
+	template<class T>
+	class PeriodicBox {
+	public:
+		PeriodicBox():lower(),upper(),periodic{false, false, false} {}
+		PeriodicBox(const Point<T> & lower, const Point<T> & upper, bool xAxis = true, bool yAxis = true, bool zAxis = true):lower(lower),upper(upper),periodic{xAxis, yAxis, zAxis} {}
+		
+		~PeriodicBox() {}
+		
+		Point<T> Lower() const {return this->lower;}
+		Point<T> Upper() const {return this->upper;}
+		Vector<T> Lengths() const {return this->upper - this->lower;}
+		
+		bool IsXPeriodic() const {return this->periodic[0];}
+		bool IsYPeriodic() const {return this->periodic[1];}
+		bool IsZPeriodic() const {return this->periodic[2];}
+		bool IsPeriodic() const {return this->periodic[0] || this->periodic[1] || this->periodic[2];}
+		
+		void Wrap(Point<T> & a) const{
+			Vector<T> l = this->Lengths();
+			a.SetCoordinates(this->periodic[0] ? Wrap(a.CoordinateX(), this->lower.CoordinateX(), l.ComponantX()) : a.CoordinateX(),
+											 this->periodic[1] ? Wrap(a.CoordinateY(), this->lower.CoordinateY(), l.ComponantY()) : a.CoordinateY(),
+											 this->periodic[2] ? Wrap(a.CoordinateZ(), this->lower.CoordinateZ(), l.ComponantZ()) : a.CoordinateZ());
+		}
+		
+		Point<T> Wrapped(const Point<T> & a) const{
+			Point<T> b = a;
+			this->Wrap(b);
+			return b;
+		}
+		
+		void MinimumImage(Vector<T> & a) const{
+			Vector<T> l = this->Lengths();
+			a.SetComponants(this->periodic[0] ? MinimumImage(a.ComponantX(), l.ComponantX()) : a.ComponantX(),
+											this->periodic[1] ? MinimumImage(a.ComponantY(), l.ComponantY()) : a.ComponantY(),
+											this->periodic[2] ? MinimumImage(a.ComponantZ(), l.ComponantZ()) : a.ComponantZ());
+		}
+		
+		// Shortest vector from b to a among the periodic images of a.
+		Vector<T> Displacement(const Point<T> & a, const Point<T> & b) const{
+			Vector<T> v = a - b;
+			this->MinimumImage(v);
+			return v;
+		}
+		
+	private:
+		static T Wrap(const T & x, const T & lower, const T & length){
+			T y = x - length*floor((x - lower)/length);
+			// Rounding may land exactly on the upper bound.
+			return y < lower + length ? y : lower;
+		}
+		
+		static T MinimumImage(const T & x, const T & length){
+			return x - length*floor(x/length + 0.5);
+		}
+		
+		Point<T> lower,upper;
+		bool periodic[3];
+	};
+	
+}
+
+template<class T> inline std::ostream & operator << (std::ostream & out, const GeometricalSpaceObjects::PeriodicBox<T> & a) {
+	out << a.Lower() << "\n" << a.Upper() << "\n" << a.IsXPeriodic() << "\t" << a.IsYPeriodic() << "\t" << a.IsZPeriodic();
+	return out;
+}
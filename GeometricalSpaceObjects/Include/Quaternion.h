@@ -39,6 +39,10 @@ namespace GeometricalSpaceObjects {
 				componantJ = w.ComponantY()/a*sa;
 				componantK = w.ComponantZ()/a*sa;
 			}
+			else{
+				componantReal = 1.0;
+				componantI = componantJ = componantK = 0.0;
+			}
 		}
 
 		~Quaternion() {}
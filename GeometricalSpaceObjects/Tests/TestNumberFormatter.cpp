@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <Basis.h>
+#include <Matrix.h>
+#include <Formatter/NumberFormatter.h>
+#include "Precision.h"
+
+using namespace std;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	std::string Shortest(double value) {
+		std::string text;
+		NumberFormatter::Shortest(value, text);
+		return text;
+	}
+	
+	int SignificantDigits(const std::string& text) {
+		int count = 0;
+		for(char c : text){
+			if(c == 'e')
+				break;
+			count += c >= '0' && c <= '9';
+		}
+		return count;
+	}
+	
+	std::string Streamed(double value) {
+		std::stringstream sstr;
+		sstr.precision(15);
+		sstr << std::scientific << value;
+		return sstr.str();
+	}
+}
+
+TEST(NumberFormatterTest,ShortestRoundTrips){
+	std::mt19937_64 generator(3);
+	std::uniform_real_distribution<double> mantissa(-10, 10);
+	std::uniform_int_distribution<int> exponent(-30, 30);
+	int longer = 0, count = 0;
+	char text[64];
+	for(int n = 0 ; n < 200000 ; ++n){
+		double value = mantissa(generator)*std::pow(10., exponent(generator));
+		if(n % 2 == 0){
+			std::uint64_t bits = generator();
+			std::memcpy(&value, &bits, sizeof(value));
+			if(!std::isfinite(value))
+				continue;
+		}
+		std::string shortest = Shortest(value);
+		double parsed = std::strtod(shortest.c_str(), nullptr);
+		ASSERT_EQ(0, std::memcmp(&value, &parsed, sizeof(value))) << shortest;
+		
+		int digits = 1;
+		for(; digits < 17 ; ++digits){
+			std::snprintf(text, sizeof(text), "%.*e", digits - 1, value);
+			if(std::strtod(text, nullptr) == value)
+				break;
+		}
+		longer += SignificantDigits(shortest) > digits;
+		++count;
+	}
+	EXPECT_LT(longer, count/100);
+}
+
+TEST(NumberFormatterTest,ShortestSyntax){
+	EXPECT_EQ("0e+00", Shortest(0.));
+	EXPECT_EQ("-0e+00", Shortest(-0.));
+	EXPECT_EQ("1e+00", Shortest(1.));
+	EXPECT_EQ("-2.5e-01", Shortest(-0.25));
+	EXPECT_EQ("1.23456e+05", Shortest(123456.));
+	EXPECT_EQ("1e+300", Shortest(1e300));
+	EXPECT_EQ("5e-324", Shortest(5e-324));
+	EXPECT_EQ("1.7976931348623157e+308", Shortest(1.7976931348623157e308));
+	EXPECT_EQ("inf", Shortest(HUGE_VAL));
+	EXPECT_EQ("-inf", Shortest(-HUGE_VAL));
+	EXPECT_EQ("nan", Shortest(std::nan("")));
+}
+
+TEST(NumberFormatterTest,ScientificMatchesStream){
+	std::mt19937_64 generator(5);
+	std::uniform_real_distribution<double> mantissa(-10, 10);
+	std::uniform_int_distribution<int> exponent(-300, 300);
+	for(int n = 0 ; n < 20000 ; ++n){
+		double value = mantissa(generator)*std::pow(10., exponent(generator));
+		std::string text;
+		NumberFormatter::Scientific(value, 15, text);
+		ASSERT_EQ(Streamed(value), text);
+	}
+}
+
+TEST(NumberFormatterTest,FormattersAppend){
+	Vector<double> vector(1.5, -2.25, 1e-7);
+	std::string text = "v ";
+	LuGaVectorFormatter<double>().Format(vector, text);
+	EXPECT_EQ("v " + Streamed(1.5) + "\t" + Streamed(-2.25) + "\t" + Streamed(1e-7), text);
+	EXPECT_EQ(text.substr(2), LuGaVectorFormatter<double>().Format(vector));
+	
+	text.clear();
+	LuGaVectorFormatter<double>(NumberFormatter::shortest).Format(vector, text);
+	EXPECT_EQ("1.5e+00\t-2.25e+00\t1e-07", text);
+	
+	Quaternion<double> orientation(0.5, 0.5, -0.5, 0.5);
+	Basis<double> basis(Point<double>(0.1, 0.2, 0.3), orientation);
+	EXPECT_EQ("1e-01\t2e-01\t3e-01\n5e-01\t5e-01\t-5e-01\t5e-01", LuGaBasisFormatter<double>(NumberFormatter::shortest).Format(basis));
+	EXPECT_EQ(Streamed(0.1) + "\t" + Streamed(0.2) + "\t" + Streamed(0.3) + "\n"
+			  + Streamed(0.5) + "\t" + Streamed(0.5) + "\t" + Streamed(-0.5) + "\t" + Streamed(0.5), LuGaBasisFormatter<double>().Format(basis));
+	
+	Matrix<double> matrix;
+	for(int i = 0 ; i < 3 ; ++i)
+		for(int j = 0 ; j < 3 ; ++j)
+			matrix.Element(i, j, 3*i + j);
+	EXPECT_EQ("0e+00\t1e+00\t2e+00\n3e+00\t4e+00\t5e+00\n6e+00\t7e+00\t8e+00", LuGaMatrixFormatter<double>(NumberFormatter::shortest).Format(matrix));
+}
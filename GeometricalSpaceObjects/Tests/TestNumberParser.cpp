@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <Basis.h>
+#include <Matrix.h>
+#include <Parser/NumberParser.h>
+#include "Precision.h"
+
+using namespace std;
+using namespace GeometricalSpaceObjects;
+
+namespace {
+	bool ParseAll(const std::string& text, double& value, std::size_t& consumed) {
+		const char* first = text.data();
+		bool parsed = NumberParser<double>::Parse(first, text.data() + text.size(), value);
+		consumed = first - text.data();
+		return parsed;
+	}
+}
+
+TEST(NumberParserTest,MatchesStrtod){
+	std::mt19937_64 generator(9);
+	std::uniform_real_distribution<double> mantissa(-10, 10);
+	std::uniform_int_distribution<int> exponent(-40, 40);
+	const char* formats[] = {"%.15e", "%.17g", "%.6f", "%.3e", "%.20e", "%a"};
+	char text[1024];
+	for(int n = 0 ; n < 200000 ; ++n){
+		double value = mantissa(generator)*std::pow(10., exponent(generator));
+		if(n % 7 == 0){
+			std::uint64_t bits = generator();
+			std::memcpy(&value, &bits, sizeof(value));
+			if(!std::isfinite(value))
+				continue;
+		}
+		int length = std::snprintf(text, sizeof(text), formats[n % 6], value);
+		double expected = std::strtod(text, nullptr);
+		double parsed;
+		std::size_t consumed;
+		ASSERT_TRUE(ParseAll(std::string(text, length), parsed, consumed)) << text;
+		ASSERT_EQ(expected, parsed) << text;
+		ASSERT_EQ(static_cast<std::size_t>(length), consumed) << text;
+	}
+}
+
+TEST(NumberParserTest,Syntax){
+	double value = 0;
+	std::size_t consumed = 0;
+	EXPECT_TRUE(ParseAll(" \t\n-0", value, consumed));
+	EXPECT_TRUE(std::signbit(value));
+	EXPECT_EQ(5u, consumed);
+	EXPECT_TRUE(ParseAll("+.5e1x", value, consumed));
+	EXPECT_EQ(5., value);
+	EXPECT_EQ(5u, consumed);
+	EXPECT_TRUE(ParseAll("12e", value, consumed));
+	EXPECT_EQ(12., value);
+	EXPECT_EQ(2u, consumed);
+	EXPECT_TRUE(ParseAll("1e-400", value, consumed));
+	EXPECT_EQ(0., value);
+	EXPECT_TRUE(ParseAll("1e400", value, consumed));
+	EXPECT_TRUE(std::isinf(value));
+	EXPECT_TRUE(ParseAll("-inf\t", value, consumed));
+	EXPECT_TRUE(std::isinf(value) && value < 0);
+	EXPECT_EQ(4u, consumed);
+	EXPECT_TRUE(ParseAll("0.30000000000000000000000000000000000001", value, consumed));
+	EXPECT_EQ(std::strtod("0.30000000000000000000000000000000000001", nullptr), value);
+	
+	EXPECT_FALSE(ParseAll("", value, consumed));
+	EXPECT_FALSE(ParseAll("  ", value, consumed));
+	EXPECT_FALSE(ParseAll("-", value, consumed));
+	EXPECT_FALSE(ParseAll(".e5", value, consumed));
+	EXPECT_FALSE(ParseAll("x1", value, consumed));
+	EXPECT_EQ(0u, consumed);
+	
+	// The range end is honored even when more digits follow in memory.
+	std::string text = "123456";
+	const char* first = text.data();
+	EXPECT_TRUE(NumberParser<double>::Parse(first, text.data() + 3, value));
+	EXPECT_EQ(123., value);
+	
+	float single = 0;
+	first = text.data();
+	EXPECT_TRUE(NumberParser<float>::Parse(first, text.data() + text.size(), single));
+	EXPECT_EQ(123456.f, single);
+}
+
+TEST(NumberParserTest,Parsers){
+	std::string text = "1.5e+00\t-2.5e+00\t3.0e+00\n4.0e+00\t5.0e+00\t6.0e+00\t7.0e+00\nrest";
+	const char* first = text.data();
+	const char* last = text.data() + text.size();
+	Basis<double> basis;
+	EXPECT_TRUE(LuGaBasisParser<double>().Parse(first, last, basis));
+	EXPECT_EQ(1.5, basis.Origin().CoordinateX());
+	EXPECT_EQ(-2.5, basis.Origin().CoordinateY());
+	EXPECT_EQ(3., basis.Origin().CoordinateZ());
+	EXPECT_EQ(4., basis.Orientation().ComponantReal());
+	EXPECT_EQ(5., basis.Orientation().ComponantI());
+	EXPECT_EQ(6., basis.Orientation().ComponantJ());
+	EXPECT_EQ(7., basis.Orientation().ComponantK());
+	EXPECT_EQ("\nrest", std::string(first, last));
+	
+	Vector<double> vector;
+	EXPECT_FALSE(LuGaVectorParser<double>().Parse(first, last, vector));
+	
+	Quaternion<double> q = LuGaQuaternionParser<double>().Parse("1 2 3 4");
+	EXPECT_EQ(3., q.ComponantJ());
+	
+	Matrix<double> matrix = LuGaMatrixParser<double>().Parse("1 2 3\n4 5 6\n7 8 9");
+	EXPECT_EQ(6., matrix.Element(1, 2));
+	EXPECT_EQ(8., matrix.Element(2, 1));
+	
+	Point<double> point = LuGaPointParser<double>().Parse("1 2");
+	EXPECT_EQ(2., point.CoordinateY());
+	EXPECT_EQ(0., point.CoordinateZ());
+}
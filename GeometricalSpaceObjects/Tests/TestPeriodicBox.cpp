@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "PeriodicBox.h"
+#include "Precision.h"
+
+using namespace std;
+using namespace GeometricalSpaceObjects;
+
+
+#define Vector Vector<Type>
+#define Point Point<Type>
+#define PeriodicBox PeriodicBox<Type>
+
+
+class PeriodicBoxTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+#ifndef DOUBLE_PRECISON
+		mpfr::mpreal::set_default_prec(mpfr::digits2bits(50));
+#endif
+	}
+	
+	virtual void TearDown() {}
+};
+
+
+
+TEST_F(PeriodicBoxTest,Constructor){
+	PeriodicBox a;
+	EXPECT_FALSE(a.IsPeriodic());
+	
+	PeriodicBox b(Point(-1, 0, 0), Point(1, 2, 4), true, false, true);
+	EXPECT_TRUE(b.IsPeriodic());
+	EXPECT_TRUE(b.IsXPeriodic());
+	EXPECT_FALSE(b.IsYPeriodic());
+	EXPECT_TRUE(b.IsZPeriodic());
+	EXPECT_TRUE(fabs(b.Lengths().ComponantX() - 2) < 1e-15);
+	EXPECT_TRUE(fabs(b.Lengths().ComponantY() - 2) < 1e-15);
+	EXPECT_TRUE(fabs(b.Lengths().ComponantZ() - 4) < 1e-15);
+}
+
+TEST_F(PeriodicBoxTest,Wrap){
+	PeriodicBox box(Point(-1, 0, 0), Point(1, 2, 4), true, false, true);
+	Point a(1.5, 3, -0.5);
+	box.Wrap(a);
+	
+	EXPECT_TRUE(fabs(a.CoordinateX() + 0.5) < 1e-15);
+	EXPECT_TRUE(fabs(a.CoordinateY() - 3) < 1e-15);
+	EXPECT_TRUE(fabs(a.CoordinateZ() - 3.5) < 1e-15);
+	
+	Point b = box.Wrapped(Point(1, 0, 12.25));
+	EXPECT_TRUE(fabs(b.CoordinateX() + 1) < 1e-15);
+	EXPECT_TRUE(fabs(b.CoordinateZ() - 0.25) < 1e-15);
+}
+
+TEST_F(PeriodicBoxTest,MinimumImage){
+	PeriodicBox box(Point(0, 0, 0), Point(1, 1, 1));
+	Point a(0.95, 0.5, 0.02);
+	Point b(0.05, 0.1, 0.98);
+	
+	Vector c = box.Displacement(a, b);
+	EXPECT_TRUE(fabs(c.ComponantX() + 0.1) < 1e-15);
+	EXPECT_TRUE(fabs(c.ComponantY() - 0.4) < 1e-15);
+	EXPECT_TRUE(fabs(c.ComponantZ() - 0.04) < 1e-15);
+	
+	Vector d = box.Displacement(b, a);
+	EXPECT_TRUE(fabs(d.ComponantX() - 0.1) < 1e-15);
+	EXPECT_TRUE(fabs(d.ComponantZ() + 0.04) < 1e-15);
+	
+	PeriodicBox open;
+	Vector e = open.Displacement(a, b);
+	EXPECT_TRUE(fabs(e.ComponantX() - 0.9) < 1e-15);
+}
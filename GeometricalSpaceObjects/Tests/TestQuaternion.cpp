@@ -49,6 +49,17 @@ TEST_F(QuaternionTest,ConstructorVector3D){
 	EXPECT_MPREAL_EQ(0.,a.ComponantK());
 }
 
+TEST_F(QuaternionTest,ConstructorNullVector3D){
+	Vector<Type> w(0,0,0);
+	Quaternion a(w);
+	
+	// EXPECT_MPREAL_EQ does not assert: compare exactly, the identity has no rounding.
+	EXPECT_TRUE(a.ComponantReal() == 1);
+	EXPECT_TRUE(a.ComponantI() == 0);
+	EXPECT_TRUE(a.ComponantJ() == 0);
+	EXPECT_TRUE(a.ComponantK() == 0);
+}
+
 
 TEST_F(QuaternionTest,SetComponants){
 	Quaternion a;
@@ -1,12 +1,254 @@
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <climits>
-#include <Vector.h>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+#include <Simulation.h>
+#include <Sphere.h>
+#include <Disk.h>
+#include <Rectangle.h>
+#include <Profiler.h>
+
+using namespace GeometricalSpaceObjects;
+using namespace GeometricalSolid;
+
+namespace {
+
+	struct Settings{
+		std::size_t bodies{10000};
+		std::size_t steps{200};
+		std::size_t warmup{20};
+		std::size_t threads{1};
+		std::size_t reorder{0};
+		std::string precision{"double"};
+		std::string shapes{"mixed"};
+		double fraction{0.3};
+		unsigned seed{1};
+		bool profile{false};
+		std::string profileJson;
+		std::string trace;
+		std::size_t traceSteps{5};
+		bool counters{false};
+		double deadline{0};
+		double budget{0};
+		bool memory{false};
+	};
+
+	bool Option(const std::string& argument, const std::string& option, std::string& value) {
+		if(argument.compare(0, option.size(), option) != 0)
+			return false;
+		value = argument.substr(option.size());
+		return true;
+	}
+
+	bool Parse(int argc, char* argv[], Settings& settings) {
+		for(int i = 1 ; i < argc ; ++i){
+			std::string argument(argv[i]), value;
+			if(Option(argument, "--bodies=", value))
+				settings.bodies = std::strtoul(value.c_str(), nullptr, 10);
+			else if(Option(argument, "--steps=", value))
+				settings.steps = std::strtoul(value.c_str(), nullptr, 10);
+			else if(Option(argument, "--warmup=", value))
+				settings.warmup = std::strtoul(value.c_str(), nullptr, 10);
+			else if(Option(argument, "--threads=", value))
+				settings.threads = std::max(std::strtoul(value.c_str(), nullptr, 10), 1ul);
+			else if(Option(argument, "--reorder=", value))
+				settings.reorder = std::strtoul(value.c_str(), nullptr, 10);
+			else if(Option(argument, "--fraction=", value))
+				settings.fraction = std::strtod(value.c_str(), nullptr);
+			else if(Option(argument, "--seed=", value))
+				settings.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+			else if(Option(argument, "--precision=", value))
+				settings.precision = value;
+			else if(Option(argument, "--shapes=", value))
+				settings.shapes = value;
+			else if(argument == "--profile")
+				settings.profile = true;
+			else if(Option(argument, "--profile-json=", value))
+				settings.profileJson = value;
+			else if(Option(argument, "--trace=", value))
+				settings.trace = value;
+			else if(Option(argument, "--trace-steps=", value))
+				settings.traceSteps = std::strtoul(value.c_str(), nullptr, 10);
+			else if(argument == "--counters")
+				settings.counters = true;
+			else if(Option(argument, "--deadline=", value))
+				settings.deadline = 1e-6*std::strtod(value.c_str(), nullptr);
+			else if(Option(argument, "--budget=", value))
+				settings.budget = 1e-6*std::strtod(value.c_str(), nullptr);
+			else if(argument == "--memory")
+				settings.memory = true;
+			else{
+				std::cerr << "Unknown option " << argument << "\n"
+				<< "Options: --bodies=<n> --steps=<n> --warmup=<n> --threads=<n> --reorder=<period> --precision=double"
+				<< " --shapes=mixed|spheres --fraction=<volume fraction> --seed=<n> --profile --profile-json=<file>"
+				<< " --trace=<file> --trace-steps=<n> --counters --deadline=<us> --budget=<us> --memory" << std::endl;
+				return false;
+			}
+		}
+		// Solid holds its state in double; the other scalar types only exist for the geometric primitives.
+		if(settings.precision != "double"){
+			std::cerr << "Precision " << settings.precision << " is not available: solids are integrated in double" << std::endl;
+			return false;
+		}
+		if(settings.shapes != "mixed" && settings.shapes != "spheres"){
+			std::cerr << "Unknown shapes " << settings.shapes << std::endl;
+			return false;
+		}
+		if(settings.bodies == 0 || settings.fraction <= 0 || settings.fraction >= 0.6){
+			std::cerr << "At least one body and a volume fraction in (0, 0.6) are needed" << std::endl;
+			return false;
+		}
+#ifndef GEOMETRICALSOLID_PROFILING
+		if(settings.profile || !settings.profileJson.empty() || !settings.trace.empty() || settings.counters){
+			std::cerr << "Profiling is compiled out: configure with -DGEOMETRICALSOLID_PROFILING=ON" << std::endl;
+			return false;
+		}
+#endif
+		return true;
+	}
+
+	// Half spheres, a quarter of disks and a quarter of plates with random states in a
+	// periodic cube sized for the requested volume fraction.
+	std::vector<Solid> Generate(const Settings& settings, PeriodicBox<double>& domain) {
+		std::mt19937 generator(settings.seed);
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::uniform_real_distribution<double> value(-1, 1);
+		std::vector<Solid> solids;
+		solids.reserve(settings.bodies);
+		double volume = 0;
+		for(std::size_t i = 0 ; i < settings.bodies ; ++i){
+			std::unique_ptr<Shape> shape;
+			std::size_t kind = settings.shapes == "spheres" ? 0 : i % 4;
+			if(kind < 2){
+				Sphere* sphere = new Sphere(0.004 + 0.002*unit(generator), 2500);
+				volume += sphere->Volume();
+				shape.reset(sphere);
+			}
+			else if(kind == 2){
+				Disk* disk = new Disk(0.005, 0.002, 2500);
+				volume += disk->Volume();
+				shape.reset(disk);
+			}
+			else{
+				Rectangle* rectangle = new Rectangle(0.01, 0.006, 0.002, 2500);
+				volume += rectangle->Volume();
+				shape.reset(rectangle);
+			}
+			solids.emplace_back(std::move(shape));
+		}
+		double side = std::cbrt(volume/settings.fraction);
+		domain = PeriodicBox<double>(Point<double>(0, 0, 0), Point<double>(side, side, side));
+		for(auto& solid : solids){
+			Quaternion<double> q(value(generator), value(generator), value(generator), value(generator));
+			q.Normalize();
+			solid.Basis(GeometricalSpaceObjects::Basis<double>(Point<double>(side*unit(generator), side*unit(generator), side*unit(generator)), q));
+			solid.Velocity(Vector<double>(0.1*value(generator), 0.1*value(generator), 0.1*value(generator)));
+			solid.AngularVelocity(Vector<double>(10*value(generator), 10*value(generator), 10*value(generator)));
+		}
+		return solids;
+	}
+
+	// Sizing of the generated solids, before the simulation is built.
+	MemoryReport EstimateMemory(const Settings& settings, const std::vector<Solid>& solids, const SimulationOptions& options) {
+		double boundingRadius = 0;
+		std::size_t shapeBytes = 0;
+		for(const auto& solid : solids){
+			boundingRadius += solid.Shape()->BoundingRadius();
+			shapeBytes += solid.Shape()->MemoryFootprint();
+		}
+		Vector<double> lengths = options.domain.Lengths();
+		double volume = settings.fraction*lengths.ComponantX()*lengths.ComponantY()*lengths.ComponantZ()/solids.size();
+		MemoryEstimateOptions estimate;
+		estimate.neighborsPerSolid = MemoryReport::NeighborsPerSolid(settings.fraction, boundingRadius/solids.size(), volume, options.skin);
+		estimate.shapeBytes = shapeBytes/solids.size();
+		estimate.threads = options.threads;
+		estimate.reorder = options.reorderPeriod > 0;
+		return MemoryReport::Estimate(solids.size(), estimate);
+	}
+
+	double PeakResidentMegabytes() {
+		struct rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+		return usage.ru_maxrss/1024.;	// kilobytes on Linux
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	Settings settings;
+	if(!Parse(argc, argv, settings))
+		return 1;
 
+	SimulationOptions options;
+	std::vector<Solid> solids = Generate(settings, options.domain);
+	options.threads = settings.threads;
+	options.reorderPeriod = settings.reorder;
+	options.deadline = settings.deadline;
+	options.budget = settings.budget;
+	MemoryReport estimate;
+	if(settings.memory)
+		estimate = EstimateMemory(settings, solids, options);
+	Simulation simulation(std::move(solids), std::unique_ptr<ContactForceModel>(new LinearSpringDashpotModel(1e4, 2e3, 0.5, 0.3)), options);
+	if(!settings.trace.empty()){
+		// The first measured steps, after the warm-up.
+		TraceOptions trace;
+		trace.firstStep = settings.warmup;
+		trace.steps = settings.traceSteps;
+		Trace::Start(trace);
+	}
 
+	if(settings.counters && !PerfCounters::Start())
+		std::cerr << "Hardware counters unavailable (" << PerfCounters::Status() << "), timing only" << std::endl;
+	simulation.Run(settings.warmup);
+	Profiler::Reset();
+	PerfCounters::Reset();
+	simulation.Latency().Reset();
+	simulation.Budget().Reset();
+	auto start = std::chrono::steady_clock::now();
+	simulation.Run(settings.steps);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-int main() {
-	
+	std::cout << settings.bodies << " bodies (" << settings.shapes << "), " << settings.steps << " steps after " << settings.warmup
+	<< " warm-up steps, " << settings.threads << " threads, " << settings.precision << ", reorder period " << settings.reorder << "\n";
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << std::left << std::setw(20) << "steps/s" << (seconds > 0 ? settings.steps/seconds : 0) << "\n";
+	std::cout << std::setw(20) << "ns per body-step" << (settings.steps > 0 ? 1e9*seconds/(settings.steps*settings.bodies) : 0) << "\n";
+	std::cout << std::setw(20) << "peak RSS (MiB)" << PeakResidentMegabytes() << "\n";
+	std::cout << std::setw(20) << "active contacts" << simulation.Engine().ActiveContacts() << "\n\n";
+	simulation.Latency().WriteText(std::cout);
+	if(simulation.Budget().Enabled())
+		simulation.Budget().Report().WriteText(std::cout);
+	if(settings.memory){
+		std::cout << "\nestimated\n";
+		estimate.WriteText(std::cout);
+		std::cout << "\nmeasured\n";
+		simulation.Memory().WriteText(std::cout);
+	}
+	std::cout << std::flush;
+	if(settings.profile || !settings.profileJson.empty()){
+		ProfileReport report = Profiler::Report();
+		if(settings.profile){
+			std::cout << "\n";
+			report.WriteText(std::cout);
+		}
+		if(!settings.profileJson.empty()){
+			std::ofstream out(settings.profileJson.c_str());
+			report.WriteJson(out);
+		}
+	}
+	if(!settings.trace.empty())
+		Trace::WriteChromeTrace(settings.trace);
+	if(PerfCounters::Counting()){
+		std::cout << "\n";
+		PerfCounters::Report().WriteText(std::cout, settings.bodies);
+	}
 	return 0;
 }